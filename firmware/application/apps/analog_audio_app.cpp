@@ -83,6 +83,25 @@ NBFMOptionsView::NBFMOptionsView(
 	};
 }
 
+/* WFMOptionsView ********************************************************/
+
+WFMOptionsView::WFMOptionsView(
+	const Rect parent_rect, const Style* const style
+) : View { parent_rect }
+{
+	set_style(style);
+
+	add_children({
+		&label_config,
+		&options_config,
+	});
+
+	options_config.set_selected_index(receiver_model.wfm_configuration());
+	options_config.on_change = [this](size_t n, OptionsField::value_t) {
+		receiver_model.set_wfm_configuration(n);
+	};
+}
+
 /* SPECOptionsView *******************************************************/
 
 SPECOptionsView::SPECOptionsView(
@@ -125,6 +144,7 @@ AnalogAudioView::AnalogAudioView(
 		&options_modulation,
 		&field_volume,
 		&text_ctcss,
+		&text_rds,
 		&record_view,
 		&waterfall
 	});
@@ -240,6 +260,8 @@ void AnalogAudioView::focus() {
 
 void AnalogAudioView::on_tuning_frequency_changed(rf::Frequency f) {
 	receiver_model.set_tuning_frequency(f);
+	rds_parser.reset();
+	text_rds.set("");
 }
 
 void AnalogAudioView::on_baseband_bandwidth_changed(uint32_t bandwidth_hz) {
@@ -310,23 +332,28 @@ void AnalogAudioView::on_show_options_modulation() {
 		widget = std::make_unique<AMOptionsView>(options_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(false);
 		text_ctcss.hidden(true);
+		text_rds.hidden(true);
 		break;
 
 	case ReceiverModel::Mode::NarrowbandFMAudio:
 		widget = std::make_unique<NBFMOptionsView>(nbfm_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(false);
 		text_ctcss.hidden(false);
+		text_rds.hidden(true);
 		break;
 	
 	case ReceiverModel::Mode::WidebandFMAudio:
+		widget = std::make_unique<WFMOptionsView>(nbfm_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(true);
 		text_ctcss.hidden(true);
+		text_rds.hidden(false);
 		break;
 	
 	case ReceiverModel::Mode::SpectrumAnalysis:
 		widget = std::make_unique<SPECOptionsView>(this, nbfm_view_rect, &style_options_group);
 		waterfall.show_audio_spectrum_view(false);
 		text_ctcss.hidden(true);
+		text_rds.hidden(true);
 		break;
 		
 	default:
@@ -401,25 +428,56 @@ void AnalogAudioView::update_modulation(const ReceiverModel::Mode modulation) {
 	if (exit_on_squelch) nav_.pop();
 }*/
 
-void AnalogAudioView::handle_coded_squelch(const uint32_t value) {
-	float diff, min_diff = value;
-	size_t min_idx { 0 };
-	size_t c;
+void AnalogAudioView::handle_coded_squelch(const CodedSquelchMessage& message) {
+	// Fraction of sub-audible energy in the tone, noise alone gives ~2%
+	constexpr uint8_t ctcss_confidence_min = 10;
 	
-	// Find nearest match
-	for (c = 0; c < tone_keys.size(); c++) {
-		diff = abs(((float)value / 100.0) - tone_keys[c].second);
-		if (diff < min_diff) {
-			min_idx = c;
-			min_diff = diff;
+	switch (message.type) {
+		case CodedSquelchMessage::Type::CTCSS:
+			if (message.confidence >= ctcss_confidence_min) {
+				// Frequencies match tone_keys exactly, skip "None"
+				for (size_t c = 1; c < tone_keys.size(); c++) {
+					if ((uint32_t)(tone_keys[c].second * 100 + 0.5f) == message.value) {
+						text_ctcss.set("CTCSS " + tone_keys[c].first);
+						return;
+					}
+				}
+			}
+			text_ctcss.set(dtmf_keys.empty() ? "???" : "DTMF " + dtmf_keys);
+			break;
+		
+		case CodedSquelchMessage::Type::DCS: {
+			const uint32_t code = message.value & 0x1FF;
+			std::string code_str = "DCS ";
+			code_str += '0' + ((code >> 6) & 7);
+			code_str += '0' + ((code >> 3) & 7);
+			code_str += '0' + (code & 7);
+			code_str += (message.value & 0x200) ? 'I' : 'N';
+			text_ctcss.set(code_str);
+			break;
 		}
+		
+		case CodedSquelchMessage::Type::DTMF:
+			// Keep the last few keys
+			dtmf_keys += (char)message.value;
+			if (dtmf_keys.length() > 6)
+				dtmf_keys.erase(0, dtmf_keys.length() - 6);
+			text_ctcss.set("DTMF " + dtmf_keys);
+			break;
+	}
+}
+
+void AnalogAudioView::handle_rds_group(const rds::ReceivedGroup& group) {
+	if( !rds_parser.parse(group) ) {
+		return;
+	}
+
+	// Station name once complete, PI code until then
+	if( rds_parser.PS_complete() ) {
+		text_rds.set(rds_parser.PS_name());
+	} else if( rds_parser.info().PI_valid ) {
+		text_rds.set("PI " + to_string_hex(rds_parser.info().PI_code, 4));
 	}
-	
-	// Arbitrary confidence threshold
-	if (min_diff < 40)
-		text_ctcss.set("CTCSS " + tone_keys[min_idx].first);
-	else
-		text_ctcss.set("???");
 }
 
 } /* namespace ui */
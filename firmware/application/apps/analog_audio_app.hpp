@@ -31,6 +31,7 @@
 #include "ui_font_fixed_8x16.hpp"
 
 #include "tone_key.hpp"
+#include "rds.hpp"
 
 
 namespace ui {
@@ -95,6 +96,25 @@ private:
 	};
 };
 
+class WFMOptionsView : public View {
+public:
+	WFMOptionsView(const Rect parent_rect, const Style* const style);
+
+private:
+	Text label_config {
+		{ 0 * 8, 0 * 16, 5 * 8, 1 * 16 },
+		"AUDIO",
+	};
+	OptionsField options_config {
+		{ 6 * 8, 0 * 16 },
+		6,
+		{
+			{ "Mono  ", 0 },
+			{ "Stereo", 0 },
+		}
+	};
+};
+
 class AnalogAudioView;
 
 class SPECOptionsView : public View {
@@ -211,6 +231,14 @@ private:
 		{ 19 * 8, 1 * 16, 11 * 8, 1 * 16 },
 		""
 	};
+	std::string dtmf_keys { };
+
+	Text text_rds {
+		{ 19 * 8, 1 * 16, 11 * 8, 1 * 16 },
+		""
+	};
+
+	rds::GroupParser rds_parser { };
 
 	std::unique_ptr<Widget> options_widget { };
 
@@ -241,7 +269,8 @@ private:
 	void update_modulation(const ReceiverModel::Mode modulation);
 	
 	//void squelched();
-	void handle_coded_squelch(const uint32_t value);
+	void handle_coded_squelch(const CodedSquelchMessage& message);
+	void handle_rds_group(const rds::ReceivedGroup& group);
 	
 	/*MessageHandlerRegistration message_handler_squelch_signal {
 		Message::ID::RequestSignal,
@@ -255,7 +284,15 @@ private:
 		Message::ID::CodedSquelch,
 		[this](const Message* const p) {
 			const auto message = *reinterpret_cast<const CodedSquelchMessage*>(p);
-			this->handle_coded_squelch(message.value);
+			this->handle_coded_squelch(message);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_rds_group {
+		Message::ID::RDSGroup,
+		[this](const Message* const p) {
+			const auto message = *reinterpret_cast<const RDSGroupMessage*>(p);
+			this->handle_rds_group(message.group);
 		}
 	};
 };
@@ -63,6 +63,10 @@ struct ERTKey {
 	}
 };
 
+inline uint32_t recent_entry_hash(const ERTKey& key) {
+	return recent_entry_hash(std::make_pair(key.id, key.commodity_type));
+}
+
 struct ERTRecentEntry {
 	using Key = ERTKey;
 
@@ -35,6 +35,21 @@ using namespace portapack;
 
 namespace ui {
 
+// Matches a format name at the start of s, ignoring case. Defaults to C16.
+static iq::Format format_from_name(const char* const s) {
+	for(const auto format : { iq::Format::C8, iq::Format::BlockFloat }) {
+		const auto name = iq::name(format);
+		size_t i = 0;
+		while( name[i] && (toupper(s[i]) == name[i]) ) {
+			i++;
+		}
+		if( !name[i] && !isalnum(s[i]) ) {
+			return format;
+		}
+	}
+	return iq::Format::C16;
+}
+
 void ReplayAppView::set_ready() {
 	ready_signal = true;
 }
@@ -58,6 +73,10 @@ void ReplayAppView::on_file_changed(std::filesystem::path new_file_path) {
 	
 	sample_rate = 500000;
 	
+	// Older captures have no format line, the extension tells C8 from C16
+	const auto extension = file_path.extension().string();
+	format = format_from_name(extension.empty() ? "" : &extension[1]);
+	
 	auto info_open_error = info_file.open("/" + info_file_path.string());
 	if (!info_open_error.is_valid()) {
 		memset(file_data, 0, 257);
@@ -74,13 +93,19 @@ void ReplayAppView::on_file_changed(std::filesystem::path new_file_path) {
 				pos2 += 12;
 				sample_rate = strtoll(pos2, nullptr, 10);
 			}
+			
+			auto pos3 = strstr(file_data, "format=");
+			if (pos3) {
+				pos3 += 7;
+				format = format_from_name(pos3);
+			}
 		}
 	}
 	
 	text_sample_rate.set(unit_auto_scale(sample_rate, 3, 0) + "Hz");
 	
 	auto file_size = data_file.size();
-	auto duration = (file_size * 1000) / (2 * 2 * sample_rate);
+	auto duration = (file_size * 1000) / iq::encoded_size(format, sample_rate);
 	
 	progressbar.set_max(file_size);
 	text_filename.set(file_path.filename().string().substr(0, 12));
@@ -91,6 +116,19 @@ void ReplayAppView::on_file_changed(std::filesystem::path new_file_path) {
 
 void ReplayAppView::on_tx_progress(const uint32_t progress) {
 	progressbar.set_value(progress);
+
+	if( is_active() ) {
+		const auto missed_percent = std::min<size_t>(99, replay_thread->state().missed_percent());
+		text_underrun.set(missed_percent ? (to_string_dec_uint(missed_percent, 2, ' ') + "\%") : "");
+	}
+}
+
+/* The baseband interpolates up from the file rate, 8x oversampled where
+ * the M4 can keep up, and never below the file rate itself.
+ */
+uint32_t ReplayAppView::baseband_rate() const {
+	const auto oversampled = std::min<uint64_t>(static_cast<uint64_t>(sample_rate) * 8, baseband_rate_max);
+	return std::max<uint32_t>(std::max<uint32_t>(oversampled, sample_rate), baseband_rate_min);
 }
 
 void ReplayAppView::focus() {
@@ -129,7 +167,8 @@ void ReplayAppView::start() {
 
 	if( reader ) {
 		button_play.set_bitmap(&bitmap_stop);
-		baseband::set_sample_rate(sample_rate * 8);
+		baseband::set_sample_rate(baseband_rate());
+		text_underrun.set("");
 		
 		replay_thread = std::make_unique<ReplayThread>(
 			std::move(reader),
@@ -138,7 +177,9 @@ void ReplayAppView::start() {
 			[](uint32_t return_code) {
 				ReplayThreadDoneMessage message { return_code };
 				EventDispatcher::send_message(message);
-			}
+			},
+			format,
+			sample_rate
 		);
 	}
     field_rfgain.on_change = [this](int32_t v) {
@@ -158,7 +199,7 @@ void ReplayAppView::start() {
 		
 	radio::enable({
 		receiver_model.tuning_frequency(),
-		sample_rate * 8,
+		baseband_rate(),
 		baseband_bandwidth,
 		rf::Direction::Transmit,
         rf_amp,         //  previous code line : "receiver_model.rf_amp()," was passing the same rf_amp of all Receiver Apps  
@@ -210,6 +251,7 @@ ReplayAppView::ReplayAppView(
 		&text_sample_rate,
 		&text_duration,
 		&progressbar,
+		&text_underrun,
 		&field_frequency,
 		&field_rfgain, 
 		&field_rfamp,       // let's not use common rf_amp
@@ -239,7 +281,7 @@ ReplayAppView::ReplayAppView(
 	};
 	
 	button_open.on_select = [this, &nav](Button&) {
-		auto open_view = nav.push<FileLoadView>(".C16");
+		auto open_view = nav.push<FileLoadView>(".C16|.C8|.CBF");
 		open_view->on_changed = [this](std::filesystem::path new_file_path) {
 			on_file_changed(new_file_path);
 		};
@@ -51,9 +51,13 @@ private:
 	static constexpr ui::Dim header_height = 3 * 16;
 	
 	uint32_t sample_rate = 0;
+	iq::Format format { iq::Format::C16 };
 	int32_t tx_gain { 47 };
 	bool rf_amp { true }; // aux private var to store temporal, Replay App rf_amp user selection.
 	static constexpr uint32_t baseband_bandwidth = 2500000;
+	// Baseband rates the interpolator is run at, see baseband_rate().
+	static constexpr uint32_t baseband_rate_min = 2000000;
+	static constexpr uint32_t baseband_rate_max = 4000000;
 	const size_t read_size { 16384 };
 	const size_t buffer_count { 3 };
 
@@ -69,6 +73,7 @@ private:
 	void stop(const bool do_loop);
 	bool is_active() const;
 	void set_ready();
+	uint32_t baseband_rate() const;
 	void handle_replay_thread_done(const uint32_t return_code);
 	void file_error();
 
@@ -99,7 +104,11 @@ private:
 		"-"
 	};
 	ProgressBar progressbar {
-		{ 18 * 8, 1 * 16, 12 * 8, 16 }
+		{ 18 * 8, 1 * 16, 8 * 8, 16 }
+	};
+	Text text_underrun {
+		{ 27 * 8, 1 * 16, 3 * 8, 16 },
+		""
 	};
 	
 	FrequencyField field_frequency {
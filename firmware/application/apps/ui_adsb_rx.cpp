@@ -316,28 +316,18 @@ ADSBRxView::~ADSBRxView() {
 	baseband::shutdown();
 }
 
-AircraftRecentEntry ADSBRxView::find_or_create_entry(uint32_t ICAO_address) {
-	auto it = find(recent, ICAO_address);
+AircraftRecentEntry& ADSBRxView::find_or_create_entry(uint32_t ICAO_address) {
+	auto it = recent.find(ICAO_address);
 
 	// If not found
 	if (it == std::end(recent)){
-		recent.emplace_front(ICAO_address); // Add it
-		truncate_entries(recent); // Truncate the list
+		recent.emplace_front(ICAO_address); // Add it, evicting the oldest entry if full
 		sort_entries_by_state();
-		it = find(recent, ICAO_address); // Find it again
+		it = recent.find(ICAO_address); // Find it again
 	}
 	return *it;
 }
 
-void ADSBRxView::replace_entry(AircraftRecentEntry & entry)
-{
-	uint32_t ICAO_address = entry.ICAO_address;
-
-	std::replace_if( recent.begin(), recent.end(), 
-		[ICAO_address](const AircraftRecentEntry & compEntry) {return ICAO_address == compEntry.ICAO_address;},
-		entry);
-}
-
 void ADSBRxView::sort_entries_by_state()
 {
 	// Sorting List pn age_state using lambda function as comparator
@@ -356,7 +346,7 @@ void ADSBRxView::on_frame(const ADSBFrameMessage * message) {
 
 	if (frame.check_CRC() && ICAO_address) {
 		rtcGetTime(&RTCD1, &datetime);
-		auto entry = find_or_create_entry(ICAO_address);
+		auto& entry = find_or_create_entry(ICAO_address);
 		frame.set_rx_timestamp(datetime.minute() * 60 + datetime.second());
 		entry.reset_age();
 		if (entry.hits==0)
@@ -417,15 +407,11 @@ void ADSBRxView::on_frame(const ADSBFrameMessage * message) {
 			}
 		}
 
-		replace_entry(entry);
-		
-		logger = std::make_unique<ADSBLogger>();
-        if (logger) {
-                logger->append(u"adsb.txt");
-                // will log each frame in format:
-                // 20171103100227 8DADBEEFDEADBEEFDEADBEEFDEADBEEF ICAO:nnnnnn callsign Alt:nnnnnn Latnnn.nn Lonnnn.nn
-				logger->log_str(logentry);
-        }
+		if (logger) {
+			// will log each frame in format:
+			// 20171103100227 8DADBEEFDEADBEEFDEADBEEFDEADBEEF ICAO:nnnnnn callsign Alt:nnnnnn Latnnn.nn Lonnnn.nn
+			logger->log_str(logentry);
+		}
 	}
 }
 
@@ -475,6 +461,10 @@ ADSBRxView::ADSBRxView(NavigationView& nav) {
 	
 	prevFreq = receiver_model.tuning_frequency();
 
+	logger = std::make_unique<ADSBLogger>();
+	if (logger)
+		logger->append(u"adsb.txt");
+
 	baseband::set_adsb();
 	
 	receiver_model.set_tuning_frequency(1090000000);
@@ -66,6 +66,7 @@ namespace ui {
 #define VEL_AIR_SUPERSONIC		4
 
 #define O_E_FRAME_TIMEOUT		20	// timeout between odd and even frames
+#define POS_LOCAL_TIMEOUT		60	// max age of a position used as local decoding reference
 
 struct AircraftRecentEntry {
 	using Key = uint32_t;
@@ -78,7 +79,8 @@ struct AircraftRecentEntry {
 	uint16_t age_state { 1 };
 	uint32_t age { 0 };
 	uint32_t amp { 0 };
-	adsb_pos pos { false, 0, 0, 0 };
+	adsb_pos pos { false, 0, 0, 0, 0, 0 };
+	uint32_t pos_timestamp { 0 };
 	adsb_vel velo { false, 0, 999, 0 };
 	ADSBFrame frame_pos_even { };
 	ADSBFrame frame_pos_odd { };
@@ -111,9 +113,21 @@ struct AircraftRecentEntry {
 		else
 			frame_pos_odd = frame;
 		
+		// A recent position is a good enough reference to decode each frame on its own
+		if (pos.valid && (abs(frame.get_rx_timestamp() - pos_timestamp) < POS_LOCAL_TIMEOUT)) {
+			const auto local_pos = decode_frame_pos_local(frame, pos);
+			if (local_pos.valid) {
+				pos = local_pos;
+				pos_timestamp = frame.get_rx_timestamp();
+				return;
+			}
+		}
+		
 		if (!frame_pos_even.empty() && !frame_pos_odd.empty()) {
-			if (abs(frame_pos_even.get_rx_timestamp() - frame_pos_odd.get_rx_timestamp()) < O_E_FRAME_TIMEOUT)
+			if (abs(frame_pos_even.get_rx_timestamp() - frame_pos_odd.get_rx_timestamp()) < O_E_FRAME_TIMEOUT) {
 				pos = decode_frame_pos(frame_pos_even, frame_pos_odd);
+				pos_timestamp = frame.get_rx_timestamp();
+			}
 		}
 	}
 
@@ -363,8 +377,7 @@ public:
 	
 	std::string title() const override { return "ADS-B receive"; };
 
-	void replace_entry(AircraftRecentEntry & entry);
-	AircraftRecentEntry find_or_create_entry(uint32_t ICAO_address);
+	AircraftRecentEntry& find_or_create_entry(uint32_t ICAO_address);
 	void sort_entries_by_state();
 
 private:
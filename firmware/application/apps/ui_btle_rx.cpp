@@ -22,29 +22,40 @@
  */
 
 #include "ui_btle_rx.hpp"
-#include "ui_modemsetup.hpp"
 
-#include "modems.hpp"
-#include "audio.hpp"
-#include "rtc_time.hpp"
 #include "baseband_api.hpp"
 #include "string_format.hpp"
-#include "portapack_persistent_memory.hpp"
 
 using namespace portapack;
-using namespace modems;
 
 namespace ui {
 
+static std::string pdu_type_string(const btle::PDUType type) {
+	switch(type) {
+	case btle::PDUType::ADV_IND:			return "ADV_IND ";
+	case btle::PDUType::ADV_DIRECT_IND:		return "ADV_DIR ";
+	case btle::PDUType::ADV_NONCONN_IND:	return "NONCONN ";
+	case btle::PDUType::SCAN_REQ:			return "SCAN_REQ";
+	case btle::PDUType::SCAN_RSP:			return "SCAN_RSP";
+	case btle::PDUType::CONNECT_REQ:		return "CONN_REQ";
+	case btle::PDUType::ADV_SCAN_IND:		return "ADV_SCAN";
+	default:								return "?       ";
+	}
+}
+
 void BTLERxView::focus() {
-	field_frequency.focus();
+	options_channel.focus();
 }
 
-void BTLERxView::update_freq(rf::Frequency f) {
-	receiver_model.set_tuning_frequency(f);
+void BTLERxView::set_channel(const uint8_t new_channel_number) {
+	channel_number = new_channel_number;
+	const auto frequency = btle::advertising_channel_frequency(channel_number);
+	receiver_model.set_tuning_frequency(frequency);
+	baseband::set_btle(channel_number);
+	text_frequency.set("CH" + to_string_dec_uint(channel_number) + " " + to_string_short_freq(frequency));
 }
 
-BTLERxView::BTLERxView(NavigationView& nav) {
+BTLERxView::BTLERxView(NavigationView&) {
 	baseband::run_image(portapack::spi_flash::image_tag_btle_rx);
 	
 	add_children({
@@ -53,106 +64,55 @@ BTLERxView::BTLERxView(NavigationView& nav) {
 		&field_rf_amp,
 		&field_lna,
 		&field_vga,
-		&field_frequency,
-		&text_debug,
-		&button_modem_setup,
-		&record_view,
+		&text_channel,
+		&options_channel,
+		&text_frequency,
+		&text_packets,
 		&console
 	});
-	
-	// DEBUG
-	record_view.on_error = [&nav](std::string message) {
-		nav.display_modal("Error", message);
-	};
-	record_view.set_sampling_rate(24000);
-	
-	// Auto-configure modem for LCR RX (will be removed later)
-	update_freq(2426000000);
-	auto def_bell202 = &modem_defs[0];
-	persistent_memory::set_modem_baudrate(def_bell202->baudrate);
-	serial_format_t serial_format;
-	serial_format.data_bits = 7;
-	serial_format.parity = EVEN;
-	serial_format.stop_bits = 1;
-	serial_format.bit_order = LSB_FIRST;
-	persistent_memory::set_serial_format(serial_format);
-	
-	field_frequency.set_value(receiver_model.tuning_frequency());
-	field_frequency.set_step(100);
-	field_frequency.on_change = [this](rf::Frequency f) {
-		update_freq(f);
-	};
-	field_frequency.on_edit = [this, &nav]() {
-		auto new_view = nav.push<FrequencyKeypadView>(receiver_model.tuning_frequency());
-		new_view->on_changed = [this](rf::Frequency f) {
-			update_freq(f);
-			field_frequency.set_value(f);
-		};
-	};
 
-	button_modem_setup.on_select = [&nav](Button&) {
-		nav.push<ModemSetupView>();
+	options_channel.on_change = [this](size_t, OptionsField::value_t v) {
+		hopping = (v == channel_hop);
+		frame_count = 0;
+		set_channel(hopping ? 37 : v);
 	};
-	
-	
-	// Auto-configure modem for LCR RX (will be removed later)
-	baseband::set_btle(persistent_memory::modem_baudrate(), 8, 0, false);
-	
-	audio::set_rate(audio::Rate::Hz_24000);
-	audio::output::start();
-	
+	options_channel.set_selected_index(0);
+	set_channel(37);
+
 	receiver_model.set_sampling_rate(4000000);
 	receiver_model.set_baseband_bandwidth(4000000);
 	receiver_model.set_modulation(ReceiverModel::Mode::WidebandFMAudio);
 	receiver_model.enable();
 }
 
-void BTLERxView::on_data(uint32_t value, bool is_data) {
-	//std::string str_console = "\x1B";
-	std::string str_console = "";
-	if (is_data) {
-		// Colorize differently after message splits
-		//str_console += (char)((console_color & 3) + 9);
-		
-		//value &= 0xFF;											// ABCDEFGH
-		//value = ((value & 0xF0) >> 4) | ((value & 0x0F) << 4);	// EFGHABCD
-		//value = ((value & 0xCC) >> 2) | ((value & 0x33) << 2);	// GHEFCDAB
-		//value = ((value & 0xAA) >> 1) | ((value & 0x55) << 1);	// HGFEDCBA
-		//value &= 0x7F;											// Ignore parity, which is the MSB now
-		
-		//if ((value >= 32) && (value < 127)) {
-		//	str_console += (char)value;							// Printable
-		//} 
-		
-		//str_console += (char)'A';
-		//str_console += (char)value;
-		//str_console += "[" + to_string_hex(value, 2) + "]";	
-		str_console += ":" + to_string_hex(value, 2) ;	
-		console.write(str_console);
-		
-		
-		
-		/*if ((value != 0x7F) && (prev_value == 0x7F)) {
-			// Message split
-			console.writeln("");
-			console_color++;
-			
-			
-		}*/
-		//prev_value = value;
-	} else {
-		// Baudrate estimation
-		//text_debug.set("~" + to_string_dec_uint(value)); 
-		if (value == 'A')
-		{console.write("mac");}
-		else if (value == 'B')
-		{console.writeln("");}
-		//console.writeln("");
+void BTLERxView::on_frame_sync() {
+	if( !hopping ) {
+		return;
+	}
+
+	if( ++frame_count >= hop_dwell_frames ) {
+		frame_count = 0;
+		set_channel((channel_number >= 39) ? 37 : (channel_number + 1));
+	}
+}
+
+void BTLERxView::on_packet(const btle::Packet& packet) {
+	packet_count++;
+	text_packets.set("Packets:" + to_string_dec_uint(packet_count, 6));
+
+	// Address is sent little endian, show it the usual way round.
+	std::string str_console = to_string_dec_uint(packet.channel_number) + " " + pdu_type_string(packet.type()) + " ";
+	const auto address = packet.advertiser_address();
+	for(int i=5; i>=0; i--) {
+		str_console += to_string_hex((address >> (i * 8)) & 0xFF, 2);
+		if( i ) {
+			str_console += ":";
+		}
 	}
+	console.writeln(str_console);
 }
 
 BTLERxView::~BTLERxView() {
-	audio::output::stop();
 	receiver_model.disable();
 	baseband::shutdown();
 }
@@ -27,8 +27,8 @@
 #include "ui.hpp"
 #include "ui_navigation.hpp"
 #include "ui_receiver.hpp"
-#include "ui_record_view.hpp"	// DEBUG
 
+#include "btle_packet.hpp"
 #include "utility.hpp"
 
 namespace ui {
@@ -43,11 +43,18 @@ public:
 	std::string title() const override { return "BTLE RX"; };
 	
 private:
-	void on_data(uint32_t value, bool is_data);
-	
-	uint8_t console_color { 0 };
-	uint32_t prev_value { 0 };
-	std::string str_log { "" };
+	// Display frames (60Hz) spent on each advertising channel when hopping.
+	static constexpr uint32_t hop_dwell_frames = 30;
+	static constexpr int32_t channel_hop = 0;
+
+	void on_packet(const btle::Packet& packet);
+	void on_frame_sync();
+	void set_channel(const uint8_t channel_number);
+
+	uint8_t channel_number { 37 };
+	bool hopping { false };
+	uint32_t frame_count { 0 };
+	uint32_t packet_count { 0 };
 
 	RFAmpField field_rf_amp {
 		{ 13 * 8, 0 * 16 }
@@ -65,39 +72,46 @@ private:
 		{ 21 * 8, 5, 6 * 8, 4 },
 	};
 	
-	FrequencyField field_frequency {
-		{ 0 * 8, 0 * 16 },
+	Text text_channel {
+		{ 0 * 8, 0 * 16, 8 * 8, 16 },
+		"Channel"
 	};
-	
-	Text text_debug {
-		{ 0 * 8, 1 * 16, 10 * 8, 16 },
-		"DEBUG"
+	OptionsField options_channel {
+		{ 8 * 8, 0 * 16 },
+		3,
+		{
+			{ "37 ", 37 },
+			{ "38 ", 38 },
+			{ "39 ", 39 },
+			{ "Hop", channel_hop }
+		}
 	};
 	
-	
-	Button button_modem_setup {
-		{ 12 * 8, 1 * 16, 96, 24 },
-		"Modem setup"
+	Text text_frequency {
+		{ 0 * 8, 1 * 16, 14 * 8, 16 },
+		""
 	};
-	
-	// DEBUG
-	RecordView record_view {
-		{ 0 * 8, 3 * 16, 30 * 8, 1 * 16 },
-		u"AFS_????", RecordView::FileType::WAV, 4096, 4
+	Text text_packets {
+		{ 16 * 8, 1 * 16, 14 * 8, 16 },
+		""
 	};
 	
 	Console console {
-		{ 0, 4 * 16, 240, 240 }
+		{ 0, 3 * 16, 240, 256 }
 	};
 
-	void update_freq(rf::Frequency f);
-	//void on_data_afsk(const AFSKDataMessage& message);
-	
 	MessageHandlerRegistration message_handler_packet {
-		Message::ID::AFSKData,
+		Message::ID::BTLEPacket,
 		[this](Message* const p) {
-			const auto message = static_cast<const AFSKDataMessage*>(p);
-			this->on_data(message->value, message->is_data);
+			const auto message = static_cast<const BTLEPacketMessage*>(p);
+			this->on_packet(message->packet);
+		}
+	};
+
+	MessageHandlerRegistration message_handler_frame_sync {
+		Message::ID::DisplayFrameSync,
+		[this](const Message* const) {
+			this->on_frame_sync();
 		}
 	};
 };
@@ -27,6 +27,7 @@
 #include "string_format.hpp"
 
 #include "audio.hpp"
+#include "baseband_api.hpp"
 
 #include "ui_sd_card_debug.hpp"
 
@@ -48,9 +49,18 @@ DebugMemoryView::DebugMemoryView(NavigationView& nav) {
 		&text_label_m0_heap_fragmented_free_value,
 		&text_label_m0_heap_fragments,
 		&text_label_m0_heap_fragments_value,
+		&text_label_m0_heap_used,
+		&text_label_m0_heap_used_value,
+		&text_label_m0_largest_free,
+		&text_label_m0_largest_free_value,
+		&text_label_m0_pools,
 		&button_done
 	});
 
+	for(auto& text : text_m0_pools) {
+		add_child(&text);
+	}
+
 	const auto m0_core_free = chCoreStatus();
 	text_label_m0_core_free_value.set(to_string_dec_uint(m0_core_free, 5));
 
@@ -59,6 +69,23 @@ DebugMemoryView::DebugMemoryView(NavigationView& nav) {
 	text_label_m0_heap_fragmented_free_value.set(to_string_dec_uint(m0_fragmented_free_space, 5));
 	text_label_m0_heap_fragments_value.set(to_string_dec_uint(m0_fragments, 5));
 
+	const auto m0_heap = chibios::heap_statistics();
+	text_label_m0_heap_used_value.set(
+		to_string_dec_uint(m0_heap.used, 5) + " (" + to_string_dec_uint(m0_heap.used_max, 5) + ")"
+	);
+	text_label_m0_largest_free_value.set(to_string_dec_uint(m0_heap.largest_free, 5));
+
+	for(size_t i=0; i<text_m0_pools.size(); i++) {
+		const auto pool = chibios::pool_statistics(i);
+		text_m0_pools[i].set(
+			to_string_dec_uint(pool.block_size, 3) + "B " +
+			to_string_dec_uint(pool.used, 5) + " " +
+			to_string_dec_uint(pool.used_max, 5) + "  " +
+			to_string_dec_uint(pool.blocks, 5) + " " +
+			to_string_dec_uint(pool.overflows, 5)
+		);
+	}
+
 	button_done.on_select = [&nav](Button&){ nav.pop(); };
 }
 
@@ -154,6 +181,57 @@ void TemperatureView::focus() {
 	button_done.focus();
 }
 
+/* DebugProfileView ******************************************************/
+
+DebugProfileView::DebugProfileView(NavigationView& nav) {
+	add_children({
+		&text_title,
+		&text_image,
+		&options_image,
+		&view_profile,
+		&button_done,
+	});
+
+	view_profile.set_parent_rect({ 0, 64, 240, 184 });
+
+	options_image.on_change = [this](size_t, OptionsField::value_t v) {
+		this->run_image(static_cast<ReceiverModel::Mode>(v));
+	};
+	options_image.set_selected_index(2);
+
+	button_done.on_select = [&nav](Button&){ nav.pop(); };
+}
+
+DebugProfileView::~DebugProfileView() {
+	receiver_model.disable();
+	baseband::shutdown();
+}
+
+void DebugProfileView::focus() {
+	options_image.focus();
+}
+
+void DebugProfileView::run_image(const ReceiverModel::Mode mode) {
+	receiver_model.disable();
+	baseband::shutdown();
+
+	portapack::spi_flash::image_tag_t image_tag;
+	switch(mode) {
+	case ReceiverModel::Mode::AMAudio:				image_tag = portapack::spi_flash::image_tag_am_audio;	break;
+	case ReceiverModel::Mode::NarrowbandFMAudio:	image_tag = portapack::spi_flash::image_tag_nfm_audio;	break;
+	case ReceiverModel::Mode::WidebandFMAudio:		image_tag = portapack::spi_flash::image_tag_wfm_audio;	break;
+	default:
+		return;
+	}
+
+	baseband::run_image(image_tag);
+
+	receiver_model.set_modulation(mode);
+	receiver_model.set_sampling_rate(3072000);
+	receiver_model.set_baseband_bandwidth(1750000);
+	receiver_model.enable();
+}
+
 /* RegistersWidget *******************************************************/
 
 RegistersWidget::RegistersWidget(
@@ -353,6 +431,7 @@ DebugMenuView::DebugMenuView(NavigationView& nav) {
 		{ "Peripherals",	ui::Color::dark_cyan(),	&bitmap_icon_peripherals,	[&nav](){ nav.push<DebugPeripheralsMenuView>(); } },
 		{ "Temperature",	ui::Color::dark_cyan(),	&bitmap_icon_temperature,	[&nav](){ nav.push<TemperatureView>(); } },
 		{ "Buttons test",	ui::Color::dark_cyan(),	&bitmap_icon_controls,	[&nav](){ nav.push<DebugControlsView>(); } },
+		{ "Profile",		ui::Color::dark_cyan(),	&bitmap_icon_debug,	[&nav](){ nav.push<DebugProfileView>(); } },
 	});
 	set_max_rows(2); // allow wider buttons
 }
@@ -27,13 +27,17 @@
 #include "ui_painter.hpp"
 #include "ui_menu.hpp"
 #include "ui_navigation.hpp"
+#include "ui_baseband_stats_view.hpp"
+#include "receiver_model.hpp"
 
 #include "rffc507x.hpp"
 #include "max2837.hpp"
 #include "portapack.hpp"
+#include "chibios_cpp.hpp"
 
 #include <functional>
 #include <utility>
+#include <array>
 
 namespace ui {
 
@@ -45,39 +49,68 @@ public:
 
 private:
 	Text text_title {
-		{ 96, 96, 48, 16 },
+		{ 96, 64, 48, 16 },
 		"Memory",
 	};
 
 	Text text_label_m0_core_free {
-		{ 0, 128, 144, 16 },
+		{ 0, 96, 144, 16 },
 		"M0 Core Free Bytes",
 	};
 
 	Text text_label_m0_core_free_value {
-		{ 200, 128, 40, 16 },
+		{ 200, 96, 40, 16 },
 	};
 
 	Text text_label_m0_heap_fragmented_free {
-		{ 0, 144, 184, 16 },
+		{ 0, 112, 184, 16 },
 		"M0 Heap Fragmented Free",
 	};
 
 	Text text_label_m0_heap_fragmented_free_value {
-		{ 200, 144, 40, 16 },
+		{ 200, 112, 40, 16 },
 	};
 
 	Text text_label_m0_heap_fragments {
-		{ 0, 160, 136, 16 },
+		{ 0, 128, 136, 16 },
 		"M0 Heap Fragments",
 	};
 
 	Text text_label_m0_heap_fragments_value {
+		{ 200, 128, 40, 16 },
+	};
+
+	Text text_label_m0_heap_used {
+		{ 0, 144, 136, 16 },
+		"M0 Heap Used(Max)",
+	};
+
+	Text text_label_m0_heap_used_value {
+		{ 136, 144, 13 * 8, 16 },
+	};
+
+	Text text_label_m0_largest_free {
+		{ 0, 160, 184, 16 },
+		"M0 Largest Free Block",
+	};
+
+	Text text_label_m0_largest_free_value {
 		{ 200, 160, 40, 16 },
 	};
 
+	Text text_label_m0_pools {
+		{ 0, 184, 240, 16 },
+		"Pool  Used   Max Blocks Ovfl",
+	};
+
+	std::array<Text, chibios::pool_class_count> text_m0_pools { {
+		{ { 0, 200, 240, 16 } },
+		{ { 0, 216, 240, 16 } },
+		{ { 0, 232, 240, 16 } },
+	} };
+
 	Button button_done {
-		{ 72, 192, 96, 24 },
+		{ 72, 256, 96, 24 },
 		"Done"
 	};
 };
@@ -129,6 +162,47 @@ private:
 	};
 };
 
+/* Runs a receiver image so the per-stage baseband profile can be read, or
+ * logged, without the app's own views in the way.
+ */
+class DebugProfileView : public View {
+public:
+	explicit DebugProfileView(NavigationView& nav);
+	~DebugProfileView();
+
+	void focus() override;
+
+private:
+	Text text_title {
+		{ 88, 16, 240, 16 },
+		"Profile",
+	};
+
+	Text text_image {
+		{ 0, 40, 6 * 8, 16 },
+		"Image:",
+	};
+
+	OptionsField options_image {
+		{ 7 * 8, 40 },
+		3,
+		{
+			{ "AM", toUType(ReceiverModel::Mode::AMAudio) },
+			{ "NFM", toUType(ReceiverModel::Mode::NarrowbandFMAudio) },
+			{ "WFM", toUType(ReceiverModel::Mode::WidebandFMAudio) },
+		}
+	};
+
+	ProcessorProfileView view_profile { };
+
+	Button button_done {
+		{ 72, 264, 96, 24 },
+		"Done"
+	};
+
+	void run_image(const ReceiverModel::Mode mode);
+};
+
 struct RegistersWidgetConfig {
 	size_t registers_count;
 	size_t register_bits;
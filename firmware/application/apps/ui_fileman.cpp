@@ -33,43 +33,25 @@ void FileManBaseView::load_directory_contents(const std::filesystem::path& dir_p
 	current_path = dir_path;
 	
 	text_current.set(dir_path.string().length()? dir_path.string().substr(0, 30 - 6):"(sd root)");
-
-	entry_list.clear();
-	
-	auto filtering = (bool)extension_filter.size();
 	
-	// List directories and files, put directories up top
-	if (dir_path.string().length())
-		entry_list.push_back({ u"..", 0, true });
+	// Directories up top, sorted by name unless there are too many entries
+	directory.open(dir_path, extension_filter, DirectoryModel::Order::Name);
+	entry_page.clear();
+	page_start = 0;
+}
 
-	for (const auto& entry : std::filesystem::directory_iterator(dir_path, u"*")) {
+size_t FileManBaseView::list_size() {
+	// Plus ".." when not at root
+	return directory.size() + (current_path.string().length() ? 1 : 0);
+}
 
-		// do not display dir / files starting with '.' (hidden / tmp)
-		if (entry.path().string().length() && entry.path().filename().string()[0] != '.') {
-			if (std::filesystem::is_regular_file(entry.status())) {
-				bool matched = true;
-				if (filtering) {
-					auto entry_extension = entry.path().extension().string();
-				
-					for (auto &c: entry_extension)
-						c = toupper(c);
-					
-					if (entry_extension != extension_filter)
-						matched = false;
-				}
-				
-				if (matched)
-					entry_list.push_back({ entry.path(), (uint32_t)entry.size(), false });
-			} else if (std::filesystem::is_directory(entry.status())) {
-				entry_list.insert(entry_list.begin(), { entry.path(), 0, true });
-			}
-		}
-	}
+const DirectoryModel::Entry& FileManBaseView::selected_entry() {
+	return entry_page[menu_view.highlighted_index()];
 }
 
 std::filesystem::path FileManBaseView::get_selected_path() {
 	auto selected_path_str = current_path.string();
-	auto entry_path = entry_list[menu_view.highlighted_index()].entry_path.string();
+	auto entry_path = selected_entry().name.string();
 	
 	if (entry_path == "..") {
 		selected_path_str = get_parent_dir().string();
@@ -109,7 +91,7 @@ FileManBaseView::FileManBaseView(
 		text_current.set("NO SD CARD!");
 	} else {
 		load_directory_contents(current_path);
-		if (!entry_list.size())
+		if (!list_size())
 		{
 			empty_root = true;
 			text_current.set("EMPTY SD CARD!");
@@ -118,6 +100,10 @@ FileManBaseView::FileManBaseView(
 				load_directory_contents(get_parent_dir());
 				refresh_list();
 			};
+			
+			menu_view.on_highlight = [this]() {
+				on_highlight();
+			};
 		}
 	}
 }
@@ -130,17 +116,25 @@ void FileManBaseView::focus() {
 	}
 }
 
-void FileManBaseView::refresh_list() {
-	if (on_refresh_widgets)
-		on_refresh_widgets(false);
-
+void FileManBaseView::load_page(const size_t start) {
+	const size_t parent_entries = current_path.string().length() ? 1 : 0;
+	size_t count = page_entries;
+	
+	page_start = start;
+	entry_page.clear();
+	
+	if (parent_entries && !start) {
+		entry_page.push_back({ u"..", 0, true });
+		count--;
+	}
+	directory.read(start - std::min(start, parent_entries), count, entry_page);
+	
 	menu_view.clear();
 	
-	for (size_t n = 0; n < entry_list.size(); n++) {
-		auto entry = &entry_list[n];
-		auto entry_name = entry->entry_path.filename().string().substr(0, 20);
+	for (const auto& entry : entry_page) {
+		auto entry_name = entry.name.string().substr(0, 20);
 		
-		if (entry->is_directory) {
+		if (entry.is_directory) {
 			
 			menu_view.add_item({
 				entry_name,
@@ -154,7 +148,7 @@ void FileManBaseView::refresh_list() {
 			
 		} else {
 			
-			auto file_size = entry->size;
+			auto file_size = entry.size;
 			size_t suffix_index = 0;
 			
 			while (file_size >= 1024) {
@@ -166,7 +160,7 @@ void FileManBaseView::refresh_list() {
 			
 			std::string size_str = to_string_dec_uint(file_size) + suffix[suffix_index];
 			
-			auto entry_extension = entry->entry_path.extension().string();
+			auto entry_extension = entry.name.extension().string();
 			for (auto &c: entry_extension)
 				c = toupper(c);
 			
@@ -189,6 +183,32 @@ void FileManBaseView::refresh_list() {
 			
 		}
 	}
+}
+
+void FileManBaseView::on_highlight() {
+	const size_t highlighted = menu_view.highlighted_index();
+	
+	// Re-center the page on the highlight when it gets close to either end
+	const bool more_after = (page_start + entry_page.size()) < list_size();
+	if (((highlighted + page_margin >= entry_page.size()) && more_after) ||
+		((highlighted < page_margin) && page_start)) {
+		
+		const size_t position = page_start + highlighted;
+		const size_t old_start = page_start;
+		
+		load_page(position - std::min(position, page_entries / 2));
+		menu_view.shift_items((int32_t)page_start - (int32_t)old_start);
+	}
+	
+	if (on_highlight_entry)
+		on_highlight_entry();
+}
+
+void FileManBaseView::refresh_list() {
+	if (on_refresh_widgets)
+		on_refresh_widgets(false);
+	
+	load_page(0);
 	
 	menu_view.set_highlighted(0);	// Refresh
 }
@@ -239,13 +259,13 @@ FileLoadView::FileLoadView(
 	refresh_list();
 	
 	on_select_entry = [&nav, this]() {
-		if (entry_list[menu_view.highlighted_index()].is_directory) {
+		if (selected_entry().is_directory) {
 			load_directory_contents(get_selected_path());
 			refresh_list();
 		} else {
 			nav_.pop();
 			if (on_changed)
-				on_changed(current_path.string() + '/' + entry_list[menu_view.highlighted_index()].entry_path.string());
+				on_changed(current_path.string() + '/' + selected_entry().name.string());
 		}
 	};
 }
@@ -297,14 +317,14 @@ FileManagerView::FileManagerView(
 			&button_delete
 		});
 		
-		menu_view.on_highlight = [this]() {
+		on_highlight_entry = [this]() {
 			text_date.set(to_string_FAT_timestamp(file_created_date(get_selected_path())));
 		};
 		
 		refresh_list();
 		
 		on_select_entry = [this]() {
-			if (entry_list[menu_view.highlighted_index()].is_directory) {
+			if (selected_entry().is_directory) {
 				load_directory_contents(get_selected_path());
 				refresh_list();
 			} else
@@ -322,13 +342,13 @@ FileManagerView::FileManagerView(
 		};
 		
 		button_rename.on_select = [this, &nav](Button&) {
-			name_buffer = entry_list[menu_view.highlighted_index()].entry_path.filename().string().substr(0, max_filename_length);
+			name_buffer = selected_entry().name.string().substr(0, max_filename_length);
 			on_rename(nav);
 		};
 		
 		button_delete.on_select = [this, &nav](Button&) {
 			// Use display_modal ?
-			nav.push<ModalMessageView>("Delete", "Delete " + entry_list[menu_view.highlighted_index()].entry_path.filename().string() + "\nAre you sure?", YESNO,
+			nav.push<ModalMessageView>("Delete", "Delete " + selected_entry().name.string() + "\nAre you sure?", YESNO,
 				[this](bool choice) {
 					if (choice)
 						on_delete();
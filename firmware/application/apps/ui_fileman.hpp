@@ -25,17 +25,12 @@
 #include "ui_painter.hpp"
 #include "ui_menu.hpp"
 #include "file.hpp"
+#include "directory_model.hpp"
 #include "ui_navigation.hpp"
 #include "ui_textentry.hpp"
 
 namespace ui {
 
-struct fileman_entry {
-	std::filesystem::path entry_path { };
-	uint32_t size { };
-	bool is_directory { };
-};
-
 class FileManBaseView : public View {
 public:
 	FileManBaseView(
@@ -55,6 +50,10 @@ protected:
 	
 	static constexpr size_t max_filename_length = 30 - 2;
 	
+	// Only this many entries around the highlight are read into the menu.
+	static constexpr size_t page_entries = 32;
+	static constexpr size_t page_margin = 4;
+	
 	const std::string suffix[5] = { "B", "kB", "MB", "GB", "??" };
 	
 	struct file_assoc_t {
@@ -69,6 +68,7 @@ protected:
 		{ ".BMP", &bitmap_icon_file_image, ui::Color::green() },
 		{ ".C8",  &bitmap_icon_file_iq, ui::Color::blue() },
 		{ ".C16", &bitmap_icon_file_iq, ui::Color::blue() },
+		{ ".CBF", &bitmap_icon_file_iq, ui::Color::blue() },
 		{ ".WAV", &bitmap_icon_file_wav, ui::Color::dark_magenta() },
 		{ "", &bitmap_icon_file, ui::Color::light_grey() }
 	};
@@ -76,12 +76,19 @@ protected:
 	bool empty_root { false };
 	std::function<void(void)> on_select_entry { nullptr };
 	std::function<void(bool)> on_refresh_widgets { nullptr };
-	std::vector<fileman_entry> entry_list { };
+	std::function<void(void)> on_highlight_entry { nullptr };
+	DirectoryModel directory { };
+	std::vector<DirectoryModel::Entry> entry_page { };
+	size_t page_start { 0 };
 	std::filesystem::path current_path { u"" };
 	std::string extension_filter { "" };
 	
 	void change_category(int32_t category_id);
 	std::filesystem::path get_parent_dir();
+	size_t list_size();
+	const DirectoryModel::Entry& selected_entry();
+	void load_page(const size_t start);
+	void on_highlight();
 	void refresh_list();
 	
 	Labels labels {
@@ -86,7 +86,7 @@
          uint8_t min_color_power { 0 };
          uint32_t pixel_index { 0 };
          std::array<Color, 240> spectrum_row = { 0 };
-         ChannelSpectrumFIFO* fifo { nullptr }; 
+         ChannelSpectrumExchange* exchange { nullptr };
          uint8_t max_power = 0;
 
         Labels labels{
@@ -167,16 +167,16 @@
  		Message::ID::ChannelSpectrumConfig,
  		[this](const Message* const p) {
  			const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
- 			this->fifo = message.fifo;
+ 			this->exchange = message.exchange;
  		}
  	};
  	MessageHandlerRegistration message_handler_frame_sync {
  		Message::ID::DisplayFrameSync,
  		[this](const Message* const) {
- 			if( this->fifo ) {
- 				ChannelSpectrum channel_spectrum;
- 				while( fifo->out(channel_spectrum) ) {
- 					this->on_channel_spectrum(channel_spectrum);
+ 			if( this->exchange ) {
+ 				const auto channel_spectrum = exchange->read();
+ 				if( channel_spectrum ) {
+ 					this->on_channel_spectrum(*channel_spectrum);
  				}
  			}
  		}
@@ -479,6 +479,15 @@ void ScannerView::on_statistics_update(const ChannelStatistics& statistics) {
 	}
 }
 
+void ScannerView::on_rssi_envelope(const RSSIEnvelopeMessage& message) {
+	// A burst too short to show in ChannelStatistics holds the freq, so the squelch check above gets to see it
+	if ( userpause || timer || !scan_thread || (message.trigger == RSSIEnvelopeMessage::no_trigger) )
+		return;
+
+	if (scan_thread->is_scanning() && (scan_thread->is_freq_lock() == 0))
+		scan_thread->set_freq_lock(1);
+}
+
 void ScannerView::scan_pause() {
 	if (scan_thread->is_scanning()) {
 		scan_thread->set_freq_lock(0); 		//Reset the scanner lock (because user paused, or MAX_FREQ_LOCK reached) for next freq scan	
@@ -554,6 +563,13 @@ size_t ScannerView::change_mode(uint8_t new_mod) { //Before this, do a scan_thre
 		break;
 	}
 
+	// Each image starts with the RSSI stream stopped. Decimation 1 is raised to the collector's rate limit.
+	RSSIStreamConfig burst_config { };
+	burst_config.mode = RSSIStreamConfig::Mode::Burst;
+	burst_config.threshold = BURST_THRESHOLD;
+	burst_config.post_trigger = BURST_HANG;
+	baseband::rssi_stream_start(burst_config);
+
 	return mod_step[new_mod];
 }
 
@@ -36,6 +36,8 @@
 
 #define MAX_DB_ENTRY 500
 #define MAX_FREQ_LOCK 10 		//50ms cycles scanner locks into freq when signal detected, to verify signal is not spureous
+#define BURST_THRESHOLD 96		//Raw RSSI (0.4V floor ~31, 2.2V ~170) that holds a freq for the squelch check
+#define BURST_HANG 16			//Envelope samples below BURST_THRESHOLD that end a burst
 
 namespace ui {
 
@@ -129,6 +131,7 @@ private:
 	void frequency_file_load(std::string file_name, bool stop_all_before = false);
 
 	void on_statistics_update(const ChannelStatistics& statistics);
+	void on_rssi_envelope(const RSSIEnvelopeMessage& message);
 	void on_headphone_volume_changed(int32_t v);
 	void handle_retune(uint32_t i);
 
@@ -306,6 +309,13 @@ private:
 			this->on_statistics_update(static_cast<const ChannelStatisticsMessage*>(p)->statistics);
 		}
 	};
+
+	MessageHandlerRegistration message_handler_envelope {
+		Message::ID::RSSIEnvelope,
+		[this](const Message* const p) {
+			this->on_rssi_envelope(*static_cast<const RSSIEnvelopeMessage*>(p));
+		}
+	};
 };
 
 } /* namespace ui */
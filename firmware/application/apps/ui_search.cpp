@@ -58,49 +58,40 @@ SearchView::~SearchView() {
 }
 
 void SearchView::do_detection() {
-	uint8_t power_max = 0;
-	int32_t bin_max = -1;
-	uint32_t slice_max = 0;
+	uint8_t snr_max = 0;
+	rf::Frequency frequency_max = 0;
 	uint32_t snap_value;
-	uint8_t power;
 	rtc::RTC datetime;
 	std::string str_approx, str_timestamp;
 	
-	// Display spectrum
-	bin_skip_acc = 0;
-	pixel_index = 0;
-	display.draw_pixels(
-		{ { 0, 88 }, { (Dim)spectrum_row.size(), 1 } },
-		spectrum_row
-	);
-	
-	mean_power = mean_acc / (SEARCH_BIN_NB_NO_DC * slices_nb);
-	mean_acc = 0;
-	
+	noise_floor = 0;
 	overall_power_max = 0;
 	
-	// Find max power over threshold for all slices
+	// Strongest candidate over all slices
 	for (size_t slice = 0; slice < slices_nb; slice++) {
-		power = slices[slice].max_power;
-		if (power > overall_power_max)
-			overall_power_max = power;
+		noise_floor += slices[slice].noise_floor;
+		if (slices[slice].max_power > overall_power_max)
+			overall_power_max = slices[slice].max_power;
 		
-		if ((power >= mean_power + power_threshold) && (power > power_max)) {
-			power_max = power;
-			bin_max = slices[slice].max_index;
-			slice_max = slice;
+		if (slices[slice].candidate_snr > snr_max) {
+			snr_max = slices[slice].candidate_snr;
+			frequency_max = slices[slice].center_frequency + slices[slice].candidate_offset;
 		}
 	}
+	noise_floor /= slices_nb;
+	
+	const bool found = (snr_max > 0);
 	
 	// Lock / release
-	if ((bin_max >= last_bin - 2) && (bin_max <= last_bin + 2) && (bin_max > -1) && (slice_max == last_slice)) {
+	const rf::Frequency bin_width = slice_width / SEARCH_FFT_SIZE;
+	if (found && (frequency_max + 2 * bin_width >= last_frequency) && (frequency_max <= last_frequency + 2 * bin_width)) {
 		
-		// Staying around the same bin
+		// Staying around the same frequency
 		if (detect_timer >= DETECT_DELAY) {
-			if ((bin_max != locked_bin) || (!locked)) {
+			if ((frequency_max != locked_frequency) || (!locked)) {
 				
 				if (!locked) {
-					resolved_frequency = slices[slice_max].center_frequency + (SEARCH_BIN_WIDTH * (bin_max - 128));
+					resolved_frequency = frequency_max;
 					
 					if (check_snap.value()) {
 						snap_value = options_snap.selected_index_value();
@@ -125,7 +116,7 @@ void SearchView::do_detection() {
 						big_display.set_style(&style_locked);
 						
 						locked = true;
-						locked_bin = bin_max;
+						locked_frequency = frequency_max;
 						
 						// TODO
 						/*nav_.pop();
@@ -162,87 +153,84 @@ void SearchView::do_detection() {
 		}
 	}
 	
-	last_bin = bin_max;
-	last_slice = slice_max;
+	last_frequency = found ? frequency_max : 0;
 	search_counter++;
 	
 	// Refresh red tick
 	portapack::display.fill_rectangle({last_tick_pos, 90, 1, 6}, Color::black());
-	if (bin_max > -1) {
-		last_tick_pos = (Coord)(bin_max / slices_nb);
+	if (found) {
+		const auto span_start = slices[0].center_frequency - (slice_width / 2);
+		last_tick_pos = (Coord)((frequency_max - span_start) * 240 / (slice_width * slices_nb));
 		portapack::display.fill_rectangle({last_tick_pos, 90, 1, 6}, Color::red());
 	}
 }
 
-void SearchView::add_spectrum_pixel(Color color) {
-	// Is avoiding floats really necessary ?
-	bin_skip_acc += bin_skip_frac;
-	if (bin_skip_acc < 0x10000) 
+void SearchView::on_trace(const WidebandSpectrumTrace& trace) {
+	const size_t slice = trace.slice;
+	if (slice >= slices_nb)
 		return;
 	
-	bin_skip_acc -= 0x10000;
+	// Each slice gets its share of the spectrum row, keeping the max of the columns it covers
+	const size_t first = slice * 240 / slices_nb;
+	const size_t last = (slice + 1) * 240 / slices_nb;
+	const size_t width = last - first;
+	uint8_t max_power = 0;
+	for (size_t pixel = first; pixel < last; pixel++) {
+		uint8_t power = 0;
+		for (size_t column = (pixel - first) * 240 / width; column < (pixel - first + 1) * 240 / width; column++)
+			power = std::max(power, trace.max[column]);
+		spectrum_row[pixel] = spectrum_rgb3_lut[power];
+		max_power = std::max(max_power, power);
+	}
+	slices[slice].max_power = max_power;
 	
-	if (pixel_index < 240)
-		spectrum_row[pixel_index++] = color;
+	display.draw_pixels(
+		{ { 0, 88 }, { (Dim)spectrum_row.size(), 1 } },
+		spectrum_row
+	);
 }
 
-void SearchView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
-	uint8_t max_power = 0;
-	int16_t max_bin = 0;
-	uint8_t power;
-	size_t bin;
+void SearchView::on_candidates(const SignalCandidatesMessage& message) {
+	if (message.slice != slice_counter)
+		return;
 	
-	baseband::spectrum_streaming_stop();
+	auto& slice = slices[slice_counter];
+	slice.noise_floor = message.noise_floor;
+	slice.candidate_snr = 0;
 	
-	// Add pixels to spectrum display and find max power for this slice
-	// Center 12 bins are ignored (DC spike is blanked)
-	// Leftmost and rightmost 2 bins are ignored
-	for (bin = 0; bin < 256; bin++) {
-
-		if ((bin < 2) || (bin > 253) || ((bin >= 122) && (bin < 134))) {
-			power = 0;
-		} else {
-			if (bin < 128)
-				power = spectrum.db[128 + bin];
-			else
-				power = spectrum.db[bin - 128];
-		}
-		
-		add_spectrum_pixel(spectrum_rgb3_lut[power]);
-		
-		mean_acc += power;
-		if (power > max_power) {
-			max_power = power;
-			max_bin = bin;
+	// Strongest first, keep the best one inside the searched range
+	const auto range_min = std::min(f_min, f_max);
+	const auto range_max = std::max(f_min, f_max);
+	for (size_t i = 0; i < message.count; i++) {
+		const auto& candidate = message.candidates[i];
+		const rf::Frequency frequency = slice.center_frequency + candidate.center_offset;
+		if ((frequency >= range_min) && (frequency <= range_max)) {
+			slice.candidate_offset = candidate.center_offset;
+			slice.candidate_snr = candidate.snr;
+			break;
 		}
 	}
 	
-	slices[slice_counter].max_power = max_power;
-	slices[slice_counter].max_index = max_bin;
-	
-	if (slices_nb > 1) {
-		// Slice sequence
-		if (slice_counter >= slices_nb) {
-			do_detection();
-			slice_counter = 0;
-		} else
-			slice_counter++;
-		receiver_model.set_tuning_frequency(slices[slice_counter].center_frequency);
-		baseband::set_spectrum(SEARCH_SLICE_WIDTH, 31);	// Clear
-	} else {
-		// Unique slice
+	if (++slice_counter >= slices_nb) {
 		do_detection();
+		slice_counter = 0;
 	}
 	
-	baseband::spectrum_streaming_start();
+	if (slices_nb > 1)
+		tune_slice();
+}
+
+void SearchView::tune_slice() {
+	receiver_model.set_tuning_frequency(slices[slice_counter].center_frequency);
+	baseband::set_wideband_spectrum(slice_width, SEARCH_FFT_SIZE, SEARCH_FFT_AVERAGES, slice_counter);
 }
 
 void SearchView::on_show() {
-	baseband::spectrum_streaming_start();
+	baseband::set_signal_detect(power_threshold);
 }
 
 void SearchView::on_hide() {
-	baseband::spectrum_streaming_stop();
+	baseband::set_signal_detect(0);
 }
 
 void SearchView::on_range_changed() {
@@ -255,45 +243,64 @@ void SearchView::on_range_changed() {
 	search_span = abs(f_max - f_min);
 	
 	if (search_span > SEARCH_SLICE_WIDTH) {
-		// ex: 100M~115M (15M span):
-		// slices_nb = (115M-100M)/2.5M = 6
-		slices_nb = (search_span + SEARCH_SLICE_WIDTH - 1) / SEARCH_SLICE_WIDTH;
-		if (slices_nb > 32) {
+		slice_width = SEARCH_SLICE_WIDTH;
+		
+		// ex: 100M~150M (50M span):
+		// slices_nb = (150M-100M)/20M = 3
+		slices_nb = (search_span + slice_width - 1) / slice_width;
+		if (slices_nb > SEARCH_SLICES_MAX) {
 			text_slices.set("!!");
-			slices_nb = 32;
+			slices_nb = SEARCH_SLICES_MAX;
 		} else {
 			text_slices.set(to_string_dec_uint(slices_nb, 2, ' '));
 		}
-		// slices_span = 6 * 2.5M = 15M
-		slices_span = slices_nb * SEARCH_SLICE_WIDTH;
-		// offset = 0 + 2.5/2 = 1.25M
-		offset = ((search_span - slices_span) / 2) + (SEARCH_SLICE_WIDTH / 2);
-		// slice_start = 100M + 1.25M = 101.25M
+		// slices_span = 3 * 20M = 60M
+		slices_span = slices_nb * slice_width;
+		// offset = -5M + 20/2 = 5M
+		offset = ((search_span - slices_span) / 2) + (slice_width / 2);
+		// slice_start = 100M + 5M = 105M
 		center_frequency = std::min(f_min, f_max) + offset;
 		
 		for (slice = 0; slice < slices_nb; slice++) {
 			slices[slice].center_frequency = center_frequency;
-			center_frequency += SEARCH_SLICE_WIDTH;
+			center_frequency += slice_width;
 		}
 	} else {
+		// Narrowest of 2.5, 5, 10 and 20MHz that covers the span
+		slice_width = SEARCH_SLICE_WIDTH_MIN;
+		while ((slice_width < search_span) && (slice_width < SEARCH_SLICE_WIDTH))
+			slice_width *= 2;
+		
 		slices[0].center_frequency = (f_max + f_min) / 2;
-		receiver_model.set_tuning_frequency(slices[0].center_frequency);
 
 		slices_nb = 1;
 		text_slices.set(" 1");
 	}
 	
-	bin_skip_frac = 0xF000 / slices_nb;
+	receiver_model.set_sampling_rate(slice_width);
+	receiver_model.set_baseband_bandwidth(slice_width);
+	
+	for (slice = 0; slice < slices_nb; slice++) {
+		slices[slice].max_power = 0;
+		slices[slice].noise_floor = 0;
+		slices[slice].candidate_snr = 0;
+	}
 
 	slice_counter = 0;
+	tune_slice();
+	
+	// Noise floors of the old slices don't apply anymore
+	baseband::set_signal_detect(power_threshold);
 }
 
 void SearchView::on_lna_changed(int32_t v_db) {
 	receiver_model.set_lna(v_db);
+	baseband::set_signal_detect(power_threshold);
 }
 
 void SearchView::on_vga_changed(int32_t v_db) {
 	receiver_model.set_vga(v_db);
+	baseband::set_signal_detect(power_threshold);
 }
 
 void SearchView::do_timers() {
@@ -312,10 +319,10 @@ void SearchView::do_timers() {
 		// ~5Hz
 		
 		// Update power levels
-		text_mean.set(to_string_dec_uint(mean_power, 3));
+		text_mean.set(to_string_dec_uint(noise_floor, 3));
 		
 		vu_max.set_value(overall_power_max);
-		vu_max.set_mark(mean_power + power_threshold);
+		vu_max.set_mark(noise_floor + power_threshold);
 	}
 	
 	if (timing_div % 6 == 0) {
@@ -365,8 +372,6 @@ SearchView::SearchView(
 		&recent_entries_view
 	});
 	
-	baseband::set_spectrum(SEARCH_SLICE_WIDTH, 31);
-	
 	recent_entries_view.set_parent_rect({ 0, 28 * 8, 240, 12 * 8 });
 	recent_entries_view.on_select = [this, &nav](const SearchRecentEntry& entry) {
 		nav.push<FrequencyKeypadView>(entry.frequency);
@@ -381,9 +386,10 @@ SearchView::SearchView(
 	check_snap.set_value(true);
 	options_snap.set_selected_index(1);		// 12.5kHz
 	
-	field_threshold.set_value(80);
+	field_threshold.set_value(power_threshold);
 	field_threshold.on_change = [this](int32_t value) {
 		power_threshold = value;
+		baseband::set_signal_detect(power_threshold);
 	};
 
 	field_frequency_min.set_value(receiver_model.tuning_frequency() - 1000000);
@@ -425,8 +431,8 @@ SearchView::SearchView(
 	on_range_changed();
 
 	receiver_model.set_modulation(ReceiverModel::Mode::SpectrumAnalysis);
-	receiver_model.set_sampling_rate(SEARCH_SLICE_WIDTH);
-	receiver_model.set_baseband_bandwidth(2500000);
+	receiver_model.set_sampling_rate(slice_width);
+	receiver_model.set_baseband_bandwidth(slice_width);
 	receiver_model.enable();
 }
 
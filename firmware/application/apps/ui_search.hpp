@@ -30,10 +30,11 @@
 
 namespace ui {
 
-#define SEARCH_SLICE_WIDTH	2500000					// Search slice bandwidth
-#define SEARCH_BIN_NB			256					// FFT power bins
-#define SEARCH_BIN_NB_NO_DC	(SEARCH_BIN_NB - 16)	// Bins after trimming
-#define SEARCH_BIN_WIDTH		(SEARCH_SLICE_WIDTH / SEARCH_BIN_NB)
+#define SEARCH_SLICE_WIDTH	20000000				// Widest search slice, narrower spans use a narrower one
+#define SEARCH_SLICE_WIDTH_MIN	2500000
+#define SEARCH_FFT_SIZE		2048					// FFT power bins
+#define SEARCH_FFT_AVERAGES	4						// FFTs per trace
+#define SEARCH_SLICES_MAX		16
 
 #define DETECT_DELAY		5	// In 100ms units
 #define RELEASE_DELAY		6
@@ -107,39 +108,37 @@ private:
 	struct slice_t {
 		rf::Frequency center_frequency;
 		uint8_t max_power;
-		int16_t max_index;
-		uint8_t power;
-		int16_t index;
-	} slices[32];
+		uint8_t noise_floor;
+		int32_t candidate_offset;	// Strongest candidate, Hz from center
+		uint8_t candidate_snr;		// 0 if none
+	} slices[SEARCH_SLICES_MAX];
 	
-	uint32_t bin_skip_acc { 0 }, bin_skip_frac { };
-	uint32_t pixel_index { 0 };
 	std::array<Color, 240> spectrum_row = { 0 };
-	ChannelSpectrumFIFO* fifo { nullptr };
+	WidebandSpectrumTraceExchange* exchange { nullptr };
 	rf::Frequency f_min { 0 }, f_max { 0 };
+	rf::Frequency slice_width { SEARCH_SLICE_WIDTH };
 	uint8_t detect_timer { 0 }, release_timer { 0 }, timing_div { 0 };
 	uint8_t overall_power_max { 0 };
-	uint32_t mean_power { 0 }, mean_acc { 0 };
+	uint32_t noise_floor { 0 };
 	uint32_t duration { 0 };
-	uint32_t power_threshold { 80 };	// Todo: Put this in persistent / settings
-	rf::Frequency slice_start { 0 };
+	uint32_t power_threshold { 24 };	// Todo: Put this in persistent / settings
 	uint8_t slices_nb { 0 };
 	uint8_t slice_counter { 0 };
-	int16_t last_bin { 0 };
-	uint32_t last_slice { 0 };
+	rf::Frequency last_frequency { 0 };
 	Coord last_tick_pos { 0 };
 	rf::Frequency search_span { 0 }, resolved_frequency { 0 };
-	uint16_t locked_bin { 0 };
+	rf::Frequency locked_frequency { 0 };
 	uint8_t search_counter { 0 };
 	bool locked { false };
 	
-	void on_channel_spectrum(const ChannelSpectrum& spectrum);
+	void on_trace(const WidebandSpectrumTrace& trace);
+	void on_candidates(const SignalCandidatesMessage& message);
 	void on_range_changed();
 	void do_detection();
 	void on_lna_changed(int32_t v_db);
 	void on_vga_changed(int32_t v_db);
 	void do_timers();
-	void add_spectrum_pixel(Color color);
+	void tune_slice();
 	
 	const RecentEntriesColumns columns { {
 		{ "Frequency", 9 },
@@ -151,8 +150,8 @@ private:
 	
 	Labels labels {
 		{ { 1 * 8, 0 }, "Min:      Max:       LNA VGA", Color::light_grey() },
-		{ { 1 * 8, 4 * 8 }, "Trig:   /255    Mean:   /255", Color::light_grey() },
-		{ { 1 * 8, 6 * 8 }, "Slices:  /32      Rate:   Hz", Color::light_grey() },
+		{ { 1 * 8, 4 * 8 }, "Trig:   /255   Floor:   /255", Color::light_grey() },
+		{ { 1 * 8, 6 * 8 }, "Slices:  /16      Rate:   Hz", Color::light_grey() },
 		{ { 6 * 8, 10 * 8 }, "Timer  Status", Color::light_grey() },
 		{ { 1 * 8, 25 * 8 }, "Accuracy +/-4.9kHz", Color::light_grey() },
 		{ { 26 * 8, 25 * 8 }, "MHz", Color::light_grey() }
@@ -174,8 +173,8 @@ private:
 	NumberField field_threshold {
 		{ 6 * 8, 2 * 16 },
 		3,
-		{ 5, 255 },
-		5,
+		{ 4, 100 },
+		2,
 		' '
 	};
 	Text text_mean {
@@ -228,20 +227,27 @@ private:
 		0
 	};
 	
-	MessageHandlerRegistration message_handler_spectrum_config {
-		Message::ID::ChannelSpectrumConfig,
+	MessageHandlerRegistration message_handler_trace_config {
+		Message::ID::WidebandSpectrumTraceConfig,
 		[this](const Message* const p) {
-			const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
-			this->fifo = message.fifo;
+			const auto message = *reinterpret_cast<const WidebandSpectrumTraceConfigMessage*>(p);
+			this->exchange = message.exchange;
+			this->exchange->set_requested_rate(60);
+		}
+	};
+	MessageHandlerRegistration message_handler_candidates {
+		Message::ID::SignalCandidates,
+		[this](const Message* const p) {
+			this->on_candidates(*reinterpret_cast<const SignalCandidatesMessage*>(p));
 		}
 	};
 	MessageHandlerRegistration message_handler_frame_sync {
 		Message::ID::DisplayFrameSync,
 		[this](const Message* const) {
-			if( this->fifo ) {
-				ChannelSpectrum channel_spectrum;
-				while( fifo->out(channel_spectrum) ) {
-					this->on_channel_spectrum(channel_spectrum);
+			if( this->exchange ) {
+				const auto trace = exchange->read();
+				if( trace ) {
+					this->on_trace(*trace);
 				}
 			}
 			this->do_timers();
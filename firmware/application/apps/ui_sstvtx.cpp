@@ -40,50 +40,20 @@ void SSTVTXView::focus() {
 		options_bitmaps.focus();
 }
 
-void SSTVTXView::read_boundary(uint8_t * const buffer, uint32_t position, uint32_t length) {
-	uint32_t to_read, split;
-	uint8_t * buffer_copy = buffer;
-	
-	bmp_file.seek(position);
-	
-	// FatFS bug workaround: we can't read across 512 byte boundaries ?!
-	while (length) {
-		to_read = (length <= 512) ? length : 512;
-		if ((position & 512) != ((position + to_read - 1) & 512)) {
-			// Crossing: do 2 reads before and after the boundary
-			split = 512 - (position & 511);
-			bmp_file.read(buffer_copy, split);
-			bmp_file.read(buffer_copy + split, to_read - split);
-		} else {
-			// No crossing, just read normally
-			bmp_file.read(buffer_copy, to_read);
-		}
-		position += to_read;
-		buffer_copy += to_read;
-		length -= to_read;
-	}
-}
-
 void SSTVTXView::paint(Painter&) {
-	ui::Color line_buffer[160];
-	Coord line;
-	uint32_t data_idx, bmp_px, pixel_idx;
-	
-	data_idx = bmp_header.image_data;
-	
-	for (line = 0; line < (256 / 2); line++) {
+	constexpr size_t preview_width = 160;
+	constexpr size_t preview_height = 128;
+	ui::Color line_buffer[preview_width];
+	uint8_t rgb[preview_width * 3];
+	
+	for (size_t line = 0; line < preview_height; line++) {
+		if (!image.read_preview_row(line, preview_height, rgb, preview_width))
+			break;
 		
-		// Buffer a whole line
-		read_boundary(pixels_buffer, data_idx, sizeof(pixels_buffer));
+		for (size_t px = 0; px < preview_width; px++)
+			line_buffer[px] = Color(rgb[px * 3 + 0], rgb[px * 3 + 1], rgb[px * 3 + 2]);
 		
-		for (bmp_px = 0; bmp_px < 160; bmp_px++) {
-			pixel_idx = bmp_px * 3 * 2;
-			line_buffer[bmp_px] = Color(pixels_buffer[pixel_idx + 2],
-										pixels_buffer[pixel_idx + 1],
-										pixels_buffer[pixel_idx + 0]);
-		}
-		portapack::display.render_line({ 16, 80 + 128 - line }, 160, line_buffer);
-		data_idx += sizeof(pixels_buffer) * 2;
+		portapack::display.render_line({ 16, (Coord)(80 + line) }, preview_width, line_buffer);
 	}
 }
 
@@ -98,10 +68,9 @@ void SSTVTXView::on_tuning_frequency_changed(rf::Frequency f) {
 
 void SSTVTXView::prepare_scanline() {
 	sstv_scanline scanline_buffer;
-	uint32_t component, pixel_idx;
-	uint8_t offset;
+	uint32_t component;
 	
-	if (scanline_counter >= (256 * 3)) {
+	if (scanline_counter >= (tx_sstv_mode->lines * 3u)) {
 		progressbar.set_value(0);
 		transmitter_model.disable();
 		options_bitmaps.set_focusable(true);
@@ -139,21 +108,15 @@ void SSTVTXView::prepare_scanline() {
 		}
 	}
 	
-	if (!component) {
-		// Read a new line
-		read_boundary(pixels_buffer,
-						bmp_header.image_data + ((255 - (scanline_counter / 3)) * sizeof(pixels_buffer)),
-						sizeof(pixels_buffer));
-	}
-	
-	offset = component_map[component];
-	for (uint32_t bmp_px = 0; bmp_px < 320; bmp_px++) {
-		pixel_idx = bmp_px * 3;
-		scanline_buffer.luma[bmp_px] = pixels_buffer[pixel_idx + offset];
-	}
+	// Components come already converted and in transmit order
+	memcpy(scanline_buffer.luma, image.component(component), sizeof(scanline_buffer.luma));
 	
 	baseband::set_fifo_data((int8_t *)&scanline_buffer);
 	
+	// The next line is decoded while this one goes out
+	if (component == 2)
+		image.next_line();
+	
 	scanline_counter++;
 }
 
@@ -163,6 +126,7 @@ void SSTVTXView::start_tx() {
 	// leave enough time for the code in prepare_scanline() before it ends.
 	
 	scanline_counter = 0;
+	image.rewind();
 	prepare_scanline();		// Preload one scanline
 	
 	transmitter_model.set_sampling_rate(3072000U);
@@ -180,26 +144,13 @@ void SSTVTXView::start_tx() {
 }
 
 void SSTVTXView::on_bitmap_changed(const size_t index) {
-	bmp_file.open("/sstv/" + bitmaps[index].string());
-	bmp_file.read(&bmp_header, sizeof(bmp_header));
+	image.open("/sstv/" + bitmaps[index].string());
 	set_dirty();
 }
 
 void SSTVTXView::on_mode_changed(const size_t index) {
-	sstv_color_seq tx_color_sequence;
-	
 	tx_sstv_mode = &sstv_modes[index];
-	
-	tx_color_sequence = sstv_modes[index].color_sequence;
-	if (tx_color_sequence == SSTV_COLOR_RGB) {
-		component_map[0] = 2;
-		component_map[1] = 1;
-		component_map[2] = 0;
-	} else if (tx_color_sequence == SSTV_COLOR_GBR) {
-		component_map[0] = 1;
-		component_map[1] = 0;
-		component_map[2] = 2;
-	}
+	image.configure(sstv_modes[index]);
 
 	progressbar.set_max(sstv_modes[index].lines * 3);
 }
@@ -222,17 +173,9 @@ SSTVTXView::SSTVTXView(
 		return;
 	}
 	for (const auto& file_name : file_list) {
-		if (!bmp_file.open("/sstv/" + file_name.string()).is_valid()) {
-			bmp_file.read(&bmp_header, sizeof(bmp_header));
-			if ((bmp_header.signature == 0x4D42) &&	// "BM"
-				(bmp_header.width == 320) &&		// Must be exactly 320x256 pixels for now
-				(bmp_header.height == 256) &&
-				(bmp_header.planes == 1) &&
-				(bmp_header.bpp == 24) &&			// 24 bpp only
-				(bmp_header.compression == 0)) {	// No compression
-					bitmaps.push_back(file_name);
-			}
-		}
+		// Any size, scaled to the mode. 24 bpp uncompressed only.
+		if (image.open("/sstv/" + file_name.string()))
+			bitmaps.push_back(file_name);
 	}
 	if (!bitmaps.size()) {
 		file_error = true;
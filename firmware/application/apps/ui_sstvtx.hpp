@@ -32,8 +32,7 @@
 #include "ui_transmitter.hpp"
 #include "message.hpp"
 #include "sstv.hpp"
-#include "file.hpp"
-#include "bmp.hpp"
+#include "sstv_image.hpp"
 
 using namespace sstv;
 
@@ -57,19 +56,12 @@ public:
 private:
 	NavigationView& nav_;
 	
-	sstv_scanline scanline_buffer { };
-	
 	bool file_error { false };
-	File bmp_file { };
-	bmp_header_t bmp_header { };
+	sstv::ImageSource image { };
 	std::vector<std::filesystem::path> bitmaps { };
 	uint32_t scanline_counter { 0 };
-	uint8_t pixels_buffer[320 * 3];		// 320 pixels @ 24bpp
 	const sstv_mode * tx_sstv_mode { };
 	
-	uint8_t component_map[3] { };
-
-	void read_boundary(uint8_t * buffer, uint32_t position, uint32_t length);
 	void on_bitmap_changed(const size_t index);
 	void on_mode_changed(const size_t index);
 	void on_tuning_frequency_changed(rf::Frequency f);
@@ -37,11 +37,29 @@ void ViewWavView::update_scale(int32_t new_scale) {
 }
 
 void ViewWavView::refresh_waveform() {
-	for (size_t i = 0; i < 240; i++) {
-		wav_reader->data_seek(position + (i * scale));
-		wav_reader->read(&waveform_buffer[i], sizeof(int16_t));
+	std::array<int16_t, 128> samples;
+	size_t next = 0;
+	uint64_t base = 0;
+	
+	// One sequential read of the span, keeping every scale-th sample
+	wav_reader->data_seek(position);
+	while (next < 240) {
+		const auto read_size = wav_reader->read(samples.data(), sizeof(samples));
+		if (read_size.is_error() || !read_size.value())
+			break;
+		
+		const size_t count = read_size.value() / sizeof(int16_t);
+		while ((next < 240) && ((next * scale) < (base + count))) {
+			waveform_buffer[next] = samples[(next * scale) - base];
+			next++;
+		}
+		base += count;
 	}
 	
+	// Past the end
+	for (; next < 240; next++)
+		waveform_buffer[next] = 0;
+	
 	waveform.set_dirty();
 	
 	// Window
@@ -68,8 +86,14 @@ void ViewWavView::paint(Painter& painter) {
 	painter.draw_hline({ 0, 10 * 16 }, 240, Color::grey());
 	
 	// Overall amplitude view, 0~127 to 0~255 color index
-	for (size_t i = 0; i < 240; i++)
-		painter.draw_vline({ (Coord)i, 11 * 16 }, 8, spectrum_rgb2_lut[amplitude_buffer[i] << 1]);
+	if (overview_pending) {
+		const Coord progress_width = (overview_progress * 240) / 100;
+		painter.fill_rectangle({ 0, 11 * 16, progress_width, 8 }, Color::grey());
+		painter.fill_rectangle({ progress_width, 11 * 16, 240 - progress_width, 8 }, Color::black());
+	} else {
+		for (size_t i = 0; i < 240; i++)
+			painter.draw_vline({ (Coord)i, 11 * 16 }, 8, spectrum_rgb2_lut[amplitude_buffer[i] << 1]);
+	}
 }
 
 void ViewWavView::on_pos_changed() {
@@ -77,11 +101,34 @@ void ViewWavView::on_pos_changed() {
 	refresh_waveform();
 }
 
-void ViewWavView::load_wav(std::filesystem::path file_path) {
-	int16_t sample;
-	uint32_t average;
-
+void ViewWavView::load_overview() {
+	if (!overview_pending)
+		return;
+	
+	if (!wav_reader->peaks_ready()) {
+		// Redraw the progress bar when it moved
+		const auto progress = wav_reader->peaks_progress();
+		if (progress != overview_progress) {
+			overview_progress = progress;
+			set_dirty();
+		}
+		return;
+	}
 	
+	std::array<wav_peak_t, 240> peaks;
+	const uint32_t samples_per_column = (wav_reader->sample_count() + 239) / 240;
+	if (!wav_reader->read_peaks(0, samples_per_column, peaks.data(), peaks.size()))
+		return;
+	
+	// Overall amplitude, 0~127
+	for (size_t i = 0; i < 240; i++)
+		amplitude_buffer[i] = std::min(std::max(abs(peaks[i].min), abs(peaks[i].max)), 127);
+	
+	overview_pending = false;
+	set_dirty();
+}
+
+void ViewWavView::load_wav(std::filesystem::path file_path) {
 	text_filename.set(file_path.filename().string());
 	auto ms_duration = wav_reader->ms_duration();
 	text_duration.set(unit_auto_scale(ms_duration, 2, 3) + "s");
@@ -91,20 +138,11 @@ void ViewWavView::load_wav(std::filesystem::path file_path) {
 	text_samplerate.set(to_string_dec_uint(wav_reader->sample_rate()) + "Hz");
 	text_title.set(wav_reader->title());
 	
-	// Fill amplitude buffer, world's worst downsampling
-	uint64_t skip = wav_reader->sample_count() / (240 * subsampling_factor);
-	
-	for (size_t i = 0; i < 240; i++) {
-		average = 0;
-		
-		for (size_t s = 0; s < subsampling_factor; s++) {
-			wav_reader->data_seek(((i * subsampling_factor) + s) * skip);
-			wav_reader->read(&sample, 2);
-			average += (abs(sample) >> 8);
-		}
-		
-		amplitude_buffer[i] = average / subsampling_factor;
-	}
+	// Built in the background on first open, then reused
+	wav_reader->open_peaks();
+	overview_pending = true;
+	overview_progress = 0;
+	load_overview();
 	
 	reset_controls();
 	update_scale(1);
@@ -38,13 +38,13 @@ public:
 
 private:
 	NavigationView& nav_;
-	static constexpr uint32_t subsampling_factor = 8;
 	
 	void update_scale(int32_t new_scale);
 	void refresh_waveform();
 	void refresh_measurements();
 	void on_pos_changed();
 	void load_wav(std::filesystem::path file_path);
+	void load_overview();
 	void reset_controls();
 
 	std::unique_ptr<WAVFileReader> wav_reader { };
@@ -54,6 +54,8 @@ private:
 	int32_t scale { 1 };
 	uint64_t ns_per_pixel { };
 	uint64_t position { };
+	bool overview_pending { false };
+	uint8_t overview_progress { 0 };
 	
 	Labels labels {
 		{ { 0 * 8, 0 * 16 }, "File:", Color::light_grey() },
@@ -140,6 +142,13 @@ private:
 		{ 6 * 8, 14 * 16, 30 * 8, 16 },
 		"-"
 	};
+	
+	MessageHandlerRegistration message_handler_frame_sync {
+		Message::ID::DisplayFrameSync,
+		[this](const Message* const) {
+			this->load_overview();
+		}
+	};
 };
 
 } /* namespace ui */
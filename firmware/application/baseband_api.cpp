@@ -78,7 +78,8 @@ void WFMConfig::apply() const {
 		taps_64_lp_156_198,
 		75000,
 		audio_48k_hpf_30hz_config,
-		audio_48k_deemph_2122_6_config
+		audio_48k_deemph_2122_6_config,
+		stereo
 	};
 	send_message(&message);
 	audio::set_rate(audio::Rate::Hz_48000);
@@ -137,12 +138,9 @@ void set_aprs(const uint32_t baudrate) {
 	send_message(&message);
 }
 
-void set_btle(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word) {
+void set_btle(const uint8_t channel_number) {
 	const BTLERxConfigureMessage message {
-		baudrate,
-		word_length,
-		trigger_value,
-		trigger_word
+		channel_number
 	};
 	send_message(&message);
 }
@@ -271,6 +269,20 @@ void set_spectrum(const size_t sampling_rate, const size_t trigger) {
 	send_message(&message);
 }
 
+void set_wideband_spectrum(const size_t sampling_rate, const size_t fft_size, const size_t averages, const size_t slice) {
+	const WidebandSpectrumConfigMessage message {
+		sampling_rate, 0, fft_size, averages, slice
+	};
+	send_message(&message);
+}
+
+void set_signal_detect(const uint8_t threshold) {
+	const SignalDetectConfigMessage message {
+		threshold
+	};
+	send_message(&message);
+}
+
 void set_siggen_tone(const uint32_t tone) {
 	const SigGenToneMessage message {
 		TONES_F2D(tone, TONES_SAMPLERATE)
@@ -315,6 +327,16 @@ void shutdown() {
 	baseband_image_running = false;
 }
 
+void set_core_clock(const uint32_t clock_f) {
+	// A baseband image started later picks this up during its own init.
+	shared_memory.core_clock_f = clock_f;
+
+	if( baseband_image_running ) {
+		const CoreClockMessage message { clock_f };
+		send_message(&message);
+	}
+}
+
 void spectrum_streaming_start() {
 	SpectrumStreamingConfigMessage message {
 		SpectrumStreamingConfigMessage::Mode::Running
@@ -329,6 +351,16 @@ void spectrum_streaming_stop() {
 	send_message(&message);
 }
 
+void rssi_stream_start(const RSSIStreamConfig& config) {
+	const RSSIStreamConfigMessage message { config };
+	send_message(&message);
+}
+
+void rssi_stream_stop() {
+	const RSSIStreamConfigMessage message { RSSIStreamConfig { } };
+	send_message(&message);
+}
+
 void set_sample_rate(const uint32_t sample_rate) {
 	SamplerateConfigMessage message { sample_rate };
 	send_message(&message);
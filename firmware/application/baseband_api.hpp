@@ -52,6 +52,8 @@ struct NBFMConfig {
 };
 
 struct WFMConfig {
+	const bool stereo;
+
 	void apply() const;
 };
 
@@ -71,7 +73,7 @@ void kill_afsk();
 void set_afsk(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word);
 void set_aprs(const uint32_t baudrate);
 
-void set_btle(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word);
+void set_btle(const uint8_t channel_number);
 
 void set_nrf(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word);
 
@@ -84,6 +86,8 @@ void set_adsb();
 void set_jammer(const bool run, const jammer::JammerType type, const uint32_t speed);
 void set_rds_data(const uint16_t message_length);
 void set_spectrum(const size_t sampling_rate, const size_t trigger);
+void set_wideband_spectrum(const size_t sampling_rate, const size_t fft_size, const size_t averages, const size_t slice = 0);
+void set_signal_detect(const uint8_t threshold);
 void set_siggen_tone(const uint32_t tone);
 void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration);
 void request_beep();
@@ -91,9 +95,14 @@ void request_beep();
 void run_image(const portapack::spi_flash::image_tag_t image_tag);
 void shutdown();
 
+void set_core_clock(const uint32_t clock_f);
+
 void spectrum_streaming_start();
 void spectrum_streaming_stop();
 
+void rssi_stream_start(const RSSIStreamConfig& config);
+void rssi_stream_stop();
+
 void set_sample_rate(const uint32_t sample_rate);
 void capture_start(CaptureConfig* const config);
 void capture_stop();
@@ -41,8 +41,9 @@ CaptureThread::CaptureThread(
 	size_t write_size,
 	size_t buffer_count,
 	std::function<void()> success_callback,
-	std::function<void(File::Error)> error_callback
-) : config { write_size, buffer_count },
+	std::function<void(File::Error)> error_callback,
+	const iq::Format format
+) : config { write_size, buffer_count, format },
 	writer { std::move(writer) },
 	success_callback { std::move(success_callback) },
 	error_callback { std::move(error_callback) }
@@ -40,7 +40,8 @@ public:
 		size_t write_size,
 		size_t buffer_count,
 		std::function<void()> success_callback,
-		std::function<void(File::Error)> error_callback
+		std::function<void(File::Error)> error_callback,
+		const iq::Format format = iq::Format::C16
 	);
 	~CaptureThread();
 
@@ -363,6 +363,25 @@ void ClockManager::set_sampling_frequency(const uint32_t frequency) {
 	clock_generator.set_ms_frequency(clock_generator_output_codec, frequency * 2, si5351_vco_f, 1);
 }
 
+uint32_t ClockManager::set_core_clock(const CoreClock clock) {
+	/* Both cores, the M0 RITimer tick, GPIO and timers run from BASE_M4_CLK.
+	 * IDIVB (PLL1 / 2) is already running for SPIFI, so switching the base
+	 * clock over leaves the peripherals on IDIVC (I2C, SDIO, SGPIO, SSP1)
+	 * untouched. Base clock switching between running sources is glitch-free.
+	 */
+	const auto clk_sel = (clock == CoreClock::Half) ? cgu::CLK_SEL::IDIVB : cgu::CLK_SEL::IDIVC;
+	const uint32_t clock_f = (clock == CoreClock::Half) ? (base_m4_clk_f / 2) : base_m4_clk_f;
+
+	chSysLock();
+	LPC_CGU->BASE_M4_CLK.AUTOBLOCK = 1;
+	LPC_CGU->BASE_M4_CLK.CLK_SEL = toUType(clk_sel);
+	systick_adjust_period(clock_f / CH_FREQUENCY - 1);
+	halLPCSetSystemClock(clock_f);
+	chSysUnlock();
+
+	return clock_f;
+}
+
 void ClockManager::set_reference_ppb(const int32_t ppb) {
 	/* NOTE: This adjustment only affects PLLA, which is derived from the 25MHz crystal.
 	 * It is assumed an external clock coming in to PLLB is sufficiently accurate as to not need adjustment.
@@ -40,6 +40,11 @@ public:
 	};
 	using ReferenceFrequency = uint32_t;
 
+	enum class CoreClock {
+		Full,	/* PLL1 via IDIVC, 200 MHz */
+		Half,	/* PLL1 via IDIVB, 100 MHz */
+	};
+
 	typedef struct {
 		ReferenceSource source;
 		ReferenceFrequency frequency;
@@ -73,6 +78,12 @@ public:
 
 	void set_sampling_frequency(const uint32_t frequency);
 
+	/* Returns the new core clock frequency. Only the application core's tick
+	 * is adjusted, the baseband core and other users of BASE_M4_CLK timing
+	 * have to be told separately.
+	 */
+	uint32_t set_core_clock(const CoreClock clock);
+
 	void set_reference_ppb(const int32_t ppb);
 
 	uint32_t get_frequency_monitor_measurement_in_hertz();
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "directory_model.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+static int fold_case(const TCHAR c) {
+	return (c < 0x80) ? toupper(c) : c;
+}
+
+DirectoryModel::~DirectoryModel() {
+	close();
+}
+
+bool DirectoryModel::open(
+	const std::filesystem::path& path,
+	const std::string& filter,
+	const Order order
+) {
+	close();
+
+	if( f_opendir(&dir, reinterpret_cast<const TCHAR*>(path.c_str())) != FR_OK ) {
+		return false;
+	}
+	is_open = true;
+	extension_filter = filter;
+
+	bool sorted = (order == Order::Name);
+
+	// Slots are 16 bits wide, anything past that isn't listed.
+	while( slot < UINT16_MAX ) {
+		if( (slot % checkpoint_interval) == 0 ) {
+			checkpoints.push_back({ dir, (uint16_t)slot, (uint16_t)directories_read, (uint16_t)files_read });
+		}
+
+		if( !read_next() ) {
+			break;
+		}
+
+		if( sorted && (current_kind != Kind::None) ) {
+			if( sort_index.size() < max_sorted_entries ) {
+				add_sort_entry();
+			} else {
+				// Too big to sort, list it in directory order.
+				sorted = false;
+				std::vector<SortEntry>().swap(sort_index);
+			}
+		}
+	}
+
+	directory_count = directories_read;
+	file_count = files_read;
+	checkpoints.shrink_to_fit();
+
+	if( sorted ) {
+		sort_index.shrink_to_fit();
+		std::sort(sort_index.begin(), sort_index.end(), [](const SortEntry& a, const SortEntry& b) {
+			const auto a_directory = a.flags & flag_directory;
+			const auto b_directory = b.flags & flag_directory;
+			if( a_directory != b_directory ) {
+				return a_directory > b_directory;
+			}
+			const auto c = memcmp(a.key, b.key, sizeof(a.key));
+			return (c != 0) ? (c < 0) : (a.slot < b.slot);
+		});
+	}
+
+	return true;
+}
+
+void DirectoryModel::close() {
+	if( is_open ) {
+		f_closedir(&dir);
+		is_open = false;
+	}
+
+	current_kind = Kind::None;
+	slot = 0;
+	directories_read = 0;
+	files_read = 0;
+	directory_count = 0;
+	file_count = 0;
+	std::vector<Checkpoint>().swap(checkpoints);
+	std::vector<SortEntry>().swap(sort_index);
+}
+
+size_t DirectoryModel::read(const size_t index, const size_t count, std::vector<Entry>& entries) {
+	if( !is_open ) {
+		return 0;
+	}
+
+	if( sort_index.empty() ) {
+		return read_in_directory_order(index, count, entries);
+	} else {
+		return read_sorted(index, count, entries);
+	}
+}
+
+bool DirectoryModel::read_next() {
+	const auto result = f_readdir(&dir, &filinfo);
+	if( (result != FR_OK) || (filinfo.fname[0] == 0) ) {
+		current_kind = Kind::None;
+		return false;
+	}
+
+	slot++;
+	current_kind = kind();
+	if( current_kind == Kind::Directory ) {
+		directories_read++;
+	} else if( current_kind == Kind::File ) {
+		files_read++;
+	}
+
+	return true;
+}
+
+DirectoryModel::Kind DirectoryModel::kind() const {
+	// Don't list dir / files starting with '.' (hidden / tmp)
+	if( filinfo.fname[0] == '.' ) {
+		return Kind::None;
+	}
+
+	if( filinfo.fattrib & AM_DIR ) {
+		return Kind::Directory;
+	}
+
+	if( extension_filter.empty() ) {
+		return Kind::File;
+	}
+
+	const TCHAR* extension = nullptr;
+	for(auto p = filinfo.fname; *p; p++) {
+		if( *p == '.' ) {
+			extension = p;
+		}
+	}
+	if( !extension ) {
+		return Kind::None;
+	}
+
+	for(size_t start=0; start<=extension_filter.size(); ) {
+		auto end = extension_filter.find('|', start);
+		if( end == std::string::npos ) {
+			end = extension_filter.size();
+		}
+
+		size_t i = 0;
+		while( extension[i] && ((start + i) < end) && (fold_case(extension[i]) == extension_filter[start + i]) ) {
+			i++;
+		}
+		if( !extension[i] && ((start + i) == end) ) {
+			return Kind::File;
+		}
+
+		start = end + 1;
+	}
+
+	return Kind::None;
+}
+
+void DirectoryModel::restore(const Checkpoint& checkpoint) {
+	dir = checkpoint.dir;
+	slot = checkpoint.slot;
+	directories_read = checkpoint.directories_before;
+	files_read = checkpoint.files_before;
+}
+
+bool DirectoryModel::seek(const size_t target_slot) {
+	const auto& checkpoint = checkpoints[std::min(target_slot / checkpoint_interval, checkpoints.size() - 1)];
+
+	// Carry on from the current position if it's between the checkpoint and the target.
+	if( (slot > target_slot) || (slot < checkpoint.slot) ) {
+		restore(checkpoint);
+	}
+
+	while( slot < target_slot ) {
+		if( !read_next() ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void DirectoryModel::add_sort_entry() {
+	SortEntry entry { };
+
+	// Upper case name prefix, shorter names sort first. Ties are left in directory order.
+	for(size_t i=0; (i < sizeof(entry.key)) && filinfo.fname[i]; i++) {
+		entry.key[i] = std::min(fold_case(filinfo.fname[i]), 0xff);
+	}
+	entry.slot = slot - 1;
+	entry.flags = (current_kind == Kind::Directory) ? flag_directory : 0;
+
+	sort_index.push_back(entry);
+}
+
+void DirectoryModel::add_entry(std::vector<Entry>& entries) const {
+	entries.push_back({
+		std::filesystem::path { filinfo.fname },
+		(uint32_t)filinfo.fsize,
+		current_kind == Kind::Directory
+	});
+}
+
+size_t DirectoryModel::read_in_directory_order(size_t index, const size_t count, std::vector<Entry>& entries) {
+	size_t n = 0;
+
+	for(; (n < count) && (index < size()); n++, index++) {
+		// Directories are listed first, find the k-th entry of the wanted kind.
+		const bool directories = (index < directory_count);
+		const auto wanted = directories ? Kind::Directory : Kind::File;
+		const size_t k = directories ? index : (index - directory_count);
+		const auto& kind_read = directories ? directories_read : files_read;
+
+		// Last checkpoint with at most k entries of that kind before it.
+		auto checkpoint = std::upper_bound(checkpoints.begin(), checkpoints.end(), k,
+			[directories](const size_t value, const Checkpoint& c) {
+				return value < (directories ? c.directories_before : c.files_before);
+			}
+		) - 1;
+
+		if( (kind_read > k) || (kind_read < (directories ? checkpoint->directories_before : checkpoint->files_before)) ) {
+			restore(*checkpoint);
+		}
+
+		bool found = false;
+		while( read_next() ) {
+			if( (current_kind == wanted) && (kind_read == (k + 1)) ) {
+				found = true;
+				break;
+			}
+		}
+
+		if( !found ) {
+			break;
+		}
+
+		add_entry(entries);
+	}
+
+	return n;
+}
+
+size_t DirectoryModel::read_sorted(const size_t index, const size_t count, std::vector<Entry>& entries) {
+	size_t n = 0;
+
+	for(; (n < count) && ((index + n) < sort_index.size()); n++) {
+		if( !seek(sort_index[index + n].slot) || !read_next() ) {
+			break;
+		}
+
+		add_entry(entries);
+	}
+
+	return n;
+}
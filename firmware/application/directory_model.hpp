@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DIRECTORY_MODEL_H__
+#define __DIRECTORY_MODEL_H__
+
+#include "file.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* Directory listing that doesn't keep the listing in memory.
+ *
+ * open() walks the directory once, counting directories and (filtered) files
+ * and saving the FatFs read position every checkpoint_interval entries. Entries
+ * are then read back on demand a few at a time by seeking to the nearest
+ * checkpoint, so memory use is a few bytes per checkpoint rather than a path
+ * per file.
+ *
+ * Views list directories first. Order::Directory keeps the on-disk order,
+ * Order::Name additionally builds a compact sort index (name prefix, slot and
+ * type bits, 12 bytes per entry) for directories up to max_sorted_entries and
+ * falls back to on-disk order for bigger ones.
+ */
+class DirectoryModel {
+public:
+	enum class Order {
+		Directory,
+		Name,
+	};
+
+	struct Entry {
+		std::filesystem::path name;
+		uint32_t size;
+		bool is_directory;
+	};
+
+	~DirectoryModel();
+
+	/* filter is an upper case extension including the dot, several of
+	 * them separated by '|', or empty to list all files. Returns false if
+	 * the directory can't be read.
+	 */
+	bool open(
+		const std::filesystem::path& path,
+		const std::string& filter,
+		const Order order
+	);
+	void close();
+
+	size_t size() const {
+		return directory_count + file_count;
+	}
+
+	bool is_directory(const size_t index) const {
+		return index < directory_count;
+	}
+
+	// Appends up to count entries starting at index, returns the number read.
+	size_t read(const size_t index, const size_t count, std::vector<Entry>& entries);
+
+private:
+	static constexpr size_t checkpoint_interval = 64;
+	static constexpr size_t max_sorted_entries = 512;
+
+	enum class Kind : uint8_t {
+		None,
+		Directory,
+		File,
+	};
+
+	struct Checkpoint {
+		DIR dir;
+		uint16_t slot;
+		uint16_t directories_before;
+		uint16_t files_before;
+	};
+
+	struct SortEntry {
+		char key[8];
+		uint16_t slot;
+		uint8_t flags;
+	};
+
+	static constexpr uint8_t flag_directory = 0x01;
+
+	bool is_open { false };
+	DIR dir { };
+	FILINFO filinfo { };
+	Kind current_kind { Kind::None };
+
+	// Read position, and the number of entries of each kind before it.
+	size_t slot { 0 };
+	size_t directories_read { 0 };
+	size_t files_read { 0 };
+
+	std::string extension_filter { };
+	size_t directory_count { 0 };
+	size_t file_count { 0 };
+	std::vector<Checkpoint> checkpoints { };
+	std::vector<SortEntry> sort_index { };
+
+	bool read_next();
+	Kind kind() const;
+	void restore(const Checkpoint& checkpoint);
+	bool seek(const size_t target_slot);
+	void add_sort_entry();
+	void add_entry(std::vector<Entry>& entries) const;
+	size_t read_in_directory_order(size_t index, const size_t count, std::vector<Entry>& entries);
+	size_t read_sorted(const size_t index, const size_t count, std::vector<Entry>& entries);
+};
+
+#endif/*__DIRECTORY_MODEL_H__*/
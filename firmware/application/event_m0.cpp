@@ -225,6 +225,7 @@ void EventDispatcher::handle_rtc_tick() {
 	sd_card::poll_inserted();
 
 	portapack::temperature_logger.second_tick();
+	portapack::performance_governor.on_second_tick();
 	
 	uint32_t backlight_timer = portapack::persistent_memory::config_backlight_timer();
 	if (backlight_timer) {
@@ -282,7 +283,10 @@ void EventDispatcher::on_touch_event(ui::TouchEvent event) {
 void EventDispatcher::handle_lcd_frame_sync() {
 	DisplayFrameSyncMessage message;
 	message_map.send(&message);
-	painter.paint_widget_tree(top_widget);
+	portapack::performance_governor.poll_m4_load();
+	if( portapack::performance_governor.paint_frame() ) {
+		painter.paint_widget_tree(top_widget);
+	}
 
 	portapack::backlight()->on();
 }
@@ -22,6 +22,7 @@
 
 #include "freqman.hpp"
 #include <algorithm>
+#include <array>
 
 std::vector<std::string> get_freqman_files() {
 	std::vector<std::string> file_list;
@@ -39,91 +40,225 @@ std::vector<std::string> get_freqman_files() {
 	return file_list;
 };
 
+/* Parsed files are cached next to the TXT in a hidden binary sidecar, used as
+ * long as the TXT's size and timestamp haven't changed:
+ * header, entries, then the description pool (identical descriptions are
+ * stored once).
+ */
+static constexpr uint32_t freqman_cache_magic = 0x31434d46;	// "FMC1"
+
+struct freqman_cache_header {
+	uint32_t magic;
+	uint32_t source_size;
+	uint16_t source_date;
+	uint16_t source_time;
+	uint16_t entry_count;
+	uint16_t pool_size;
+};
+
+struct freqman_cache_entry {
+	rf::Frequency frequency_a;
+	rf::Frequency frequency_b;
+	uint16_t description_offset;
+	uint8_t description_length;
+	uint8_t type;
+	uint8_t step;
+};
+
+static std::string freqman_cache_path(const std::string& file_stem) {
+	return "FREQMAN/." + file_stem + ".BIN";
+}
+
+static bool load_freqman_cache(const std::string& file_stem, const freqman_cache_header& source, freqman_db& db) {
+	File cache_file;
+	freqman_cache_header header;
+	
+	if (cache_file.open(freqman_cache_path(file_stem)).is_valid())
+		return false;
+	
+	auto read_size = cache_file.read(&header, sizeof(header));
+	if (read_size.is_error() || (read_size.value() != sizeof(header)))
+		return false;
+	
+	if ((header.magic != freqman_cache_magic) ||
+		(header.source_size != source.source_size) ||
+		(header.source_date != source.source_date) ||
+		(header.source_time != source.source_time) ||
+		(header.entry_count > FREQMAN_MAX_PER_FILE))
+		return false;
+	
+	std::vector<freqman_cache_entry> entries(header.entry_count);
+	std::vector<char> pool(header.pool_size);
+	
+	const auto entries_size = entries.size() * sizeof(freqman_cache_entry);
+	read_size = cache_file.read(entries.data(), entries_size);
+	if (read_size.is_error() || (read_size.value() != entries_size))
+		return false;
+	
+	read_size = cache_file.read(pool.data(), pool.size());
+	if (read_size.is_error() || (read_size.value() != pool.size()))
+		return false;
+	
+	db.reserve(entries.size());
+	for (const auto& entry : entries) {
+		if (entry.description_offset + entry.description_length > pool.size()) {
+			db.clear();
+			return false;
+		}
+		
+		db.push_back({
+			entry.frequency_a,
+			entry.frequency_b,
+			std::string(pool.data() + entry.description_offset, entry.description_length),
+			(freqman_entry_type)entry.type,
+			(freqman_entry_step)entry.step
+		});
+	}
+	
+	return true;
+}
+
+static void save_freqman_cache(const std::string& file_stem, freqman_cache_header header, const freqman_db& db) {
+	File cache_file;
+	std::vector<freqman_cache_entry> entries;
+	std::string pool;
+	
+	entries.reserve(db.size());
+	for (const auto& entry : db) {
+		auto offset = pool.find(entry.description);
+		if (offset == pool.npos) {
+			offset = pool.size();
+			pool += entry.description;
+		}
+		
+		entries.push_back({
+			entry.frequency_a,
+			entry.frequency_b,
+			(uint16_t)offset,
+			(uint8_t)std::min(entry.description.size(), (size_t)255),
+			(uint8_t)entry.type,
+			(uint8_t)entry.step
+		});
+	}
+	
+	header.magic = freqman_cache_magic;
+	header.entry_count = entries.size();
+	header.pool_size = pool.size();
+	
+	if (cache_file.create(freqman_cache_path(file_stem)).is_valid())
+		return;
+	
+	cache_file.write(&header, sizeof(header));
+	cache_file.write(entries.data(), entries.size() * sizeof(freqman_cache_entry));
+	cache_file.write(pool.data(), pool.size());
+}
+
+// Parses "key=value,key=value,..." in one pass. Lines without a frequency are skipped.
+static bool parse_freqman_line(const char* line, const size_t length, freqman_entry& entry) {
+	const char* const end = line + length;
+	bool has_frequency = false;
+	
+	entry = { };
+	entry.description = "-";
+	
+	while (line < end) {
+		const char* const key = line;
+		while ((line < end) && (*line != '='))
+			line++;
+		const size_t key_length = line - key;
+		
+		const char* value = ++line;
+		while ((line < end) && (*line != ','))
+			line++;
+		const size_t value_length = line - value;
+		line++;
+		
+		if (key_length != 1)
+			continue;
+		
+		if (key[0] == 'd') {
+			entry.description = std::string(value, std::min(value_length, (size_t)FREQMAN_DESC_MAX_LEN));
+			continue;
+		}
+		
+		rf::Frequency frequency = 0;
+		for (size_t i = 0; (i < value_length) && (value[i] >= '0') && (value[i] <= '9'); i++)
+			frequency = (frequency * 10) + (value[i] - '0');
+		
+		if (key[0] == 'f') {
+			entry.frequency_a = frequency;
+			entry.type = SINGLE;
+			has_frequency = true;
+		} else if (key[0] == 'a') {
+			entry.frequency_a = frequency;
+			entry.type = RANGE;
+			has_frequency = true;
+		} else if (key[0] == 'b') {
+			entry.frequency_b = frequency;
+		}
+	}
+	
+	return has_frequency;
+}
+
 bool load_freqman_file(std::string& file_stem, freqman_db &db) {
 	File freqman_file;
-	size_t length, n = 0, file_position = 0;
-	char * pos;
-	char * line_start;
-	char * line_end;
-	std::string description;
-	rf::Frequency frequency_a, frequency_b;
-	char file_data[257];
-	freqman_entry_type type;
+	std::array<char, 512> file_data;
+	std::array<char, 128> line;
+	size_t line_length = 0;
+	freqman_entry entry;
 	
 	db.clear();
 	
-	auto result = freqman_file.open("FREQMAN/" + file_stem + ".TXT");
+	const std::string path = "FREQMAN/" + file_stem + ".TXT";
+	auto result = freqman_file.open(path);
 	if (result.is_valid())
 		return false;
 	
-	while (1) {
-		// Read a 256 bytes block from file
-		freqman_file.seek(file_position);
-		
-		memset(file_data, 0, 257);
-		auto read_size = freqman_file.read(file_data, 256);
-		if (read_size.is_error())
+	const auto timestamp = file_created_date(path);
+	const freqman_cache_header source {
+		0,
+		(uint32_t)freqman_file.size(),
+		timestamp.FAT_date,
+		timestamp.FAT_time,
+		0, 0
+	};
+	
+	if (load_freqman_cache(file_stem, source, db))
+		return true;
+	
+	// Stream the file a sector at a time, splitting lines as they come. Longer lines are truncated.
+	while (db.size() < FREQMAN_MAX_PER_FILE) {
+		auto read_size = freqman_file.read(file_data.data(), file_data.size());
+		if (read_size.is_error()) {
+			db.clear();
 			return false;	// Read error
+		}
 		
-		file_position += 256;
-		
-		// Reset line_start to beginning of buffer
-		line_start = file_data;
-		
-		if (!strstr(file_data, "f=") && !strstr(file_data, "a="))
-			break;
+		const size_t count = read_size.value();
 		
-		// Look for complete lines in buffer
-		while ((line_end = strstr(line_start, "\x0A"))) {
-			// Read frequency
-			pos = strstr(line_start, "f=");
-			frequency_b = 0;
-			type = SINGLE;
-			if (pos) {
-				pos += 2;
-				frequency_a = strtoll(pos, nullptr, 10);
-			} else {
-				// ...or range
-				pos = strstr(line_start, "a=");
-				if (pos) {
-					pos += 2;
-					frequency_a = strtoll(pos, nullptr, 10);
-					type = RANGE;
-					pos = strstr(line_start, "b=");
-					if (pos) {
-						pos += 2;
-						frequency_b = strtoll(pos, nullptr, 10);
-					} else
-						frequency_b = 0;
-				} else
-					frequency_a = 0;
-			}
-			
-			// Read description until , or LF
-			pos = strstr(line_start, "d=");
-			if (pos) {
-				pos += 2;
-				length = std::min(strcspn(pos, ",\x0A"), (size_t)FREQMAN_DESC_MAX_LEN);
-				description = string(pos, length);
-			} else
-				description = "-";
+		for (size_t i = 0; (i < count) && (db.size() < FREQMAN_MAX_PER_FILE); i++) {
+			const char c = file_data[i];
 			
-			db.push_back({ frequency_a, frequency_b, description, type });
-			n++;
-			
-			if (n >= FREQMAN_MAX_PER_FILE) return true;
-			
-			line_start = line_end + 1;
-			if (line_start - file_data >= 256) break;
+			if (c == '\n') {
+				if (parse_freqman_line(line.data(), line_length, entry))
+					db.push_back(std::move(entry));
+				line_length = 0;
+			} else if ((c != '\r') && (line_length < line.size())) {
+				line[line_length++] = c;
+			}
 		}
 		
-		if (read_size.value() != 256)
-			break;	// End of file
-		
-		// Restart at beginning of last incomplete line
-		file_position -= (file_data + 256 - line_start);
+		if (count != file_data.size()) {
+			// End of file, last line may not be terminated
+			if (line_length && (db.size() < FREQMAN_MAX_PER_FILE) && parse_freqman_line(line.data(), line_length, entry))
+				db.push_back(std::move(entry));
+			break;
+		}
 	}
 	
+	save_freqman_cache(file_stem, source, db);
+	
 	return true;
 }
 
@@ -135,6 +270,9 @@ bool save_freqman_file(std::string& file_stem, freqman_db &db) {
 	if (!create_freqman_file(file_stem, freqman_file))
 		return false;
 	
+	// Timestamps only have 2s resolution, don't trust the cache to notice
+	delete_file(freqman_cache_path(file_stem));
+	
 	for (size_t n = 0; n < db.size(); n++) {
 		auto& entry = db[n];
 
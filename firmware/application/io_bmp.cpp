@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "io_bmp.hpp"
+
+bool BMPFileReader::open(const std::filesystem::path& path) {
+	block_offset = block_none;
+
+	if( file.open(path).is_valid() ) {
+		return false;
+	}
+
+	const auto result = file.read(&header, sizeof(header));
+	if( result.is_error() || (result.value() != sizeof(header)) ) {
+		return false;
+	}
+
+	if( (header.signature != 0x4D42) ||		// "BM"
+		(header.planes != 1) ||
+		(header.bpp != 24) ||
+		(header.compression != 0) ) {
+		return false;
+	}
+
+	// Negative height means rows are stored top-down.
+	const int32_t signed_height = static_cast<int32_t>(header.height);
+	bottom_up = (signed_height > 0);
+	height_ = bottom_up ? signed_height : -signed_height;
+	width_ = header.width;
+	stride = (width_ * 3 + 3) & ~3UL;
+
+	return (width_ != 0) && (height_ != 0);
+}
+
+bool BMPFileReader::load_block(const uint32_t offset) {
+	const uint32_t aligned_offset = offset & ~(block_size - 1);
+	if( aligned_offset == block_offset ) {
+		return true;
+	}
+
+	block_offset = block_none;
+	if( file.seek(aligned_offset).is_error() ) {
+		return false;
+	}
+	// The last block may be short, which is fine.
+	if( file.read(block.data(), block.size()).is_error() ) {
+		return false;
+	}
+	block_offset = aligned_offset;
+	return true;
+}
+
+const uint8_t* BMPFileReader::pixel(const uint32_t offset) {
+	const size_t index = offset & (block_size - 1);
+	if( index <= (block_size - 3) ) {
+		if( !load_block(offset) ) {
+			return nullptr;
+		}
+		return &block[index];
+	}
+
+	// Pixel straddles two blocks.
+	for(size_t i=0; i<3; i++) {
+		if( !load_block(offset + i) ) {
+			return nullptr;
+		}
+		straddle[i] = block[(offset + i) & (block_size - 1)];
+	}
+	return straddle.data();
+}
+
+bool BMPFileReader::read_row(const uint32_t y, uint8_t* const rgb, const size_t output_width) {
+	if( y >= height_ ) {
+		return false;
+	}
+
+	const uint32_t row = bottom_up ? (height_ - 1 - y) : y;
+	const uint32_t row_offset = header.image_data + row * stride;
+
+	for(size_t x=0; x<output_width; x++) {
+		const uint32_t source_x = (x * width_) / output_width;
+		const auto bgr = pixel(row_offset + source_x * 3);
+		if( !bgr ) {
+			return false;
+		}
+		rgb[x * 3 + 0] = bgr[2];
+		rgb[x * 3 + 1] = bgr[1];
+		rgb[x * 3 + 2] = bgr[0];
+	}
+
+	return true;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "file.hpp"
+#include "bmp.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Uncompressed 24bpp BMP reader, any size, bottom-up or top-down.
+ * The file is only ever read in whole, sector aligned blocks, which also
+ * keeps FatFS from seeing reads that straddle sectors.
+ */
+class BMPFileReader {
+public:
+	BMPFileReader() = default;
+
+	BMPFileReader(const BMPFileReader&) = delete;
+	BMPFileReader& operator=(const BMPFileReader&) = delete;
+	BMPFileReader(BMPFileReader&&) = delete;
+	BMPFileReader& operator=(BMPFileReader&&) = delete;
+
+	// Returns false if the file can't be opened or isn't a supported BMP.
+	bool open(const std::filesystem::path& path);
+
+	uint32_t width() const {
+		return width_;
+	}
+
+	uint32_t height() const {
+		return height_;
+	}
+
+	/* Reads source row y (0 is the top) as R, G, B triplets, nearest
+	 * neighbour scaled to output_width pixels.
+	 */
+	bool read_row(const uint32_t y, uint8_t* const rgb, const size_t output_width);
+
+private:
+	static constexpr size_t block_size = 2048;
+	static constexpr uint32_t block_none = 0xffffffff;
+
+	File file { };
+	bmp_header_t header { };
+	uint32_t width_ { 0 };
+	uint32_t height_ { 0 };
+	uint32_t stride { 0 };
+	bool bottom_up { true };
+
+	std::array<uint8_t, block_size> block { };
+	uint32_t block_offset { block_none };
+	std::array<uint8_t, 3> straddle { };
+
+	const uint8_t* pixel(const uint32_t offset);
+	bool load_block(const uint32_t offset);
+};
@@ -22,6 +22,9 @@
 
 #include "io_wave.hpp"
 
+#include <algorithm>
+#include <memory>
+
 bool WAVFileReader::open(const std::filesystem::path& path) {
 	size_t i = 0;
 	char ch;
@@ -36,6 +39,8 @@ bool WAVFileReader::open(const std::filesystem::path& path) {
 		return true;
 	}
 	
+	stop_peaks();
+	
 	auto error = file.open(path);
 
 	if (!error.is_valid()) {
@@ -85,6 +90,10 @@ bool WAVFileReader::open(const std::filesystem::path& path) {
 	}
 }
 
+WAVFileReader::~WAVFileReader() {
+	stop_peaks();
+}
+
 void WAVFileReader::rewind() {
 	file.seek(data_start);
 }
@@ -130,6 +139,281 @@ uint16_t WAVFileReader::bits_per_sample() {
 	return header.fmt.wBitsPerSample;
 }
 
+std::filesystem::path WAVFileReader::peak_path(const std::filesystem::path& path) {
+	auto s = path.native();
+	const auto index = s.find_last_of(std::filesystem::path::preferred_separator);
+	s.insert((index == s.npos) ? 0 : index + 1, u".");
+	return std::filesystem::path { s }.replace_extension(u".PKS");
+}
+
+WAVFileReader::peak_header_t WAVFileReader::peak_source() {
+	const auto timestamp = file_created_date(last_path);
+	const auto samples = sample_count();
+	
+	return {
+		peak_magic,
+		(uint32_t)file.size(),
+		timestamp.FAT_date,
+		timestamp.FAT_time,
+		samples,
+		peak_level_count(samples)
+	};
+}
+
+uint32_t WAVFileReader::peak_level_blocks(const uint32_t sample_count, const size_t level) {
+	const auto block_samples_log2 = peak_block_samples_log2 + (level * peak_level_step_log2);
+	return ((uint64_t)sample_count + (1ULL << block_samples_log2) - 1) >> block_samples_log2;
+}
+
+uint32_t WAVFileReader::peak_level_offset(const uint32_t sample_count, const size_t level) {
+	uint32_t offset = sizeof(peak_header_t);
+	for (size_t l = 0; l < level; l++)
+		offset += peak_level_blocks(sample_count, l) * sizeof(wav_peak_t);
+	return offset;
+}
+
+uint32_t WAVFileReader::peak_level_count(const uint32_t sample_count) {
+	uint32_t count = 1;
+	while ((peak_level_blocks(sample_count, count - 1) > peak_overview_width) && (count < peak_levels_max))
+		count++;
+	return count;
+}
+
+void WAVFileReader::open_peaks() {
+	if (peak_thread || peaks_built)
+		return;
+	
+	if (open_peak_file()) {
+		peaks_built = true;
+		peaks_progress_ = 100;
+		return;
+	}
+	
+	peaks_progress_ = 0;
+	// Need significant stack for FATFS
+	peak_thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO - 1, WAVFileReader::peak_thread_fn, this);
+}
+
+void WAVFileReader::stop_peaks() {
+	if (peak_thread) {
+		chThdTerminate(peak_thread);
+		chThdWait(peak_thread);
+		peak_thread = nullptr;
+	}
+	peaks_built = false;
+	peak_file_open = false;
+}
+
+bool WAVFileReader::peaks_ready() {
+	if (!peaks_built)
+		return false;
+	
+	if (peak_thread) {
+		// Builder is done, free its stack
+		chThdWait(peak_thread);
+		peak_thread = nullptr;
+	}
+	
+	return peak_file_open || open_peak_file();
+}
+
+uint8_t WAVFileReader::peaks_progress() const {
+	return peaks_progress_;
+}
+
+bool WAVFileReader::open_peak_file() {
+	peak_file_open = false;
+	
+	if (peak_file.open(peak_path(last_path)).is_valid())
+		return false;
+	
+	const auto source = peak_source();
+	const auto read_size = peak_file.read(&peak_header, sizeof(peak_header));
+	if (read_size.is_error() || (read_size.value() != sizeof(peak_header)))
+		return false;
+	
+	if (memcmp(&peak_header, &source, sizeof(peak_header)))
+		return false;
+	
+	peak_file_open = true;
+	return true;
+}
+
+msg_t WAVFileReader::peak_thread_fn(void* arg) {
+	static_cast<WAVFileReader*>(arg)->build_peaks();
+	return 0;
+}
+
+/* Runs on its own thread with its own File handles, streams the WAV once.
+ * Each level accumulates 4 pairs of the level below and is written out by
+ * the sector. The header's magic is only written once everything else is,
+ * so an interrupted build is never used.
+ */
+void WAVFileReader::build_peaks() {
+	struct Level {
+		std::array<wav_peak_t, 64> buffer;
+		size_t buffered;
+		uint32_t written;
+		uint32_t offset;
+		int16_t min;
+		int16_t max;
+		uint32_t accumulated;
+	};
+	
+	const auto source_header = peak_source();
+	const uint32_t samples = source_header.sample_count;
+	const size_t levels_count = source_header.level_count;
+	
+	File source;
+	File out;
+	if (source.open(last_path).is_valid() || out.create(peak_path(last_path)).is_valid())
+		return;
+	
+	auto levels = std::make_unique<std::array<Level, peak_levels_max>>();
+	auto samples_buffer = std::make_unique<std::array<int16_t, 256>>();
+	
+	for (size_t l = 0; l < levels_count; l++) {
+		auto& level = (*levels)[l];
+		level.buffered = 0;
+		level.written = 0;
+		level.offset = peak_level_offset(samples, l);
+		level.min = INT16_MAX;
+		level.max = INT16_MIN;
+		level.accumulated = 0;
+	}
+	
+	peak_header_t header = source_header;
+	header.magic = 0;
+	out.write(&header, sizeof(header));
+	
+	auto flush = [&out](Level& level) {
+		out.seek(level.offset + (level.written * sizeof(wav_peak_t)));
+		out.write(level.buffer.data(), level.buffered * sizeof(wav_peak_t));
+		level.written += level.buffered;
+		level.buffered = 0;
+	};
+	
+	// Closes the accumulated span of level l, feeding the levels above.
+	auto emit = [&](size_t l) {
+		while (l < levels_count) {
+			auto& level = (*levels)[l];
+			level.buffer[level.buffered++] = { (int8_t)(level.min >> 8), (int8_t)(level.max >> 8) };
+			if (level.buffered == level.buffer.size())
+				flush(level);
+			
+			bool next_full = false;
+			if (l + 1 < levels_count) {
+				auto& next = (*levels)[l + 1];
+				next.min = std::min(next.min, level.min);
+				next.max = std::max(next.max, level.max);
+				next_full = (++next.accumulated == (1U << peak_level_step_log2));
+			}
+			
+			level.min = INT16_MAX;
+			level.max = INT16_MIN;
+			level.accumulated = 0;
+			
+			if (!next_full)
+				break;
+			l++;
+		}
+	};
+	
+	source.seek(data_start);
+	uint32_t done = 0;
+	while ((done < samples) && !chThdShouldTerminate()) {
+		const auto to_read = std::min<uint32_t>(samples - done, samples_buffer->size());
+		const auto read_size = source.read(samples_buffer->data(), to_read * sizeof(int16_t));
+		if (read_size.is_error() || (read_size.value() != to_read * sizeof(int16_t)))
+			return;
+		
+		auto& level = (*levels)[0];
+		for (size_t i = 0; i < to_read; i++) {
+			const auto sample = (*samples_buffer)[i];
+			level.min = std::min(level.min, sample);
+			level.max = std::max(level.max, sample);
+			if (++level.accumulated == (1U << peak_block_samples_log2))
+				emit(0);
+		}
+		
+		done += to_read;
+		peaks_progress_ = ((uint64_t)done * 100) / samples;
+	}
+	
+	if (done < samples)
+		return;
+	
+	// Partial spans at the end of each level
+	for (size_t l = 0; l < levels_count; l++) {
+		if ((*levels)[l].accumulated)
+			emit(l);
+		if ((*levels)[l].buffered)
+			flush((*levels)[l]);
+	}
+	
+	out.seek(0);
+	out.write(&source_header, sizeof(source_header));
+	out.sync();
+	
+	peaks_built = true;
+}
+
+bool WAVFileReader::read_peaks(
+	const uint64_t first_sample,
+	const uint32_t samples_per_column,
+	wav_peak_t* const dst,
+	const size_t columns
+) {
+	if (!peaks_ready() || !samples_per_column)
+		return false;
+	
+	// Coarsest level that still has at least one pair per column
+	const uint32_t samples = peak_header.sample_count;
+	size_t level = 0;
+	while ((level + 1 < peak_header.level_count) &&
+		((1UL << (peak_block_samples_log2 + (level + 1) * peak_level_step_log2)) <= samples_per_column))
+		level++;
+	
+	const auto block_samples_log2 = peak_block_samples_log2 + (level * peak_level_step_log2);
+	const auto blocks = peak_level_blocks(samples, level);
+	const auto offset = peak_level_offset(samples, level);
+	
+	// Columns cover increasing blocks, so read through a small window
+	std::array<wav_peak_t, 64> window;
+	uint32_t window_start = 0;
+	size_t window_count = 0;
+	
+	for (size_t c = 0; c < columns; c++) {
+		const uint64_t start = first_sample + ((uint64_t)c * samples_per_column);
+		const uint64_t end = start + samples_per_column;
+		const uint32_t b0 = start >> block_samples_log2;
+		const uint32_t b1 = std::min<uint64_t>(std::max<uint64_t>((end + (1ULL << block_samples_log2) - 1) >> block_samples_log2, b0 + 1), blocks);
+		
+		wav_peak_t peak { 0, 0 };
+		for (uint32_t b = b0; b < b1; b++) {
+			if ((b < window_start) || (b >= window_start + window_count)) {
+				window_start = b;
+				window_count = std::min<uint32_t>(window.size(), blocks - b);
+				peak_file.seek(offset + (b * sizeof(wav_peak_t)));
+				const auto read_size = peak_file.read(window.data(), window_count * sizeof(wav_peak_t));
+				if (read_size.is_error())
+					return false;
+			}
+			
+			const auto& p = window[b - window_start];
+			if (b == b0) {
+				peak = p;
+			} else {
+				peak.min = std::min(peak.min, p.min);
+				peak.max = std::max(peak.max, p.max);
+			}
+		}
+		dst[c] = peak;
+	}
+	
+	return true;
+}
+
 Optional<File::Error> WAVFileWriter::create(
 	const std::filesystem::path& filename,
 	size_t sampling_rate_set,
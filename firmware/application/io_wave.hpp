@@ -27,6 +27,8 @@
 #include "file.hpp"
 #include "optional.hpp"
 
+#include "ch.h"
+
 #include <string.h>
 
 struct fmt_pcm_t {
@@ -100,6 +102,12 @@ private:
 	char title[64] { 0 };
 };
 
+// High bytes of the smallest and largest sample in a span.
+struct wav_peak_t {
+	int8_t min;
+	int8_t max;
+};
+
 class WAVFileReader : public FileReader {
 public:
 	WAVFileReader() = default;
@@ -109,7 +117,7 @@ public:
 	WAVFileReader(WAVFileReader&&) = delete;
 	WAVFileReader& operator=(WAVFileReader&&) = delete;
 	
-	virtual ~WAVFileReader() = default;
+	virtual ~WAVFileReader();
 
 	bool open(const std::filesystem::path& path);
 	void data_seek(const uint64_t Offset);
@@ -123,7 +131,60 @@ public:
 	uint16_t bits_per_sample();
 	std::string title();
 	
+	/* Peak overview (16-bit mono only). open_peaks() uses the sidecar if it's
+	 * up to date, else builds it in the background. Until peaks_ready(),
+	 * read_peaks() fails and peaks_progress() gives the build percentage.
+	 */
+	void open_peaks();
+	bool peaks_ready();
+	uint8_t peaks_progress() const;
+	// One min/max per column of samples_per_column samples.
+	bool read_peaks(
+		const uint64_t first_sample,
+		const uint32_t samples_per_column,
+		wav_peak_t* const dst,
+		const size_t columns
+	);
+	
 private:
+	/* Sidecar ".<stem>.PKS" in the WAV's directory: header, then each level's
+	 * min/max pairs. Level 0 has one pair per 256 samples, each level above
+	 * covers 4 times more, up to the first level with <= 240 pairs.
+	 */
+	struct peak_header_t {
+		uint32_t magic;
+		uint32_t source_size;
+		uint16_t source_date;
+		uint16_t source_time;
+		uint32_t sample_count;
+		uint32_t level_count;
+	};
+
+	static constexpr uint32_t peak_magic = 0x314b5057;	// "WPK1"
+	static constexpr size_t peak_block_samples_log2 = 8;
+	static constexpr size_t peak_level_step_log2 = 2;
+	static constexpr size_t peak_levels_max = 12;
+	static constexpr size_t peak_overview_width = 240;
+
+	static std::filesystem::path peak_path(const std::filesystem::path& path);
+	peak_header_t peak_source();
+	static uint32_t peak_level_blocks(const uint32_t sample_count, const size_t level);
+	static uint32_t peak_level_offset(const uint32_t sample_count, const size_t level);
+	static uint32_t peak_level_count(const uint32_t sample_count);
+
+	File peak_file { };
+	bool peak_file_open { false };
+	peak_header_t peak_header { };
+	Thread* peak_thread { nullptr };
+	volatile bool peaks_built { false };
+	volatile uint8_t peaks_progress_ { 0 };
+
+	void stop_peaks();
+	bool open_peak_file();
+	void build_peaks();
+	static msg_t peak_thread_fn(void* arg);
+	
+
 	struct fmt_pcm_t {
 		uint8_t ckID[4];		// fmt 
 		uint32_t cksize;
@@ -191,6 +191,16 @@ void controls_init() {
 	gptStartContinuous(&GPTD1, timer0_match_count);
 }
 
+void controls_set_clock(const uint32_t clock_f) {
+	// Keep scanning at ui_interrupt_rate when the core clock changes.
+	timer0_config.pr = (clock_f / timer0_count_f) - 1;
+	/* Prescale counter only resets on matching PR, clear it in case it is
+	 * already past the new value.
+	 */
+	GPTD1.tmr->PR = timer0_config.pr;
+	GPTD1.tmr->PC = 0;
+}
+
 SwitchesState get_switches_state() {
 	SwitchesState result;
 	for(size_t i=0; i<result.size(); i++) {
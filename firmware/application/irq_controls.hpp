@@ -40,6 +40,7 @@ using SwitchesState = std::bitset<5>;
 using EncoderPosition = uint32_t;
 
 void controls_init();
+void controls_set_clock(const uint32_t clock_f);
 SwitchesState get_switches_state();
 EncoderPosition get_encoder_position();
 touch::Frame get_touch_frame();
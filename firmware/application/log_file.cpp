@@ -23,15 +23,132 @@
 
 #include "string_format.hpp"
 
-Optional<File::Error> LogFile::write_entry(const rtc::RTC& datetime, const std::string& entry) {
-	std::string timestamp = to_string_timestamp(datetime);
-	return write_line(timestamp + " " + entry);
+#include <algorithm>
+
+LogFile::~LogFile() {
+	if( thread ) {
+		// Writer flushes and syncs what's left on its way out.
+		chThdTerminate(thread);
+		chBSemSignal(&wakeup);
+		chThdWait(thread);
+		thread = nullptr;
+	}
 }
 
-Optional<File::Error> LogFile::write_line(const std::string& message) {
-	auto error = file.write_line(message);
-	if( !error.is_valid() ) {
-		file.sync();
+Optional<File::Error> LogFile::append(const std::filesystem::path& filename) {
+	const auto error = file.append(filename);
+	if( !error.is_valid() && !thread ) {
+		chBSemInit(&wakeup, true);
+		// Need significant stack for FATFS
+		thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO - 1, LogFile::static_fn, this);
 	}
 	return error;
 }
+
+Optional<File::Error> LogFile::write_entry(const rtc::RTC& datetime, const std::string& entry) {
+	if( !thread ) {
+		return { FR_INVALID_OBJECT };
+	}
+
+	const std::string timestamp = to_string_timestamp(datetime);
+	const size_t length = timestamp.size() + 1 + entry.size() + 2;
+
+	if( length > (ring_size - pending()) ) {
+		lines_dropped_++;
+	} else {
+		size_t position = head;
+		put(position, timestamp.data(), timestamp.size());
+		position += timestamp.size();
+		put(position++, " ", 1);
+		put(position, entry.data(), entry.size());
+		position += entry.size();
+		put(position, "\r\n", 2);
+
+		chSysLock();
+		head += length;
+		chSysUnlock();
+		lines_queued_++;
+
+		if( (durability == Durability::EveryLine) || (pending() >= flush_threshold) ) {
+			chBSemSignal(&wakeup);
+		}
+	}
+
+	if( error_code ) {
+		return { File::Error { error_code } };
+	}
+	return { };
+}
+
+void LogFile::put(size_t position, const char* data, const size_t length) {
+	for(size_t i=0; i<length; i++) {
+		ring[(position + i) % ring_size] = data[i];
+	}
+}
+
+size_t LogFile::pending() const {
+	chSysLock();
+	const size_t count = head - tail;
+	chSysUnlock();
+	return count;
+}
+
+bool LogFile::flush() {
+	bool written = false;
+
+	while( const size_t count = pending() ) {
+		// Up to the end of the ring, the rest on the next pass.
+		const size_t offset = tail % ring_size;
+		const size_t length = std::min(count, ring_size - offset);
+
+		const auto result = file.write(&ring[offset], length);
+		if( result.is_error() ) {
+			error_code = result.error().code();
+		}
+
+		chSysLock();
+		tail += length;
+		chSysUnlock();
+		written = true;
+	}
+
+	return written;
+}
+
+void LogFile::sync() {
+	const auto error = file.sync();
+	if( error.is_valid() ) {
+		error_code = error.value().code();
+	}
+}
+
+msg_t LogFile::static_fn(void* arg) {
+	auto obj = static_cast<LogFile*>(arg);
+	obj->run();
+	return 0;
+}
+
+void LogFile::run() {
+	systime_t last_sync = chTimeNow();
+	bool unsynced = false;
+
+	while( !chThdShouldTerminate() ) {
+		chBSemWaitTimeout(&wakeup, flush_interval);
+
+		if( flush() ) {
+			unsynced = true;
+		}
+
+		if( unsynced ) {
+			if( (durability == Durability::EveryLine) ||
+				((durability == Durability::Periodic) && ((chTimeNow() - last_sync) >= flush_interval)) ) {
+				sync();
+				last_sync = chTimeNow();
+				unsynced = false;
+			}
+		}
+	}
+
+	flush();
+	sync();
+}
@@ -23,24 +23,81 @@
 #define __LOG_FILE_H__
 
 #include <string>
+#include <array>
+
+#include "ch.h"
 
 #include "file.hpp"
 
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
+/* Lines are queued in a RAM ring and written out by a background thread, so
+ * decoders logging at high message rates never wait on the SD card. The
+ * writer wakes when a sector's worth is pending or every flush_interval, and
+ * syncs according to the durability policy. Lines that don't fit in the ring
+ * are dropped and counted.
+ */
 class LogFile {
 public:
-	Optional<File::Error> append(const std::filesystem::path& filename) {
-		return file.append(filename);
+	enum class Durability {
+		Lazy,		// Sync on close only
+		Periodic,	// Sync at most every flush_interval
+		EveryLine,	// Write and sync each line as soon as it's queued
+	};
+
+	LogFile(
+		const Durability durability = Durability::Periodic
+	) : durability { durability }
+	{
 	}
+	~LogFile();
+
+	LogFile(const LogFile&) = delete;
+	LogFile(LogFile&&) = delete;
+	LogFile& operator=(const LogFile&) = delete;
+	LogFile& operator=(LogFile&&) = delete;
 
+	Optional<File::Error> append(const std::filesystem::path& filename);
+
+	// Returns the last error the writer ran into, if any.
 	Optional<File::Error> write_entry(const rtc::RTC& datetime, const std::string& entry);
 
+	uint32_t lines_queued() const {
+		return lines_queued_;
+	}
+
+	uint32_t lines_dropped() const {
+		return lines_dropped_;
+	}
+
 private:
+	static constexpr size_t ring_size = 2048;
+	static constexpr size_t flush_threshold = 512;
+	static constexpr systime_t flush_interval = MS2ST(1000);
+
 	File file { };
+	const Durability durability;
+
+	// Free running positions, head advanced by the UI thread and tail by the writer.
+	std::array<char, ring_size> ring { };
+	volatile size_t head { 0 };
+	volatile size_t tail { 0 };
+
+	uint32_t lines_queued_ { 0 };
+	uint32_t lines_dropped_ { 0 };
+	volatile uint32_t error_code { 0 };
+
+	BinarySemaphore wakeup { };
+	Thread* thread { nullptr };
+
+	void put(size_t position, const char* data, const size_t length);
+	size_t pending() const;
+	bool flush();
+	void sync();
 
-	Optional<File::Error> write_line(const std::string& message);
+	static msg_t static_fn(void* arg);
+	void run();
 };
 
 #endif/*__LOG_FILE_H__*/
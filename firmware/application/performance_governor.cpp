@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "performance_governor.hpp"
+
+#include "portapack.hpp"
+#include "baseband_api.hpp"
+#include "irq_controls.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include "ch.h"
+
+#include <algorithm>
+
+void PerformanceGovernor::on_second_tick() {
+	/* ChibiOS charges each system tick to the running thread, so the idle
+	 * thread's share of ticks is what the application core has spare.
+	 */
+	const auto idle_thread = reinterpret_cast<const Thread*>(_idle_thread_wa);
+	const uint32_t idle_ticks = idle_thread->p_time;
+	const uint32_t system_ticks = chTimeNow();
+	const auto idle_delta = idle_ticks - idle_ticks_last;
+	const auto system_delta = system_ticks - system_ticks_last;
+	idle_ticks_last = idle_ticks;
+	system_ticks_last = system_ticks;
+
+	if( system_delta > 0 ) {
+		m0_load_ = 100 - std::min(idle_delta * 100 / system_delta, uint32_t { 100 });
+	}
+
+	// Frame sync may not run while the display sleeps.
+	poll_m4_load();
+	if( seconds_since_profile < profile_timeout ) {
+		seconds_since_profile++;
+	} else {
+		m4_load_ = 0;
+	}
+
+	update();
+}
+
+void PerformanceGovernor::poll_m4_load() {
+	const auto& load = shared_memory.processor_load;
+	const uint32_t sequence = load.sequence;
+	if( sequence == load_sequence_last ) {
+		return;
+	}
+	load_sequence_last = sequence;
+	seconds_since_profile = 0;
+
+	/* Busy is the whole of BasebandProcessor::execute(). Profiles cover
+	 * about a second of samples, but the DWT counter may not advance while the
+	 * M4 sleeps in WFI, so don't trust cycles_elapsed below a second's worth.
+	 */
+	const uint64_t cycles_busy = load.cycles_busy;
+	const uint64_t cycles_elapsed = std::max(static_cast<uint32_t>(load.cycles_elapsed), clock_f);
+	m4_load_ = static_cast<uint32_t>((cycles_busy * 100) / cycles_elapsed);
+
+	// Don't wait for the next second if the baseband is running out of cycles.
+	if( (level_ == Level::Low) && (m4_load_ >= load_high_min) ) {
+		set_level(Level::High);
+	}
+}
+
+void PerformanceGovernor::request(const Level level) {
+	if( level == Level::High ) {
+		high_requests++;
+	}
+	update();
+}
+
+void PerformanceGovernor::release(const Level level) {
+	if( (level == Level::High) && (high_requests > 0) ) {
+		high_requests--;
+	}
+}
+
+bool PerformanceGovernor::paint_frame() {
+	if( level_ == Level::High ) {
+		return true;
+	}
+	return (frame_count++ & 1) == 0;
+}
+
+void PerformanceGovernor::update() {
+	if( high_requests > 0 ) {
+		set_level(Level::High);
+		return;
+	}
+
+	if( level_ == Level::Low ) {
+		if( (m0_load_ >= load_high_min) || (m4_load_ >= load_high_min) ) {
+			set_level(Level::High);
+		}
+	} else {
+		if( (m0_load_ <= load_low_max) && (m4_load_ <= load_low_max) ) {
+			seconds_light++;
+			if( seconds_light >= settle_seconds ) {
+				set_level(Level::Low);
+			}
+		} else {
+			seconds_light = 0;
+		}
+	}
+}
+
+void PerformanceGovernor::set_level(const Level new_level) {
+	if( new_level == level_ ) {
+		return;
+	}
+
+	level_ = new_level;
+	seconds_light = 0;
+
+	clock_f = portapack::clock_manager.set_core_clock(
+		(level_ == Level::High) ? ClockManager::CoreClock::Full : ClockManager::CoreClock::Half
+	);
+	controls_set_clock(clock_f);
+	baseband::set_core_clock(clock_f);
+
+	// Loads measured at the previous clock don't apply any more.
+	m0_load_ = 0;
+	m4_load_ = 0;
+}
+
+PerformanceRequest::PerformanceRequest(
+	const PerformanceGovernor::Level level
+) : level { level }
+{
+	portapack::performance_governor.request(level);
+}
+
+PerformanceRequest::~PerformanceRequest() {
+	portapack::performance_governor.release(level);
+}
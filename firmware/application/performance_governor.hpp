@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2015 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __PERFORMANCE_GOVERNOR_H__
+#define __PERFORMANCE_GOVERNOR_H__
+
+#include "hackrf_hal.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+/* Chooses the core clock and display paint rate from the measured load of
+ * both cores. The baseband load comes from the once a second
+ * SharedMemory::processor_load (BasebandProcessor::execute() cycles), the
+ * application load from the idle thread's share of system ticks.
+ *
+ * Drops to Low after both cores have stayed light enough to run at half
+ * clock for a few seconds, returns to High as soon as either gets busy at
+ * Low, or while any view holds a PerformanceRequest for High.
+ */
+class PerformanceGovernor {
+public:
+	enum class Level : uint8_t {
+		Low = 0,	// Cores at half clock, display painted every other frame
+		High = 1,	// Cores at full clock, display painted every frame
+	};
+
+	void on_second_tick();
+
+	// Called every display frame, so an overloaded baseband upshifts quickly.
+	void poll_m4_load();
+
+	// Requested levels are a floor, the governor may still pick a higher one.
+	void request(const Level level);
+	void release(const Level level);
+
+	bool paint_frame();
+
+	Level level() const {
+		return level_;
+	}
+
+	// Percent of each core, as measured at the current level.
+	uint32_t m0_load() const {
+		return m0_load_;
+	}
+
+	uint32_t m4_load() const {
+		return m4_load_;
+	}
+
+private:
+	/* Load at High that still leaves margin at half clock, and load at Low
+	 * that calls for full clock. M4 load doesn't include the RSSI thread and
+	 * interrupts, hence the conservative low threshold.
+	 */
+	static constexpr uint32_t load_low_max = 35;
+	static constexpr uint32_t load_high_min = 80;
+	static constexpr uint32_t settle_seconds = 5;
+
+	// No profile for this long means no baseband is running.
+	static constexpr uint32_t profile_timeout = 3;
+
+	Level level_ { Level::High };
+	uint32_t clock_f { hackrf::one::base_m4_clk_f };
+	size_t high_requests { 0 };
+
+	uint32_t m0_load_ { 0 };
+	uint32_t m4_load_ { 0 };
+	uint32_t idle_ticks_last { 0 };
+	uint32_t system_ticks_last { 0 };
+	uint32_t load_sequence_last { 0 };
+	uint32_t seconds_since_profile { 0 };
+	uint32_t seconds_light { 0 };
+
+	uint32_t frame_count { 0 };
+
+	void update();
+	void set_level(const Level new_level);
+};
+
+/* Holds the governor at a minimum level for as long as it exists, e.g. as a
+ * view member, or while recording to SD card.
+ */
+class PerformanceRequest {
+public:
+	PerformanceRequest(
+		const PerformanceGovernor::Level level = PerformanceGovernor::Level::High
+	);
+	~PerformanceRequest();
+
+	PerformanceRequest(const PerformanceRequest&) = delete;
+	PerformanceRequest(PerformanceRequest&&) = delete;
+	PerformanceRequest& operator=(const PerformanceRequest&) = delete;
+	PerformanceRequest& operator=(PerformanceRequest&&) = delete;
+
+private:
+	const PerformanceGovernor::Level level;
+};
+
+#endif/*__PERFORMANCE_GOVERNOR_H__*/
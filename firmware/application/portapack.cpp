@@ -83,6 +83,7 @@ ReceiverModel receiver_model;
 TransmitterModel transmitter_model;
 
 TemperatureLogger temperature_logger;
+PerformanceGovernor performance_governor;
 
 bool antenna_bias { false };
 uint32_t bl_tick_counter { 0 };
@@ -35,6 +35,7 @@
 #include "radio.hpp"
 #include "clock_manager.hpp"
 #include "temperature_logger.hpp"
+#include "performance_governor.hpp"
 
 namespace portapack {
 
@@ -58,6 +59,7 @@ extern uint32_t bl_tick_counter;
 extern bool antenna_bias;
 
 extern TemperatureLogger temperature_logger;
+extern PerformanceGovernor performance_governor;
 
 void set_antenna_bias(const bool v);
 bool get_antenna_bias();
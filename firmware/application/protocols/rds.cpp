@@ -160,4 +160,164 @@ void gen_ClockTime(std::vector<RDSGroup>& frame, const RDS_flags * rds_flags,
 	frame.emplace_back(group);		
 }
 
+static char printable(const uint16_t c) {
+	return ((c >= 0x20) && (c < 0x7F)) ? c : ' ';
+}
+
+void GroupParser::reset() {
+	info_ = { };
+}
+
+bool GroupParser::parse(const ReceivedGroup& group) {
+	bool changed = false;
+
+	if( group.valid(0) ) {
+		if( !info_.PI_valid || (info_.PI_code != group.block[0]) ) {
+			// New station, forget everything else.
+			reset();
+			info_.PI_code = group.block[0];
+			info_.PI_valid = true;
+			changed = true;
+		}
+	}
+
+	// Everything else needs block B for group type
+	if( !group.valid(1) ) {
+		return changed;
+	}
+
+	info_.groups++;
+
+	const auto b = group.block[1];
+	const uint8_t group_type = b >> 12;
+	const bool version_b = (b >> 11) & 1;
+	const bool TP = (b >> 10) & 1;
+	const uint8_t PTY = (b >> 5) & 0x1F;
+	if( (TP != info_.TP) || (PTY != info_.PTY) ) {
+		info_.TP = TP;
+		info_.PTY = PTY;
+		changed = true;
+	}
+
+	switch(group_type) {
+	case 0:
+		changed |= parse_0(group, version_b);
+		break;
+
+	case 2:
+		changed |= parse_2(group, version_b);
+		break;
+
+	case 4:
+		if( !version_b ) {
+			changed |= parse_4A(group);
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return changed;
+}
+
+bool GroupParser::parse_0(const ReceivedGroup& group, const bool) {
+	const auto b = group.block[1];
+	info_.TA = (b >> 4) & 1;
+	info_.MS = (b >> 3) & 1;
+
+	if( !group.valid(3) ) {
+		return false;
+	}
+
+	// PS name, 2 characters per group in block D
+	const size_t segment = b & 3;
+	const auto d = group.block[3];
+	info_.PS[segment * 2 + 0] = printable(d >> 8);
+	info_.PS[segment * 2 + 1] = printable(d & 0xFF);
+	info_.PS_segments |= (1 << segment);
+	return true;
+}
+
+bool GroupParser::parse_2(const ReceivedGroup& group, const bool version_b) {
+	const auto b = group.block[1];
+	const bool AB = (b >> 4) & 1;
+	const size_t segment = b & 15;
+
+	if( !info_.RT_seen || (AB != info_.RT_AB) ) {
+		// First text group, or A/B flag toggle meaning a new message
+		info_.RT.fill(' ');
+		info_.RT_segments = 0;
+		info_.RT_length = version_b ? 32 : 64;
+		info_.RT_AB = AB;
+		info_.RT_seen = true;
+	}
+
+	std::array<uint16_t, 4> chars { };
+	size_t chars_count;
+	size_t position;
+	if( version_b ) {
+		// 2B: 2 characters in block D, 32 characters max
+		if( !group.valid(3) ) {
+			return false;
+		}
+		chars[0] = group.block[3] >> 8;
+		chars[1] = group.block[3] & 0xFF;
+		chars_count = 2;
+		position = segment * 2;
+	} else {
+		// 2A: 4 characters in blocks C and D, 64 characters max
+		if( !group.valid(2) || !group.valid(3) ) {
+			return false;
+		}
+		chars[0] = group.block[2] >> 8;
+		chars[1] = group.block[2] & 0xFF;
+		chars[2] = group.block[3] >> 8;
+		chars[3] = group.block[3] & 0xFF;
+		chars_count = 4;
+		position = segment * 4;
+	}
+
+	for(size_t i=0; i<chars_count; i++) {
+		if( chars[i] == 0x0D ) {
+			info_.RT_length = position + i;
+			break;
+		}
+		info_.RT[position + i] = printable(chars[i]);
+	}
+	info_.RT_segments |= (1 << segment);
+	return true;
+}
+
+bool GroupParser::parse_4A(const ReceivedGroup& group) {
+	if( !group.valid(2) || !group.valid(3) ) {
+		return false;
+	}
+
+	const uint32_t mjd = ((group.block[1] & 3) << 15) | (group.block[2] >> 1);
+	info_.hour = ((group.block[2] & 1) << 4) | (group.block[3] >> 12);
+	info_.minute = (group.block[3] >> 6) & 0x3F;
+	const int8_t offset = group.block[3] & 0x1F;
+	info_.local_offset = (group.block[3] & 0x20) ? -offset : offset;
+
+	// EN 50067 Annex G, MJD to date, in integer form
+	const uint32_t y_ = (mjd * 100 - 1507820) / 36525;
+	const uint32_t m_ = ((mjd - 14956 - (y_ * 1461) / 4) * 10000 - 1000) / 306001;
+	const uint32_t k = ((m_ == 14) || (m_ == 15)) ? 1 : 0;
+	info_.day = mjd - 14956 - (y_ * 1461) / 4 - (m_ * 306001) / 10000;
+	info_.month = m_ - 1 - k * 12;
+	info_.year = 1900 + y_ + k;
+
+	info_.CT_valid = (info_.hour < 24) && (info_.minute < 60) && (info_.month >= 1) && (info_.month <= 12);
+	return true;
+}
+
+std::string GroupParser::PS_name() const {
+	return std::string { info_.PS.data(), info_.PS.size() };
+}
+
+std::string GroupParser::radiotext() const {
+	return std::string { info_.RT.data(), std::min(info_.RT_length, info_.RT.size()) };
+}
+
 } /* namespace rds */
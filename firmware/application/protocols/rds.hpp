@@ -22,8 +22,11 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include "ch.h"
 
+#include "rds_packet.hpp"
+
 #ifndef __RDS_H__
 #define __RDS_H__
 
@@ -65,6 +68,62 @@ void gen_ClockTime(std::vector<RDSGroup>& frame, const RDS_flags * rds_flags,
 						const uint16_t year, const uint8_t month, const uint8_t day,
 						const uint8_t hour, const uint8_t minute, const int8_t local_offset);
 
+// Receive side
+
+struct StationInfo {
+	uint16_t PI_code { 0 };
+	bool PI_valid { false };
+	uint8_t PTY { 0 };
+	bool TP { false };
+	bool TA { false };
+	bool MS { false };
+
+	std::array<char, 8> PS { };
+	uint8_t PS_segments { 0 };		// Bitmask of received 2-char segments
+
+	std::array<char, 64> RT { };
+	uint16_t RT_segments { 0 };		// Bitmask of received segments
+	size_t RT_length { 64 };		// Shortened by a 0x0D terminator
+	bool RT_AB { false };
+	bool RT_seen { false };			// No 2A/2B group yet, RT_length not set
+
+	bool CT_valid { false };
+	uint16_t year { 0 };
+	uint8_t month { 0 };
+	uint8_t day { 0 };
+	uint8_t hour { 0 };				// UTC
+	uint8_t minute { 0 };
+	int8_t local_offset { 0 };		// Half hours
+
+	uint32_t groups { 0 };
+};
+
+class GroupParser {
+public:
+	// Returns true if any decoded field changed.
+	bool parse(const ReceivedGroup& group);
+
+	void reset();
+
+	const StationInfo& info() const {
+		return info_;
+	}
+
+	bool PS_complete() const {
+		return info_.PS_segments == 0x0F;
+	}
+
+	std::string PS_name() const;
+	std::string radiotext() const;
+
+private:
+	StationInfo info_ { };
+
+	bool parse_0(const ReceivedGroup& group, const bool version_b);
+	bool parse_2(const ReceivedGroup& group, const bool version_b);
+	bool parse_4A(const ReceivedGroup& group);
+};
+
 } /* namespace rds */
 
 #endif/*__RDS_H__*/
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "sstv_image.hpp"
+
+namespace sstv {
+
+bool ImageSource::open(const std::filesystem::path& path) {
+	decoded_lines = 0;
+	return reader.open(path);
+}
+
+void ImageSource::configure(const sstv_mode& mode) {
+	color_sequence = mode.color_sequence;
+	lines = mode.lines;
+	decoded_lines = 0;
+}
+
+void ImageSource::rewind() {
+	current_line = 0;
+	decoded_lines = 0;
+	fill();
+}
+
+const uint8_t* ImageSource::component(const size_t index) {
+	auto& line = ring[current_line & 1];
+	if( (decoded_lines <= current_line) || (line.number != current_line) ) {
+		// Read-ahead didn't keep up, decode now.
+		decode(current_line, line);
+		decoded_lines = current_line + 1;
+	}
+	return line.components[index].data();
+}
+
+void ImageSource::next_line() {
+	current_line++;
+	fill();
+}
+
+void ImageSource::fill() {
+	while( (decoded_lines <= (current_line + 1)) && (decoded_lines < lines) ) {
+		decode(decoded_lines, ring[decoded_lines & 1]);
+		decoded_lines++;
+	}
+}
+
+void ImageSource::decode(const uint32_t line_number, DecodedLine& line) {
+	line.number = line_number;
+	if( !reader.read_row((line_number * reader.height()) / lines, rgb.data(), width) ) {
+		rgb.fill(0);
+	}
+
+	for(size_t x=0; x<width; x++) {
+		const int32_t r = rgb[x * 3 + 0];
+		const int32_t g = rgb[x * 3 + 1];
+		const int32_t b = rgb[x * 3 + 2];
+
+		if( color_sequence == SSTV_COLOR_RGB ) {
+			line.components[0][x] = r;
+			line.components[1][x] = g;
+			line.components[2][x] = b;
+		} else if( color_sequence == SSTV_COLOR_GBR ) {
+			line.components[0][x] = g;
+			line.components[1][x] = b;
+			line.components[2][x] = r;
+		} else {
+			// ITU-R BT.601 Y, R-Y, B-Y
+			line.components[0][x] = 16 + ((66 * r + 129 * g + 25 * b + 128) >> 8);
+			line.components[1][x] = 128 + ((112 * r - 94 * g - 18 * b + 128) >> 8);
+			line.components[2][x] = 128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8);
+		}
+	}
+}
+
+bool ImageSource::read_preview_row(const uint32_t y, const uint32_t rows, uint8_t* const rgb, const size_t output_width) {
+	return reader.read_row((y * reader.height()) / rows, rgb, output_width);
+}
+
+} /* namespace sstv */
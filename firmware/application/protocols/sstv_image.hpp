@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SSTV_IMAGE_H__
+#define __SSTV_IMAGE_H__
+
+#include "io_bmp.hpp"
+#include "sstv.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace sstv {
+
+/* Feeds SSTV scanlines from a BMP, scaled to the mode's resolution.
+ * Each image line is decoded to the mode's three colour components in
+ * one go, one line ahead of the one being sent, so slow SD reads come out
+ * of the read-ahead instead of the line on air.
+ */
+class ImageSource {
+public:
+	static constexpr size_t width = sizeof(sstv_scanline::luma);
+
+	bool open(const std::filesystem::path& path);
+	void configure(const sstv_mode& mode);
+
+	// Starts over from the top and decodes the first lines.
+	void rewind();
+
+	// Component (0..2, in transmit order) of the current line.
+	const uint8_t* component(const size_t index);
+
+	// Done with the current line, move on and decode ahead.
+	void next_line();
+
+	uint32_t line() const {
+		return current_line;
+	}
+
+	// Preview, rows taken across the whole image.
+	bool read_preview_row(const uint32_t y, const uint32_t rows, uint8_t* const rgb, const size_t output_width);
+
+private:
+	struct DecodedLine {
+		uint32_t number;
+		std::array<std::array<uint8_t, width>, 3> components;
+	};
+
+	BMPFileReader reader { };
+	sstv_color_seq color_sequence { SSTV_COLOR_GBR };
+	uint32_t lines { 256 };
+
+	// Current line and the next one.
+	std::array<DecodedLine, 2> ring { };
+	uint32_t current_line { 0 };
+	uint32_t decoded_lines { 0 };
+
+	std::array<uint8_t, width * 3> rgb { };
+
+	void fill();
+	void decode(const uint32_t line_number, DecodedLine& line);
+};
+
+} /* namespace sstv */
+
+#endif/*__SSTV_IMAGE_H__*/
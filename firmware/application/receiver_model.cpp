@@ -51,8 +51,9 @@ static constexpr std::array<baseband::NBFMConfig, 3> nbfm_configs { {
 	{ taps_16k0_decim_0, taps_16k0_decim_1, taps_16k0_channel, 5000 },
 } };
 
-static constexpr std::array<baseband::WFMConfig, 1> wfm_configs { {
-	{ },
+static constexpr std::array<baseband::WFMConfig, 2> wfm_configs { {
+	{ false },
+	{ true },
 } };
 
 } /* namespace */
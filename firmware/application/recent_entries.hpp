@@ -27,21 +27,313 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <list>
+#include <array>
 #include <utility>
+#include <type_traits>
+#include <new>
 #include <functional>
 #include <iterator>
 #include <algorithm>
 
-template<class Entry>
-using RecentEntries = std::list<Entry>;
+/* Key hashing for the RecentEntries index. Integral, enum and pair keys are
+ * handled here, other key types provide a recent_entry_hash() overload that
+ * is found by argument dependent lookup.
+ */
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uint32_t>::type
+recent_entry_hash(const T value) {
+	const uint64_t v = static_cast<uint64_t>(value);
+	uint32_t h = static_cast<uint32_t>(v) ^ static_cast<uint32_t>(v >> 32);
+	// Murmur3 finalizer, so sequential IDs spread over the whole table.
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+template<typename A, typename B>
+uint32_t recent_entry_hash(const std::pair<A, B>& value) {
+	return (recent_entry_hash(value.first) * 0x9e3779b1) ^ recent_entry_hash(value.second);
+}
+
+/* Fixed capacity store for the recent entries tables. Entries are built in
+ * place in a node pool and chained in an intrusive list, most recent first.
+ * An open addressing hash index on Entry::key() makes lookup, moving an
+ * entry to the front and removal O(1), and nothing is allocated per entry.
+ * When full, adding an entry evicts the one at the back.
+ */
+template<class Entry, size_t Capacity = 64>
+class RecentEntries {
+	using index_t = uint8_t;
+	static constexpr index_t nil = 0xff;
+	static_assert(Capacity < nil, "RecentEntries node indices are 8 bits");
+
+	static constexpr size_t slot_count_for(const size_t n, const size_t count = 1) {
+		return (count >= n) ? count : slot_count_for(n, count * 2);
+	}
+	// Load factor <= 0.5 keeps linear probe chains short.
+	static constexpr size_t slot_count = slot_count_for(Capacity * 2);
+	static constexpr size_t slot_mask = slot_count - 1;
+
+	struct Node {
+		typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type storage;
+		index_t prev;
+		index_t next;
+
+		Entry& entry() { return *reinterpret_cast<Entry*>(&storage); }
+		const Entry& entry() const { return *reinterpret_cast<const Entry*>(&storage); }
+	};
+
+public:
+	using value_type = Entry;
+	using reference = Entry&;
+	using const_reference = const Entry&;
+	using Key = typename Entry::Key;
+
+	template<typename Store, typename Value>
+	class Iterator {
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = typename std::remove_const<Value>::type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Value*;
+		using reference = Value&;
+
+		Iterator(
+			Store* const store,
+			const index_t index
+		) : store { store },
+			index { index }
+		{
+		}
+
+		template<typename OtherStore, typename OtherValue>
+		Iterator(
+			const Iterator<OtherStore, OtherValue>& other
+		) : store { other.store },
+			index { other.index }
+		{
+		}
+
+		reference operator*() const { return store->nodes[index].entry(); }
+		pointer operator->() const { return &store->nodes[index].entry(); }
+
+		Iterator& operator++() {
+			index = store->nodes[index].next;
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			auto result = *this;
+			++(*this);
+			return result;
+		}
+
+		Iterator& operator--() {
+			index = (index == nil) ? store->tail : store->nodes[index].prev;
+			return *this;
+		}
+
+		Iterator operator--(int) {
+			auto result = *this;
+			--(*this);
+			return result;
+		}
+
+		bool operator==(const Iterator& other) const { return index == other.index; }
+		bool operator!=(const Iterator& other) const { return index != other.index; }
+
+	private:
+		template<typename, typename> friend class Iterator;
+		friend class RecentEntries;
+
+		Store* store;
+		index_t index;
+	};
+
+	using iterator = Iterator<RecentEntries, Entry>;
+	using const_iterator = Iterator<const RecentEntries, const Entry>;
+
+	RecentEntries() {
+		clear_index();
+	}
+
+	~RecentEntries() {
+		clear();
+	}
+
+	RecentEntries(const RecentEntries&) = delete;
+	RecentEntries& operator=(const RecentEntries&) = delete;
+
+	iterator begin() { return { this, head }; }
+	iterator end() { return { this, nil }; }
+	const_iterator begin() const { return { this, head }; }
+	const_iterator end() const { return { this, nil }; }
+
+	reference front() { return nodes[head].entry(); }
+	const_reference front() const { return nodes[head].entry(); }
+	reference back() { return nodes[tail].entry(); }
+	const_reference back() const { return nodes[tail].entry(); }
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	iterator find(const Key& key) {
+		const auto index = slots[slot_of(key)];
+		return { this, index };
+	}
+
+	const_iterator find(const Key& key) const {
+		const auto index = slots[slot_of(key)];
+		return { this, index };
+	}
+
+	// The key must not be present already.
+	reference emplace_front(const Key& key) {
+		if( count == Capacity ) {
+			pop_back();
+		}
+
+		const auto index = free_head;
+		free_head = nodes[index].next;
+		new (&nodes[index].storage) Entry(key);
+		count++;
+
+		link_front(index);
+		slots[slot_of(key)] = index;
+		return nodes[index].entry();
+	}
+
+	void move_to_front(const iterator it) {
+		if( it.index != head ) {
+			unlink(it.index);
+			link_front(it.index);
+		}
+	}
+
+	void erase(const iterator it) {
+		const auto index = it.index;
+		unindex(slot_of(nodes[index].entry().key()));
+		unlink(index);
+		nodes[index].entry().~Entry();
+		nodes[index].next = free_head;
+		free_head = index;
+		count--;
+	}
+
+	void pop_back() {
+		erase({ this, tail });
+	}
+
+	void clear() {
+		while( !empty() ) {
+			pop_back();
+		}
+		clear_index();
+	}
+
+	/* Stable insertion sort along the list. The tables are re-sorted as
+	 * entries age, so the list is nearly in order and this is close to O(n).
+	 */
+	template<typename Compare>
+	void sort(Compare compare) {
+		if( head == nil ) {
+			return;
+		}
+
+		auto index = nodes[head].next;
+		while( index != nil ) {
+			const auto next = nodes[index].next;
+			auto before = nodes[index].prev;
+			while( (before != nil) && compare(nodes[index].entry(), nodes[before].entry()) ) {
+				before = nodes[before].prev;
+			}
+			if( before != nodes[index].prev ) {
+				unlink(index);
+				link_after(before, index);
+			}
+			index = next;
+		}
+	}
+
+private:
+	std::array<Node, Capacity> nodes;
+	std::array<index_t, slot_count> slots;
+	index_t head { nil };
+	index_t tail { nil };
+	index_t free_head { 0 };
+	size_t count { 0 };
+
+	void clear_index() {
+		slots.fill(nil);
+		for(size_t i=0; i<Capacity; i++) {
+			nodes[i].next = (i + 1 < Capacity) ? (i + 1) : nil;
+		}
+		free_head = 0;
+		head = nil;
+		tail = nil;
+	}
+
+	static size_t home_slot(const Key& key) {
+		return recent_entry_hash(key) & slot_mask;
+	}
+
+	// Slot holding key, or the empty slot where it would go.
+	size_t slot_of(const Key& key) const {
+		auto slot = home_slot(key);
+		while( (slots[slot] != nil) && !(nodes[slots[slot]].entry().key() == key) ) {
+			slot = (slot + 1) & slot_mask;
+		}
+		return slot;
+	}
+
+	// Backward shift deletion, so no tombstones build up.
+	void unindex(size_t hole) {
+		slots[hole] = nil;
+		auto slot = hole;
+		while( true ) {
+			slot = (slot + 1) & slot_mask;
+			if( slots[slot] == nil ) {
+				break;
+			}
+			const auto home = home_slot(nodes[slots[slot]].entry().key());
+			const bool movable = (hole <= slot)
+				? ((home <= hole) || (home > slot))
+				: ((home <= hole) && (home > slot));
+			if( movable ) {
+				slots[hole] = slots[slot];
+				slots[slot] = nil;
+				hole = slot;
+			}
+		}
+	}
+
+	void unlink(const index_t index) {
+		const auto prev = nodes[index].prev;
+		const auto next = nodes[index].next;
+		if( prev != nil ) { nodes[prev].next = next; } else { head = next; }
+		if( next != nil ) { nodes[next].prev = prev; } else { tail = prev; }
+	}
+
+	// Inserts index after node "after", or at the front if after is nil.
+	void link_after(const index_t after, const index_t index) {
+		const auto next = (after == nil) ? head : nodes[after].next;
+		nodes[index].prev = after;
+		nodes[index].next = next;
+		if( after != nil ) { nodes[after].next = index; } else { head = index; }
+		if( next != nil ) { nodes[next].prev = index; } else { tail = index; }
+	}
+
+	void link_front(const index_t index) {
+		link_after(nil, index);
+	}
+};
 
 template<typename ContainerType, typename Key>
 typename ContainerType::const_iterator find(const ContainerType& entries, const Key key) {
-	return std::find_if(
-		std::begin(entries), std::end(entries),
-		[key](typename ContainerType::const_reference e) { return e.key() == key; }
-	);
+	return entries.find(key);
 }
 
 template<typename ContainerType>
@@ -53,14 +345,12 @@ static void truncate_entries(ContainerType& entries, const size_t entries_max =
 
 template<typename ContainerType, typename Key>
 typename ContainerType::reference on_packet(ContainerType& entries, const Key key) {
-	auto matching_recent = find(entries, key);
+	auto matching_recent = entries.find(key);
 	if( matching_recent != std::end(entries) ) {
-		// Found within. Move to front of list, increment counter.
-		entries.push_front(*matching_recent);
-		entries.erase(matching_recent);
+		// Found within. Move to front of list.
+		entries.move_to_front(matching_recent);
 	} else {
 		entries.emplace_front(key);
-		truncate_entries(entries);
 	}
 
 	return entries.front();
@@ -25,6 +25,8 @@
 #include "baseband_api.hpp"
 #include "buffer_exchange.hpp"
 
+#include <cstring>
+
 struct BasebandReplay {
 	BasebandReplay(ReplayConfig* const config) {
 		baseband::replay_start(config);
@@ -42,8 +44,10 @@ ReplayThread::ReplayThread(
 	size_t read_size,
 	size_t buffer_count,
 	bool* ready_signal,
-	std::function<void(uint32_t return_code)> terminate_callback
-) : config { read_size, buffer_count },
+	std::function<void(uint32_t return_code)> terminate_callback,
+	const iq::Format format,
+	const uint32_t sample_rate
+) : config { read_size, buffer_count, format, sample_rate },
 	reader { std::move(reader) },
 	ready_sig { ready_signal },
 	terminate_callback { std::move(terminate_callback) }
@@ -69,6 +73,15 @@ msg_t ReplayThread::static_fn(void* arg) {
 	return 0;
 }
 
+// StreamBuffer reads are aligned to the end of the buffer, so a short read
+// at the end of the file is padded out with silence.
+static void pad_buffer(StreamBuffer* const buffer, const size_t length) {
+	if( length < buffer->capacity() ) {
+		memset(&static_cast<uint8_t*>(buffer->data())[length], 0, buffer->capacity() - length);
+	}
+	buffer->set_size(buffer->capacity());
+}
+
 uint32_t ReplayThread::run() {
 	BasebandReplay replay { &config };
 	BufferExchange buffers { &config };
@@ -88,16 +101,12 @@ uint32_t ReplayThread::run() {
 		if (prefill_buffer == nullptr) {
 			buffers.put_app(prefill_buffer);
 		} else {
-			size_t blocks = config.read_size / 512;
-			
-			for (size_t c = 0; c < blocks; c++) {
-				auto read_result = reader->read(&((uint8_t*)prefill_buffer->data())[c * 512], 512);
-				if( read_result.is_error() ) {
-					return READ_ERROR;
-				}
+			auto read_result = reader->read(prefill_buffer->data(), config.read_size);
+			if( read_result.is_error() ) {
+				return READ_ERROR;
 			}
 			
-			prefill_buffer->set_size(config.read_size);
+			pad_buffer(prefill_buffer, read_result.value());
 			
 			buffers.put(prefill_buffer);
 		}
@@ -117,7 +126,7 @@ uint32_t ReplayThread::run() {
 			}
 		}
 		
-		buffer->set_size(buffer->capacity());
+		pad_buffer(buffer, read_result.value());
 		
 		buffers.put(buffer);
 	}
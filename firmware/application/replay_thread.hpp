@@ -41,7 +41,9 @@ public:
 		size_t read_size,
 		size_t buffer_count,
 		bool* ready_signal,
-		std::function<void(uint32_t return_code)> terminate_callback
+		std::function<void(uint32_t return_code)> terminate_callback,
+		const iq::Format format = iq::Format::C16,
+		const uint32_t sample_rate = 0
 	);
 	~ReplayThread();
 
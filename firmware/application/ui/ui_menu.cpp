@@ -165,6 +165,16 @@ void MenuView::clear() {
 	menu_items.clear();
 }
 
+/* For long lists paged through the menu: the items were replaced by a window
+ * moved delta entries further down the list, keep the same entries on screen.
+ */
+void MenuView::shift_items(const int32_t delta) {
+	highlighted_item = (int32_t)highlighted_item - delta;
+	offset = (int32_t)offset - delta;
+	
+	update_items();
+}
+
 void MenuView::add_item(MenuItem new_item) {
 	menu_items.push_back(new_item);
 	
@@ -187,7 +197,7 @@ void MenuView::update_items() {
 		more = false;
 	
 	for (auto item : menu_item_views) {
-		if (i >= menu_items.size()) break;
+		if (i + offset >= menu_items.size()) break;
 		
 		// Assign item data to MenuItemViews according to offset
 		item->set_item(&menu_items[i + offset]);
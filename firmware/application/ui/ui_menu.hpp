@@ -83,6 +83,7 @@ public:
 	void add_item(MenuItem new_item);
 	void add_items(std::initializer_list<MenuItem> new_items);
 	void clear();
+	void shift_items(const int32_t delta);
 	
 	MenuItemView* item_view(size_t index) const;
 
@@ -146,11 +146,12 @@ private:
 	const Rect audio_spectrum_view_rect { 0 * 8, 0 * 16, 30 * 8, 2 * 16 + 20 };
 	static constexpr Dim audio_spectrum_height = 16 * 2 + 20;
 	static constexpr Dim scale_height = 20;
+	static constexpr uint32_t spectrum_rate = 60;
 	
 	WaterfallView waterfall_view { };
 	FrequencyScale frequency_scale { };
 	
-	ChannelSpectrumFIFO* channel_fifo { nullptr };
+	ChannelSpectrumExchange* channel_exchange { nullptr };
 	AudioSpectrum* audio_spectrum_data { nullptr };
 	bool audio_spectrum_update { false };
 	
@@ -165,7 +166,9 @@ private:
 		Message::ID::ChannelSpectrumConfig,
 		[this](const Message* const p) {
 			const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
-			this->channel_fifo = message.fifo;
+			this->channel_exchange = message.exchange;
+			// One waterfall line per display frame, don't have the baseband compute more.
+			this->channel_exchange->set_requested_rate(spectrum_rate);
 		}
 	};
 	MessageHandlerRegistration message_handler_audio_spectrum {
@@ -179,10 +182,10 @@ private:
 	MessageHandlerRegistration message_handler_frame_sync {
 		Message::ID::DisplayFrameSync,
 		[this](const Message* const) {
-			if( this->channel_fifo ) {
-				ChannelSpectrum channel_spectrum;
-				while( channel_fifo->out(channel_spectrum) ) {
-					this->on_channel_spectrum(channel_spectrum);
+			if( this->channel_exchange ) {
+				const auto channel_spectrum = channel_exchange->read();
+				if( channel_spectrum ) {
+					this->on_channel_spectrum(*channel_spectrum);
 				}
 			}
 			if (this->audio_spectrum_update) {
@@ -42,29 +42,17 @@ public:
 	
 	void paint(Painter& painter) override;
 	
-	void on_audio_spectrum(const AudioSpectrum* spectrum);
+	void on_video_line(const VideoLine& line);
 	
 private:
 	static constexpr int cursor_band_height = 4;
 	
-	int16_t audio_spectrum[128] { 0 };
-	
-	/*Labels labels {
-		{ { 6 * 8, 0 * 16 }, "Hz", Color::light_grey() }
-	};*/
-	/*
-	NumberField field_frequency {
-		{ 0 * 8, 0 * 16 },
-		5,
-		{ 0, 48000 },
-		48000 / 240,
-		' '
-	};*/
+	int16_t line_samples[VideoLine::samples_per_line] { 0 };
 	
 	Waveform waveform {
 		{ 0, 1 * 16 + cursor_band_height, 30 * 8, 2 * 16 },
-		audio_spectrum,
-		128,
+		line_samples,
+		VideoLine::samples_per_line,
 		0,
 		false,
 		Color::white()
@@ -74,18 +62,15 @@ private:
 class TVView : public Widget {
 public:
 	void on_show() override;
-	void on_hide() override;
 
 	void paint(Painter& painter) override;
-	void on_channel_spectrum(const ChannelSpectrum& spectrum);
-	void on_adjust_xcorr(uint8_t xcorr);
-	//ui::Color video_buffer[13312];
-        uint8_t video_buffer_int[13312+128] { 0 }; //128 is for the over length caused by x_correction
-	uint32_t count=0;
-        uint8_t x_correction=0;
+	void on_video_line(const VideoLine& line);
+
 private:
+	// Active part of each line, doubled horizontally.
+	static constexpr Dim pixels_per_line = VideoLine::active_samples * 2;
+
 	void clear();
-	
 };
 
 class TVWidget : public View {
@@ -107,67 +92,48 @@ public:
 	void show_audio_spectrum_view(const bool show);
 
 	void paint(Painter& painter) override;
-	NumberField field_xcorr {
-		{ 0 * 8, 0 * 16 },
-		5,
-		{ 0, 128 },
-		1,
-		' '
-	};
 
 private:
 	void update_widgets_rect();
 	
+	// Line shown on the time scope, mid-picture.
+	static constexpr uint16_t scope_line_number = 160;
+
 	const Rect audio_spectrum_view_rect { 0 * 8, 0 * 16, 30 * 8, 2 * 16 + 20 };
 	static constexpr Dim audio_spectrum_height = 16 * 2 + 20;
 	static constexpr Dim scale_height = 20;
 	
 	TVView tv_view { };
 
-	ChannelSpectrumFIFO* channel_fifo { nullptr };
-	AudioSpectrum* audio_spectrum_data { nullptr };
-	bool audio_spectrum_update { false };
+	// Placed in the scale strip above the picture.
+	Text text_sync {
+		{ 0 * 8, 0 * 16, 6 * 8, 16 },
+		"-"
+	};
+	bool sync_locked { false };
+
+	VideoLineFIFO* video_fifo { nullptr };
 	
 	std::unique_ptr<TimeScopeView> audio_spectrum_view { };
 	
-	int sampling_rate { 0 };
-	int32_t cursor_position { 0 };
 	ui::Rect tv_normal_rect { };
 	ui::Rect tv_reduced_rect { };
 
-	MessageHandlerRegistration message_handler_channel_spectrum_config {
-		Message::ID::ChannelSpectrumConfig,
-		[this](const Message* const p) {
-			const auto message = *reinterpret_cast<const ChannelSpectrumConfigMessage*>(p);
-			this->channel_fifo = message.fifo;
-		}
-	};
-	MessageHandlerRegistration message_handler_audio_spectrum {
-		Message::ID::AudioSpectrum,
+	MessageHandlerRegistration message_handler_video_line_config {
+		Message::ID::VideoLineConfig,
 		[this](const Message* const p) {
-			const auto message = *reinterpret_cast<const AudioSpectrumMessage*>(p);
-			this->audio_spectrum_data = message.data;
-			this->audio_spectrum_update = true;
+			const auto message = *reinterpret_cast<const VideoLineConfigMessage*>(p);
+			this->video_fifo = message.fifo;
 		}
 	};
 	MessageHandlerRegistration message_handler_frame_sync {
 		Message::ID::DisplayFrameSync,
 		[this](const Message* const) {
-			if( this->channel_fifo ) {
-				ChannelSpectrum channel_spectrum;
-				while( channel_fifo->out(channel_spectrum) ) {
-					this->on_channel_spectrum(channel_spectrum);
-				}
-			}
-			if (this->audio_spectrum_update) {
-				this->audio_spectrum_update = false;
-				this->on_audio_spectrum();
-			}
+			this->on_frame_sync();
 		}
 	};
 
-	void on_channel_spectrum(const ChannelSpectrum& spectrum);
-	void on_audio_spectrum();
+	void on_frame_sync();
 };
 
 } /* namespace tv */
@@ -28,6 +28,37 @@
 using namespace hackrf::one;
 
 #include "string_format.hpp"
+#include "portapack_shared_memory.hpp"
+
+/* ProcessorProfileLogger ************************************************/
+
+Optional<File::Error> ProcessorProfileLogger::create(const std::filesystem::path& filename) {
+	auto error = file.create(filename);
+	if( !error.is_valid() ) {
+		error = file.write_line("time,stage,calls,min,mean,max,load_permille");
+	}
+	return error;
+}
+
+void ProcessorProfileLogger::log(const ProcessorProfile& profile) {
+	rtc::RTC datetime;
+	rtcGetTime(&RTCD1, &datetime);
+	const auto timestamp = to_string_timestamp(datetime);
+
+	for(size_t i=0; i<profile.stage_count; i++) {
+		const auto& stage = profile.stages[i];
+		const uint32_t load_permille = profile.cycles_elapsed ? (uint64_t(stage.cycles_total) * 1000 / profile.cycles_elapsed) : 0;
+		file.write_line(
+			timestamp + "," + stage.name.data() +
+			"," + to_string_dec_uint(stage.calls) +
+			"," + to_string_dec_uint(stage.cycles_min) +
+			"," + to_string_dec_uint(stage.cycles_mean()) +
+			"," + to_string_dec_uint(stage.cycles_max) +
+			"," + to_string_dec_uint(load_permille)
+		);
+	}
+	file.sync();
+}
 
 namespace ui {
 
@@ -59,4 +90,60 @@ void BasebandStatsView::on_statistics_update(const BasebandStatistics& statistic
 	text_stats.set(message);
 }
 
+/* ProcessorProfileView **************************************************/
+
+ProcessorProfileView::ProcessorProfileView() {
+	for(size_t i=0; i<text_stages.size(); i++) {
+		text_stages[i].set_parent_rect({ 0 * 8, static_cast<Coord>((i + 1) * 16), 30 * 8, 1 * 16 });
+		add_child(&text_stages[i]);
+	}
+
+	add_children({
+		&text_header,
+		&check_log,
+	});
+
+	check_log.on_select = [this](Checkbox&, bool v) {
+		if( v ) {
+			logger = std::make_unique<ProcessorProfileLogger>();
+			if( logger->create(next_filename_stem_matching_pattern(u"PROFILE_????").replace_extension(u".CSV")).is_valid() ) {
+				logger.reset();
+			}
+		} else {
+			logger.reset();
+		}
+	};
+}
+
+void ProcessorProfileView::on_show() {
+	shared_memory.processor_profile_requested = true;
+}
+
+void ProcessorProfileView::on_hide() {
+	shared_memory.processor_profile_requested = false;
+}
+
+void ProcessorProfileView::on_profile_update(const ProcessorProfile& profile) {
+	for(size_t i=0; i<text_stages.size(); i++) {
+		if( i >= profile.stage_count ) {
+			text_stages[i].set("");
+			continue;
+		}
+
+		const auto& stage = profile.stages[i];
+		const uint32_t load_x10 = profile.cycles_elapsed ? (uint64_t(stage.cycles_total) * 1000 / profile.cycles_elapsed) : 0;
+		const uint32_t load_x10_clipped = std::min(load_x10, static_cast<uint32_t>(999));
+		text_stages[i].set(
+			std::string { stage.name.data() } + std::string(ProcessorProfile::name_length - strlen(stage.name.data()), ' ') +
+			" " + to_string_dec_uint(stage.cycles_mean(), 8) +
+			" " + to_string_dec_uint(stage.cycles_max, 7) +
+			" " + to_string_dec_uint(load_x10_clipped / 10, 2) + "." + to_string_dec_uint(load_x10_clipped % 10, 1)
+		);
+	}
+
+	if( logger ) {
+		logger->log(profile);
+	}
+}
+
 } /* namespace ui */
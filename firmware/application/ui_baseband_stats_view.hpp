@@ -27,6 +27,20 @@
 #include "event_m0.hpp"
 
 #include "message.hpp"
+#include "file.hpp"
+
+#include <array>
+#include <memory>
+
+class ProcessorProfileLogger {
+public:
+	Optional<File::Error> create(const std::filesystem::path& filename);
+
+	void log(const ProcessorProfile& profile);
+
+private:
+	File file { };
+};
 
 namespace ui {
 
@@ -50,6 +64,44 @@ private:
 	void on_statistics_update(const BasebandStatistics& statistics);
 };
 
+/* Per-stage cycle counts of the running baseband processor, see
+ * CycleProfiler. Mean and max are cycles per call, load is the share of the
+ * M4 the stage used over the last second.
+ */
+class ProcessorProfileView : public View {
+public:
+	ProcessorProfileView();
+
+	// The baseband only queues full profiles while this view is showing.
+	void on_show() override;
+	void on_hide() override;
+
+private:
+	Text text_header {
+		{ 0 * 8, 0 * 16, 30 * 8, 1 * 16 },
+		"Stage       mean     max load",
+	};
+
+	std::array<Text, ProcessorProfile::stages_max> text_stages { };
+
+	Checkbox check_log {
+		{ 0 * 8, (ProcessorProfile::stages_max + 1) * 16 + 4 },
+		11,
+		"Log PROFILE"
+	};
+
+	std::unique_ptr<ProcessorProfileLogger> logger { };
+
+	MessageHandlerRegistration message_handler_profile {
+		Message::ID::ProcessorProfile,
+		[this](const Message* const p) {
+			this->on_profile_update(static_cast<const ProcessorProfileMessage*>(p)->profile);
+		}
+	};
+
+	void on_profile_update(const ProcessorProfile& profile);
+};
+
 } /* namespace ui */
 
 #endif/*__UI_BASEBAND_STATS_VIEW_H__*/
@@ -36,6 +36,14 @@ using namespace portapack;
 
 namespace ui {
 
+static iq::Format raw_format(const RecordView::FileType file_type) {
+	switch(file_type) {
+	case RecordView::FileType::RawS8:			return iq::Format::C8;
+	case RecordView::FileType::RawBlockFloat:	return iq::Format::BlockFloat;
+	default:									return iq::Format::C16;
+	}
+}
+
 /*void RecordView::toggle_pitch_rssi() {
 	pitch_rssi_enabled = !pitch_rssi_enabled;
 	
@@ -127,6 +135,14 @@ void RecordView::set_sampling_rate(const size_t new_sampling_rate) {
 	}
 }
 
+void RecordView::set_file_type(const FileType new_file_type) {
+	if( new_file_type != file_type ) {
+		stop();
+		file_type = new_file_type;
+		update_status_display();
+	}
+}
+
 // Setter for datetime and frequency filename
 void RecordView::set_filename_date_frequency(bool set) {
 	filename_date_frequency = set;
@@ -194,7 +210,9 @@ void RecordView::start() {
 		}
 		break;
 
+	case FileType::RawS8:
 	case FileType::RawS16:
+	case FileType::RawBlockFloat:
 		{
 			const auto metadata_file_error = write_metadata_file(base_path.replace_extension(u".TXT"));
 			if( metadata_file_error.is_valid() ) {
@@ -203,7 +221,7 @@ void RecordView::start() {
 			}
 
 			auto p = std::make_unique<RawFileWriter>();
-			auto create_error = p->create(base_path.replace_extension(u".C16"));
+			auto create_error = p->create(base_path.replace_extension(std::string(".") + iq::name(raw_format(file_type))));
 			if( create_error.is_valid() ) {
 				handle_error(create_error.value());
 			} else {
@@ -219,6 +237,7 @@ void RecordView::start() {
 	if( writer ) {
 		text_record_filename.set(base_path.replace_extension().string());
 		button_record.set_bitmap(&bitmap_stop);
+		performance_request = std::make_unique<PerformanceRequest>();
 		capture_thread = std::make_unique<CaptureThread>(
 			std::move(writer),
 			write_size, buffer_count,
@@ -229,7 +248,8 @@ void RecordView::start() {
 			[](File::Error error) {
 				CaptureThreadDoneMessage message { error.code() };
 				EventDispatcher::send_message(message);
-			}
+			},
+			raw_format(file_type)
 		);
 	}
 
@@ -244,6 +264,7 @@ void RecordView::on_hide() {
 void RecordView::stop() {
 	if( is_active() ) {
 		capture_thread.reset();
+		performance_request.reset();
 		button_record.set_bitmap(&bitmap_record);
 	}
 
@@ -264,6 +285,10 @@ Optional<File::Error> RecordView::write_metadata_file(const std::filesystem::pat
 		if( error_line2.is_valid() ) {
 			return error_line2;
 		}
+		const auto error_line3 = file.write_line(std::string("format=") + iq::name(raw_format(file_type)));
+		if( error_line3.is_valid() ) {
+			return error_line3;
+		}
 		return { };
 	}
 }
@@ -285,7 +310,7 @@ void RecordView::update_status_display() {
 
 	if( sampling_rate ) {
 		const auto space_info = std::filesystem::space(u"");
-		const uint32_t bytes_per_second = file_type == FileType::WAV ? (sampling_rate * 2) : (sampling_rate / 8 * 4);
+		const uint32_t bytes_per_second = file_type == FileType::WAV ? (sampling_rate * 2) : iq::encoded_size(raw_format(file_type), sampling_rate / 8);
 		const uint32_t available_seconds = space_info.free / bytes_per_second;
 		const uint32_t seconds = available_seconds % 60;
 		const uint32_t available_minutes = available_seconds / 60;
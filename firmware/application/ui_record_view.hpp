@@ -26,6 +26,7 @@
 
 #include "capture_thread.hpp"
 #include "signal.hpp"
+#include "performance_governor.hpp"
 
 #include "bitmap.hpp"
 
@@ -40,8 +41,10 @@ public:
 	std::function<void(std::string)> on_error { };
 
 	enum FileType {
+		RawS8 = 1,
 		RawS16 = 2,
 		WAV = 3,
+		RawBlockFloat = 4,
 	};
 
 	RecordView(
@@ -56,6 +59,7 @@ public:
 	void focus() override;
 
 	void set_sampling_rate(const size_t new_sampling_rate);
+	void set_file_type(const FileType new_file_type);
 
 	void start();
 	void stop();
@@ -83,7 +87,7 @@ private:
     rtc::RTC datetime { };
 
 	const std::filesystem::path filename_stem_pattern;
-	const FileType file_type;
+	FileType file_type;
 	const size_t write_size;
 	const size_t buffer_count;
 	size_t sampling_rate { 0 };
@@ -124,6 +128,8 @@ private:
 	};
 
 	std::unique_ptr<CaptureThread> capture_thread { };
+	// Writing to SD card is mostly application core work the governor doesn't see.
+	std::unique_ptr<PerformanceRequest> performance_request { };
 
 	MessageHandlerRegistration message_handler_capture_thread_error {
 		Message::ID::CaptureThreadDone,
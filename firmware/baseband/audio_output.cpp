@@ -45,6 +45,8 @@ void AudioOutput::configure(
 ) {
 	hpf.configure(hpf_config);
 	deemph.configure(deemph_config);
+	hpf_difference.configure(hpf_config);
+	deemph_difference.configure(deemph_config);
 	squelch.set_threshold(squelch_threshold);
 }
 
@@ -73,14 +75,44 @@ void AudioOutput::write(
 	);
 }
 
+void AudioOutput::write(
+	const buffer_s16_t& audio,
+	const buffer_s16_t& difference
+) {
+	std::array<float, 32> audio_f;
+	std::array<float, 32> difference_f;
+	for(size_t i=0; i<audio.count; i++) {
+		audio_f[i] = audio.p[i] * ki;
+		difference_f[i] = difference.p[i] * ki;
+	}
+	const buffer_f32_t difference_buffer {
+		difference_f.data(),
+		difference.count,
+		difference.sampling_rate
+	};
+	on_block(buffer_f32_t {
+			audio_f.data(),
+			audio.count,
+			audio.sampling_rate
+		},
+		&difference_buffer
+	);
+}
+
 void AudioOutput::on_block(
-	const buffer_f32_t& audio
+	const buffer_f32_t& audio,
+	const buffer_f32_t* const difference
 ) {
 	if (do_processing) {
 		const auto audio_present_now = squelch.execute(audio);
 
 		hpf.execute_in_place(audio);
 		deemph.execute_in_place(audio);
+		if( difference ) {
+			// Filters are linear, so de-emphasizing L+R and L-R equals doing L and R.
+			hpf_difference.execute_in_place(*difference);
+			deemph_difference.execute_in_place(*difference);
+		}
 
 		audio_present_history = (audio_present_history << 1) | (audio_present_now ? 1 : 0);
 		audio_present = (audio_present_history != 0);
@@ -89,25 +121,36 @@ void AudioOutput::on_block(
 			for(size_t i=0; i<audio.count; i++) {
 				audio.p[i] = 0;
 			}
+			if( difference ) {
+				for(size_t i=0; i<difference->count; i++) {
+					difference->p[i] = 0;
+				}
+			}
 		}
 	} else
 		audio_present = true;
 
-	fill_audio_buffer(audio, audio_present);
+	fill_audio_buffer(audio, difference, audio_present);
 }
 
 bool AudioOutput::is_squelched() {
 	return !audio_present;
 }
 
-void AudioOutput::fill_audio_buffer(const buffer_f32_t& audio, const bool send_to_fifo) {
+void AudioOutput::fill_audio_buffer(const buffer_f32_t& audio, const buffer_f32_t* const difference, const bool send_to_fifo) {
 	std::array<int16_t, 32> audio_int;
 
 	auto audio_buffer = audio::dma::tx_empty_buffer();
 	for(size_t i=0; i<audio_buffer.count; i++) {
 		const int32_t sample_int = audio.p[i] * k;
 		const int32_t sample_saturated = __SSAT(sample_int, 16);
-		audio_buffer.p[i].left = audio_buffer.p[i].right = sample_saturated;
+		if( difference ) {
+			const int32_t difference_int = difference->p[i] * k;
+			audio_buffer.p[i].left = __SSAT(sample_int + difference_int, 16);
+			audio_buffer.p[i].right = __SSAT(sample_int - difference_int, 16);
+		} else {
+			audio_buffer.p[i].left = audio_buffer.p[i].right = sample_saturated;
+		}
 		audio_int[i] = sample_saturated;
 	}
 	if( stream && send_to_fifo ) {
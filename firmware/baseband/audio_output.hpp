@@ -48,6 +48,11 @@ public:
 	void write(const buffer_s16_t& audio);
 	void write(const buffer_f32_t& audio);
 
+	/* Stereo from a sum (L+R) and difference (L-R) pair. Bypasses the block
+	 * buffer, so both buffers must hold exactly one block of samples.
+	 */
+	void write(const buffer_s16_t& audio, const buffer_s16_t& difference);
+
 	void set_stream(std::unique_ptr<StreamInput> new_stream) {
 		stream = std::move(new_stream);
 	}
@@ -62,6 +67,8 @@ private:
 
 	IIRBiquadFilter hpf { };
 	IIRBiquadFilter deemph { };
+	IIRBiquadFilter hpf_difference { };
+	IIRBiquadFilter deemph_difference { };
 	FMSquelch squelch { };
 
 	std::unique_ptr<StreamInput> stream { };
@@ -73,8 +80,8 @@ private:
 	bool audio_present = false;
 	bool do_processing = true;
 
-	void on_block(const buffer_f32_t& audio);
-	void fill_audio_buffer(const buffer_f32_t& audio, const bool send_to_fifo);
+	void on_block(const buffer_f32_t& audio, const buffer_f32_t* const difference = nullptr);
+	void fill_audio_buffer(const buffer_f32_t& audio, const buffer_f32_t* const difference, const bool send_to_fifo);
 	void feed_audio_stats(const buffer_f32_t& audio);
 };
 
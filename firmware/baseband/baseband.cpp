@@ -36,6 +36,13 @@ static void init() {
 	audio::dma::enable();
 
 	nvicEnableVector(DMA_IRQn, CORTEX_PRIORITY_MASK(LPC_DMA_IRQ_PRIORITY));
+
+	// The cores may be running slower than the HAL assumed at startup.
+	const uint32_t core_clock_f = shared_memory.core_clock_f;
+	if( core_clock_f ) {
+		halLPCSetSystemClock(core_clock_f);
+		systick_adjust_period(core_clock_f / CH_FREQUENCY - 1);
+	}
 }
 
 static void halt() {
@@ -34,3 +34,22 @@ void BasebandProcessor::feed_channel_stats(const buffer_c16_t& channel) {
 		}
 	);
 }
+
+void BasebandProcessor::feed_profile(const buffer_c8_t& buffer, const uint32_t execute_cycles) {
+	profiler.record(CycleProfiler::stage_execute, execute_cycles);
+	profiler.feed(
+		buffer.count, buffer.sampling_rate,
+		[](const ProcessorProfile& profile) {
+			auto& load = shared_memory.processor_load;
+			load.cycles_busy = (profile.stage_count > 0) ? profile.stages[CycleProfiler::stage_execute].cycles_total : 0;
+			load.cycles_elapsed = profile.cycles_elapsed;
+			load.sequence = load.sequence + 1;
+
+			// The full profile is ~200 bytes, only queue it for a viewer.
+			if( shared_memory.processor_profile_requested ) {
+				const ProcessorProfileMessage message { profile };
+				shared_memory.application_queue.push(message);
+			}
+		}
+	);
+}
@@ -25,6 +25,7 @@
 #include "dsp_types.hpp"
 
 #include "channel_stats_collector.hpp"
+#include "cycle_profiler.hpp"
 
 #include "message.hpp"
 
@@ -36,9 +37,14 @@ public:
 
 	virtual void on_message(const Message* const) { };
 
+	// Called by the baseband thread with the cycles spent in execute().
+	void feed_profile(const buffer_c8_t& buffer, const uint32_t execute_cycles);
+
 protected:
 	void feed_channel_stats(const buffer_c16_t& channel);
 
+	CycleProfiler profiler { };
+
 private:
 	ChannelStatsCollector channel_stats { };
 };
@@ -92,7 +92,9 @@ void BasebandThread::run() {
 			};
 
 			if( baseband_processor ) {
+				const auto execute_start = CycleProfiler::now();
 				baseband_processor->execute(buffer);
+				baseband_processor->feed_profile(buffer, CycleProfiler::now() - execute_start);
 			}
 		}
 	}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "cycle_profiler.hpp"
+
+#include <algorithm>
+#include <limits>
+
+CycleProfiler::CycleProfiler() {
+	/* Trace must be enabled for the DWT to count. Other users of the counter
+	 * (debugger) only ever read it, so it's not reset here.
+	 */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	profile.stage_count = 0;
+	add_stage("execute");
+	reset_stages();
+	interval_start = now();
+}
+
+CycleProfiler::stage_t CycleProfiler::add_stage(const char* const name) {
+	if( profile.stage_count >= profile.stages.size() ) {
+		return stage_execute;
+	}
+
+	const auto stage = profile.stage_count++;
+	auto& stage_name = profile.stages[stage].name;
+	stage_name.fill(0);
+	for(size_t i=0; (i<ProcessorProfile::name_length) && name[i]; i++) {
+		stage_name[i] = name[i];
+	}
+	return stage;
+}
+
+void CycleProfiler::record(const stage_t stage, const uint32_t cycles) {
+	auto& s = profile.stages[stage];
+	s.calls++;
+	s.cycles_total += cycles;
+	s.cycles_min = std::min(s.cycles_min, cycles);
+	s.cycles_max = std::max(s.cycles_max, cycles);
+}
+
+const ProcessorProfile& CycleProfiler::capture_profile() {
+	const auto interval_end = now();
+	profile.cycles_elapsed = interval_end - interval_start;
+	interval_start = interval_end;
+
+	for(size_t i=0; i<profile.stage_count; i++) {
+		auto& s = profile.stages[i];
+		if( s.calls == 0 ) {
+			s.cycles_min = 0;
+		}
+	}
+
+	return profile;
+}
+
+void CycleProfiler::reset_stages() {
+	for(auto& s : profile.stages) {
+		s.calls = 0;
+		s.cycles_min = std::numeric_limits<uint32_t>::max();
+		s.cycles_max = 0;
+		s.cycles_total = 0;
+	}
+}
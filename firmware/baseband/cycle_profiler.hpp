@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CYCLE_PROFILER_H__
+#define __CYCLE_PROFILER_H__
+
+#include "message.hpp"
+
+#include <hal.h>
+
+#include <cstdint>
+#include <cstddef>
+
+/* Per-stage cycle accounting using the Cortex-M4 DWT cycle counter.
+ * Reading CYCCNT is a single load, so timers can stay in release builds.
+ * Statistics are reset after each report, so min/mean/max cover one report
+ * interval (one second of baseband samples).
+ */
+class CycleProfiler {
+public:
+	using stage_t = size_t;
+
+	static constexpr stage_t stage_execute = 0;
+
+	CycleProfiler();
+
+	static uint32_t now() {
+		return DWT->CYCCNT;
+	}
+
+	/* Names longer than ProcessorProfile::name_length are truncated. Returns
+	 * the index to pass to record()/ScopedCycleTimer, or stage_execute if all
+	 * slots are in use, so extra stages fold into the total rather than
+	 * writing out of bounds.
+	 */
+	stage_t add_stage(const char* const name);
+
+	void record(const stage_t stage, const uint32_t cycles);
+
+	template<typename Callback>
+	void feed(const size_t sample_count, const uint32_t sampling_rate, Callback callback) {
+		samples += sample_count;
+		if( samples >= sampling_rate * report_interval ) {
+			// Callback copies the profile into a message before the reset.
+			callback(capture_profile());
+			reset_stages();
+			samples = 0;
+		}
+	}
+
+private:
+	static constexpr float report_interval { 1.0f };
+
+	ProcessorProfile profile { };
+	uint32_t interval_start { 0 };
+	size_t samples { 0 };
+
+	const ProcessorProfile& capture_profile();
+	void reset_stages();
+};
+
+/* Charges the cycles between construction and stop() (or destruction) to a
+ * profiler stage. stop() allows ending the measurement before the end of the
+ * enclosing scope, e.g. when the stage's output buffers are used afterwards.
+ */
+class ScopedCycleTimer {
+public:
+	ScopedCycleTimer(
+		CycleProfiler& profiler,
+		const CycleProfiler::stage_t stage
+	) : profiler { profiler },
+		stage { stage },
+		start { CycleProfiler::now() }
+	{
+	}
+
+	~ScopedCycleTimer() {
+		stop();
+	}
+
+	ScopedCycleTimer(const ScopedCycleTimer&) = delete;
+	ScopedCycleTimer(ScopedCycleTimer&&) = delete;
+	ScopedCycleTimer& operator=(const ScopedCycleTimer&) = delete;
+	ScopedCycleTimer& operator=(ScopedCycleTimer&&) = delete;
+
+	void stop() {
+		if( running ) {
+			profiler.record(stage, CycleProfiler::now() - start);
+			running = false;
+		}
+	}
+
+private:
+	CycleProfiler& profiler;
+	const CycleProfiler::stage_t stage;
+	const uint32_t start;
+	bool running { true };
+};
+
+#endif/*__CYCLE_PROFILER_H__*/
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_DDS_H__
+#define __DSP_DDS_H__
+
+#include "dsp_types.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace dsp {
+namespace dds {
+
+/* Direct digital synthesis on a 32-bit phase accumulator (one turn is 2^32).
+ * Sine comes from a 256 entry quarter-wave table with linear interpolation
+ * (the extra entries are the end point and a pad), so spurs sit well below
+ * the int8 output quantization.
+ */
+extern const std::array<int16_t, 258> quarter_sine_table_q15;
+
+constexpr uint32_t phase_increment(const uint32_t frequency, const uint32_t sampling_rate) {
+	return (static_cast<uint64_t>(frequency) << 32) / sampling_rate;
+}
+
+inline int32_t sin_q15(const uint32_t phase) {
+	uint32_t x = phase & 0x3fffffff;
+	if( phase & 0x40000000 ) {
+		x = 0x40000000 - x;
+	}
+	const size_t index = x >> 22;
+	const int32_t frac = (x >> 6) & 0xffff;
+	const int32_t a = quarter_sine_table_q15[index + 0];
+	const int32_t b = quarter_sine_table_q15[index + 1];
+	const int32_t y = a + (((b - a) * frac) >> 16);
+	return (phase & 0x80000000) ? -y : y;
+}
+
+inline int32_t cos_q15(const uint32_t phase) {
+	return sin_q15(phase + 0x40000000);
+}
+
+// Unit complex exponential at phase, scaled to int8.
+inline complex8_t iq(const uint32_t phase) {
+	return {
+		static_cast<int8_t>((cos_q15(phase) * 127) >> 15),
+		static_cast<int8_t>((sin_q15(phase) * 127) >> 15)
+	};
+}
+
+class NCO {
+public:
+	void set_phase_increment(const uint32_t new_phase_increment) {
+		phase_increment_ = new_phase_increment;
+	}
+
+	void set_frequency(const uint32_t frequency, const uint32_t sampling_rate) {
+		phase_increment_ = phase_increment(frequency, sampling_rate);
+	}
+
+	void reset(const uint32_t new_phase = 0) {
+		phase_ = new_phase;
+	}
+
+	uint32_t phase() const {
+		return phase_;
+	}
+
+	// Returns sin(phase) in Q15, then advances.
+	int32_t operator()() {
+		const auto result = sin_q15(phase_);
+		phase_ += phase_increment_;
+		return result;
+	}
+
+	// Complex carrier at the NCO frequency.
+	void execute(const buffer_c8_t& dst) {
+		for(size_t i=0; i<dst.count; i++) {
+			dst.p[i] = iq(phase_);
+			phase_ += phase_increment_;
+		}
+	}
+
+private:
+	uint32_t phase_ { 0 };
+	uint32_t phase_increment_ { 0 };
+};
+
+// Two tone, phase continuous FSK, e.g. AFSK audio tones.
+class FSK {
+public:
+	void configure(const uint32_t phase_increment_space, const uint32_t phase_increment_mark) {
+		increments = { { phase_increment_space, phase_increment_mark } };
+	}
+
+	void reset() {
+		phase = 0;
+	}
+
+	// sin() in Q15 for the current symbol, then advances.
+	int32_t operator()(const uint_fast8_t bit) {
+		const auto result = sin_q15(phase);
+		phase += increments[bit & 1];
+		return result;
+	}
+
+private:
+	std::array<uint32_t, 2> increments { { 0, 0 } };
+	uint32_t phase { 0 };
+};
+
+/* Modulation samples are Q15. For FM, deviation_hz keeps the 2^24/fs
+ * scaling the transmit processors and their UI callers have always used, so
+ * a full scale sample gives half of it as peak deviation. For PM, full scale
+ * gives the configured peak phase deviation.
+ */
+class FM {
+public:
+	void set_deviation(const uint32_t deviation_hz, const uint32_t sampling_rate) {
+		deviation = (static_cast<uint64_t>(deviation_hz) << 16) / sampling_rate;
+	}
+
+	complex8_t operator()(const int32_t sample) {
+		phase += sample * deviation;
+		return iq(phase);
+	}
+
+	void execute(const buffer_s16_t& src, const buffer_c8_t& dst) {
+		for(size_t i=0; i<dst.count; i++) {
+			dst.p[i] = (*this)(src.p[i]);
+		}
+	}
+
+private:
+	int32_t deviation { 0 };
+	uint32_t phase { 0 };
+};
+
+class PM {
+public:
+	// Phase deviation in 1/65536ths of a turn.
+	void set_deviation(const uint32_t deviation_turns_q16) {
+		deviation = deviation_turns_q16 << 1;
+	}
+
+	complex8_t operator()(const int32_t sample) {
+		return iq(sample * deviation);
+	}
+
+	void execute(const buffer_s16_t& src, const buffer_c8_t& dst) {
+		for(size_t i=0; i<dst.count; i++) {
+			dst.p[i] = (*this)(src.p[i]);
+		}
+	}
+
+private:
+	int32_t deviation { 0 };
+};
+
+} /* namespace dds */
+} /* namespace dsp */
+
+#endif/*__DSP_DDS_H__*/
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_FSK_SLICER_H__
+#define __DSP_FSK_SLICER_H__
+
+#include "dsp_types.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace dsp {
+namespace fsk {
+
+/* Running mean of the FM discriminator output, i.e. the carrier offset,
+ * as an exponential average with a time constant of 2^shift updates.
+ */
+class DCTracker {
+public:
+	constexpr DCTracker(
+		const size_t shift = 5
+	) : shift { shift }
+	{
+	}
+
+	int32_t operator()(const int32_t sample) {
+		accumulator += sample - (accumulator >> shift);
+		return value();
+	}
+
+	int32_t value() const {
+		return accumulator >> shift;
+	}
+
+	void reset(const int32_t value = 0) {
+		accumulator = value << shift;
+	}
+
+private:
+	size_t shift;
+	int32_t accumulator { 0 };
+};
+
+/* Timing error detectors return the sign of the sampling lateness at a
+ * symbol (+1 late, -1 early), 0 when there was no transition to judge by.
+ * Sign only, so loop gain doesn't depend on signal level.
+ */
+struct GardnerDetector {
+	int32_t operator()(const int32_t previous, const int32_t midpoint, const int32_t current) const {
+		if( (previous > 0) == (current > 0) ) {
+			return 0;
+		}
+		// Midpoint has already crossed zero towards the new symbol if late.
+		return ((current > 0) == (midpoint > 0)) ? 1 : -1;
+	}
+};
+
+/* Judged at transitions only, so GFSK ISI from runs of equal bits biases it.
+ * Against Gardner on GFSK it takes several times longer to lock and can't
+ * hold a 2000ppm symbol rate error, prefer Gardner unless there's no
+ * midpoint to sample.
+ */
+struct MuellerMullerDetector {
+	int32_t operator()(const int32_t previous, const int32_t, const int32_t current) const {
+		if( (previous > 0) == (current > 0) ) {
+			return 0;
+		}
+		// Decision directed: a[n-1] * y[n] - a[n] * y[n-1], negative when late.
+		const int32_t error = (previous > 0) ? (current + previous) : -(current + previous);
+		return (error < 0) ? 1 : ((error > 0) ? -1 : 0);
+	}
+};
+
+/* Slices an FM discriminator output (2-FSK/GFSK) into bits.
+ * A 32-bit symbol clock NCO strobes symbol centers and midpoints, sampled
+ * by linear interpolation between input samples, and is nudged by a fixed
+ * fraction of a symbol (1/timing_step_divisor) at each transition, as
+ * judged by the timing error detector. The decision threshold
+ * follows the symbol mean unless held, e.g. once a decoder has found sync.
+ * Needs at least 2 samples per symbol.
+ */
+template<typename TimingErrorDetector = GardnerDetector>
+class BitSlicer {
+public:
+	void configure(
+		const uint32_t sampling_rate,
+		const uint32_t symbol_rate,
+		const size_t dc_shift = 5,
+		const uint32_t timing_step_divisor = 32
+	) {
+		phase_inc = (static_cast<uint64_t>(symbol_rate) << 32) / sampling_rate;
+		// Step is a fraction of a symbol, capped so the clock never stalls.
+		timing_step = std::min(0xffffffffUL / timing_step_divisor, static_cast<unsigned long>(phase_inc / 2));
+		interpolation_scale = (32768UL << 16) / (phase_inc >> 16);
+		dc = DCTracker { dc_shift };
+		reset();
+	}
+
+	void reset() {
+		phase = 0;
+		timing_adjust = 0;
+		last_sample = 0;
+		midpoint = 0;
+		last_symbol = 0;
+		dc.reset();
+		dc_hold = false;
+	}
+
+	// Freeze the decision threshold at its current value.
+	void set_dc_hold(const bool hold) {
+		dc_hold = hold;
+	}
+
+	// Fixed decision threshold, for discriminators without a carrier offset.
+	void set_dc_level(const int32_t level) {
+		dc.reset(level);
+		dc_hold = true;
+	}
+
+	int32_t dc_level() const {
+		return dc.value();
+	}
+
+	template<typename BitHandler>
+	void execute(const buffer_s16_t& src, BitHandler bit_handler) {
+		for(size_t i=0; i<src.count; i++) {
+			(*this)(src.p[i], bit_handler);
+		}
+	}
+
+	template<typename BitHandler>
+	void operator()(const int32_t sample, BitHandler bit_handler) {
+		// Timing correction is folded into a single increment, so strobes are
+		// never skipped or repeated.
+		const uint32_t phase_last = phase;
+		phase += phase_inc + timing_adjust;
+		timing_adjust = 0;
+
+		if( phase < phase_last ) {
+			// Wrapped: symbol center
+			const int32_t raw = interpolate(sample, phase);
+			const int32_t symbol = raw - dc.value();
+			if( !dc_hold ) {
+				dc(raw);
+			}
+
+			const int32_t lateness = timing_error_detector(last_symbol, midpoint, symbol);
+			timing_adjust = lateness * static_cast<int32_t>(timing_step);
+			last_symbol = symbol;
+
+			bit_handler((symbol > 0) ? 1 : 0);
+		} else if( (phase_last < phase_midpoint) && (phase >= phase_midpoint) ) {
+			midpoint = interpolate(sample, phase - phase_midpoint) - dc.value();
+		}
+
+		last_sample = sample;
+	}
+
+private:
+	static constexpr uint32_t phase_midpoint = 0x80000000;
+
+	uint32_t phase { 0 };
+	uint32_t phase_inc { 0 };
+	uint32_t timing_step { 0 };
+	int32_t timing_adjust { 0 };
+	uint32_t interpolation_scale { 0 };
+
+	int32_t last_sample { 0 };
+	int32_t midpoint { 0 };
+	int32_t last_symbol { 0 };
+
+	DCTracker dc { };
+	bool dc_hold { false };
+	TimingErrorDetector timing_error_detector { };
+
+	/* Value at the strobe, which lies (overshoot / phase_inc) of a sample
+	 * before the current one.
+	 */
+	int32_t interpolate(const int32_t sample, const uint32_t overshoot) const {
+		const int32_t frac_q15 = ((overshoot >> 16) * interpolation_scale) >> 16;
+		return sample - (((sample - last_sample) * frac_q15) >> 15);
+	}
+};
+
+} /* namespace fsk */
+} /* namespace dsp */
+
+#endif/*__DSP_FSK_SLICER_H__*/
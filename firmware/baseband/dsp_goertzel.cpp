@@ -23,34 +23,14 @@
 #include "dsp_goertzel.hpp"
 
 #include "complex.hpp"
-#include "sine_table.hpp"
 
-namespace dsp {
-
-GoertzelDetector::GoertzelDetector(
-	const float frequency,
-	const uint32_t sample_rate
-) {
-	coefficient = 2.0 * sin_f32((2.0 * pi * frequency / sample_rate) - pi / 2.0);
-}
+#include <cmath>
 
-float GoertzelDetector::execute(
-	const buffer_s16_t& src
-) {
-
-	const size_t count = src.count;
-	
-	for (size_t i = 0; i < count; i++) {
-		s[2] = s[1];
-		s[1] = s[0];
-		s[0] = src.p[i] + coefficient * s[1] - s[2];
-	}
-
-	const uint32_t sq0 = s[0] * s[0];
-	const uint32_t sq1 = s[1] * s[1];
-	float magnitude = __builtin_sqrtf(sq0 + sq1 - s[0] * s[1] * coefficient);
+namespace dsp {
 
-	return magnitude;
+int32_t goertzel_coefficient(const float frequency, const uint32_t sampling_rate) {
+	const float w = 2.0f * pi * frequency / sampling_rate;
+	return std::lround(2.0f * std::cos(w) * (1 << 28));
 }
 
 } /* namespace dsp */
@@ -25,17 +25,124 @@
 
 #include "dsp_types.hpp"
 
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
 namespace dsp {
 
-class GoertzelDetector {
+// 2 * cos(2 * pi * frequency / sampling_rate) in Q28.
+int32_t goertzel_coefficient(const float frequency, const uint32_t sampling_rate);
+
+/* Bank of Goertzel filters sharing one block length, so one pass over the
+ * input evaluates every bin. The recurrence runs in fixed point (Q28
+ * coefficients, 64-bit products, 32-bit state), which holds full scale int16
+ * input for blocks of up to ~100k samples. Only the final bin powers are
+ * computed in float, once per block.
+ */
+template<size_t Bins>
+class GoertzelBank {
 public:
-	GoertzelDetector(const float frequency, const uint32_t sample_rate);
-	
-	float execute(const buffer_s16_t& src);
+	void configure(const uint32_t sampling_rate, const size_t block_length) {
+		sampling_rate_ = sampling_rate;
+		length = block_length;
+		reset();
+	}
+
+	void set_frequency(const size_t bin, const float frequency) {
+		coefficient[bin] = goertzel_coefficient(frequency, sampling_rate_);
+	}
+
+	void reset() {
+		s1.fill(0);
+		s2.fill(0);
+		samples = 0;
+		sum = 0;
+		sum_squares = 0;
+	}
+
+	/* block_handler() is called each time a block completes, the results
+	 * (power(), confidence()) are valid until it returns.
+	 */
+	template<typename BlockHandler>
+	void execute(const buffer_s16_t& src, BlockHandler block_handler) {
+		size_t offset = 0;
+		while( offset < src.count ) {
+			const size_t n = std::min(src.count - offset, length - samples);
+			feed(&src.p[offset], n);
+			offset += n;
+			samples += n;
+
+			if( samples >= length ) {
+				block_handler();
+				reset();
+			}
+		}
+	}
+
+	size_t size() const {
+		return Bins;
+	}
+
+	float power(const size_t bin) const {
+		const float c = coefficient[bin] * (1.0f / (1 << 28));
+		const float a = s1[bin];
+		const float b = s2[bin];
+		return (a * a) + (b * b) - (c * a * b);
+	}
+
+	/* Fraction of the block's AC energy in the bin: 1.0 for a pure tone at the
+	 * bin frequency, ~2/N for white noise.
+	 */
+	float confidence(const size_t bin) const {
+		const float energy = sum_squares - (static_cast<float>(sum) * sum / length);
+		if( energy <= 0.0f ) {
+			return 0.0f;
+		}
+		return std::min(2.0f * power(bin) / (energy * length), 1.0f);
+	}
+
+	size_t strongest() const {
+		size_t result = 0;
+		for(size_t i=1; i<Bins; i++) {
+			if( power(i) > power(result) ) {
+				result = i;
+			}
+		}
+		return result;
+	}
 
 private:
-	float coefficient { };
-	int16_t s[2] { 0 };
+	uint32_t sampling_rate_ { 0 };
+	size_t length { 1 };
+	size_t samples { 0 };
+	int32_t sum { 0 };
+	int64_t sum_squares { 0 };
+
+	std::array<int32_t, Bins> coefficient { };
+	std::array<int32_t, Bins> s1 { };
+	std::array<int32_t, Bins> s2 { };
+
+	void feed(const int16_t* const p, const size_t count) {
+		for(size_t i=0; i<Bins; i++) {
+			const int64_t c = coefficient[i];
+			int32_t a = s1[i];
+			int32_t b = s2[i];
+			for(size_t j=0; j<count; j++) {
+				const int32_t s0 = p[j] + static_cast<int32_t>((c * a) >> 28) - b;
+				b = a;
+				a = s0;
+			}
+			s1[i] = a;
+			s2[i] = b;
+		}
+
+		for(size_t j=0; j<count; j++) {
+			sum += p[j];
+			sum_squares += p[j] * p[j];
+		}
+	}
 };
 
 } /* namespace dsp */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_stereo.hpp"
+
+#include "sine_table.hpp"
+
+#include <algorithm>
+
+#include <hal.h>
+
+namespace dsp {
+namespace stereo {
+
+static constexpr float phase_units_per_radian = 4294967296.0f / (2.0f * pi);
+static constexpr uint32_t phase_quarter_turn = 0x40000000;
+
+static inline float sin_phase(const uint32_t phase) {
+	/* 8 bit table index, 24 bit linear interpolation fraction. */
+	const size_t n = phase >> 24;
+	const float frac = (phase & 0x00ffffff) * (1.0f / 16777216.0f);
+	const float p0 = sine_table_f32[n + 0];
+	const float p1 = sine_table_f32[n + 1];
+	return p0 + frac * (p1 - p0);
+}
+
+static inline float cos_phase(const uint32_t phase) {
+	return sin_phase(phase + phase_quarter_turn);
+}
+
+void PilotPLL::configure(const float sampling_rate) {
+	/* Loop natural frequency ~20Hz, damping 0.707. Phase detector output
+	 * is pre-filtered at ~1kHz to knock down the 38kHz product and most
+	 * of the L+R audio before it reaches the loop filter.
+	 */
+	constexpr float loop_natural_frequency = 20.0f;
+	constexpr float damping = 0.707f;
+	const float wn_t = 2.0f * pi * loop_natural_frequency / sampling_rate;
+
+	phase_inc_nominal = pilot_frequency / sampling_rate * 4294967296.0f;
+	phase_inc_limit = 50.0f / sampling_rate * 4294967296.0f;
+	kp = 2.0f * damping * wn_t * phase_units_per_radian;
+	ki = wn_t * wn_t * phase_units_per_radian;
+	alpha_error = 2.0f * pi * 1000.0f / sampling_rate;
+	alpha_level = 2.0f * pi * 5.0f / sampling_rate;
+
+	phase = 0;
+	frequency_error = 0;
+	error_filtered = 0;
+	level_ = 0;
+	locked_ = false;
+}
+
+uint32_t PilotPLL::execute(const float sample) {
+	const auto current_phase = phase;
+
+	/* Pilot is sin(wt). x * cos(theta) -> A/2 * sin(phase error),
+	 * x * sin(theta) -> A/2 * cos(phase error), i.e. pilot level when locked.
+	 */
+	error_filtered += alpha_error * (sample * cos_phase(current_phase) - error_filtered);
+	level_ += alpha_level * (sample * sin_phase(current_phase) - level_);
+
+	// Normalize so loop gain doesn't depend on pilot injection level.
+	const float detector = error_filtered / std::max(level_, lock_level_off);
+
+	frequency_error = std::max(-phase_inc_limit, std::min(phase_inc_limit, frequency_error + ki * detector));
+	const float phase_inc = phase_inc_nominal + frequency_error + kp * detector;
+	phase += static_cast<uint32_t>(static_cast<int32_t>(phase_inc));
+
+	if( locked_ ) {
+		locked_ = (level_ > lock_level_off);
+	} else {
+		locked_ = (level_ > lock_level_on);
+	}
+
+	return current_phase;
+}
+
+void MultiplexDecoder::configure(const size_t sampling_rate) {
+	pll.configure(sampling_rate);
+}
+
+MultiplexDecoder::result_t MultiplexDecoder::execute(
+	const buffer_s16_t& src,
+	const buffer_s16_t& difference_dst,
+	const buffer_c16_t& rds_dst
+) {
+	constexpr float k = 1.0f / 32768.0f;
+
+	for(size_t i=0; i<src.count; i++) {
+		const float x = src.p[i] * k;
+		const auto theta = pll.execute(x);
+
+		/* Sub-carrier is (L-R) * sin(2wt), coherent with the pilot. Both
+		 * products are scaled by two to undo the mixing loss.
+		 */
+		const float x2 = x * 65536.0f;
+		const int32_t difference = pll.locked() ? static_cast<int32_t>(x2 * sin_phase(theta * 2)) : 0;
+		difference_dst.p[i] = __SSAT(difference, 16);
+
+		// RDS is locked to the third pilot harmonic, but in phase or quadrature.
+		const auto theta_rds = theta * 3;
+		const int32_t rds_i = x2 * cos_phase(theta_rds);
+		const int32_t rds_q = -x2 * sin_phase(theta_rds);
+		rds_dst.p[i] = { static_cast<int16_t>(__SSAT(rds_i, 16)), static_cast<int16_t>(__SSAT(rds_q, 16)) };
+	}
+
+	/* Coarse anti-alias filtering only, consumers are expected to apply their
+	 * own channel/matched filter to the 57kHz tap.
+	 */
+	const buffer_c16_t rds_full { rds_dst.p, src.count, src.sampling_rate };
+	const auto rds_4fs = rds_decim_0.execute(rds_full, rds_dst);
+	const auto rds_2fs = rds_decim_1.execute(rds_4fs, rds_dst);
+	const auto rds = rds_decim_2.execute(rds_2fs, rds_dst);
+
+	return {
+		{ difference_dst.p, src.count, src.sampling_rate },
+		rds
+	};
+}
+
+} /* namespace stereo */
+} /* namespace dsp */
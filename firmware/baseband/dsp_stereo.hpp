@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_STEREO_H__
+#define __DSP_STEREO_H__
+
+#include "dsp_types.hpp"
+#include "dsp_decimate.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace dsp {
+namespace stereo {
+
+/* Second-order PLL tracking the 19kHz stereo pilot. Phase is a 32-bit
+ * accumulator so the 38kHz and 57kHz references are simply 2x and 3x
+ * the pilot phase (wrapping is free).
+ */
+class PilotPLL {
+public:
+	void configure(const float sampling_rate);
+
+	/* Advances the loop by one MPX sample (normalized to +/-1.0) and
+	 * returns the pilot phase used for that sample.
+	 */
+	uint32_t execute(const float sample);
+
+	bool locked() const {
+		return locked_;
+	}
+
+	float level() const {
+		return level_;
+	}
+
+private:
+	static constexpr float pilot_frequency = 19000.0f;
+	static constexpr float lock_level_on = 0.020f;
+	static constexpr float lock_level_off = 0.012f;
+
+	uint32_t phase { 0 };
+	float phase_inc_nominal { 0 };
+	float phase_inc_limit { 0 };
+	float frequency_error { 0 };
+	float error_filtered { 0 };
+	float level_ { 0 };
+	bool locked_ { false };
+
+	float alpha_error { 0 };
+	float alpha_level { 0 };
+	float kp { 0 };
+	float ki { 0 };
+};
+
+/* FM stereo multiplex decoder. Consumes the demodulated MPX at >= 152kHz
+ * and produces the L-R baseband (at the input rate, to share the mono
+ * path's decimation chain) and a complex 57kHz subcarrier tap decimated
+ * by 8 for an RDS demodulator. The L+R signal is the MPX itself.
+ */
+class MultiplexDecoder {
+public:
+	struct result_t {
+		buffer_s16_t difference;
+		buffer_c16_t rds;
+	};
+
+	void configure(const size_t sampling_rate);
+
+	result_t execute(
+		const buffer_s16_t& src,
+		const buffer_s16_t& difference_dst,
+		const buffer_c16_t& rds_dst
+	);
+
+	bool is_stereo() const {
+		return pll.locked();
+	}
+
+private:
+	PilotPLL pll { };
+
+	dsp::decimate::DecimateBy2CIC3 rds_decim_0 { };
+	dsp::decimate::DecimateBy2CIC3 rds_decim_1 { };
+	dsp::decimate::DecimateBy2CIC3 rds_decim_2 { };
+};
+
+} /* namespace stereo */
+} /* namespace dsp */
+
+#endif/*__DSP_STEREO_H__*/
@@ -101,6 +101,17 @@ void EventDispatcher::on_message(const Message* const message) {
 		on_message_shutdown(*reinterpret_cast<const ShutdownMessage*>(message));
 		break;
 
+	case Message::ID::RSSIStreamConfig:
+		// Each receiving processor has its own RSSIThread, configure it here rather than in all of them.
+		RSSIThread::configure_stream(reinterpret_cast<const RSSIStreamConfigMessage*>(message)->config);
+		shared_memory.baseband_message = nullptr;
+		break;
+
+	case Message::ID::CoreClock:
+		on_message_core_clock(*reinterpret_cast<const CoreClockMessage*>(message));
+		shared_memory.baseband_message = nullptr;
+		break;
+
 	default:
 		on_message_default(message);
 		shared_memory.baseband_message = nullptr;
@@ -112,6 +123,14 @@ void EventDispatcher::on_message_shutdown(const ShutdownMessage&) {
 	request_stop();
 }
 
+void EventDispatcher::on_message_core_clock(const CoreClockMessage& message) {
+	// Both cores share BASE_M4_CLK, keep the SysTick at CH_FREQUENCY.
+	chSysLock();
+	halLPCSetSystemClock(message.clock_f);
+	systick_adjust_period(message.clock_f / CH_FREQUENCY - 1);
+	chSysUnlock();
+}
+
 void EventDispatcher::on_message_default(const Message* const message) {
 	baseband_processor->on_message(message);
 }
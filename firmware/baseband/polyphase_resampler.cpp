@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "polyphase_resampler.hpp"
+
+#include "complex.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace dsp {
+namespace interpolation {
+
+static float sinc(const float x) {
+	return (x == 0.0f) ? 1.0f : (std::sin(pi * x) / (pi * x));
+}
+
+static float lanczos2(const float x) {
+	return (std::abs(x) < 2.0f) ? (sinc(x) * sinc(x / 2.0f)) : 0.0f;
+}
+
+PolyphaseResampler::PolyphaseResampler() {
+	/* Phase p interpolates at mu = (p + 0.5) / N between history[1] and
+	 * history[2], which are at distances mu and 1 - mu. Taps are normalized
+	 * per phase for unity DC gain.
+	 */
+	constexpr size_t phase_count = 1 << phase_count_log2;
+	for(size_t p=0; p<phase_count; p++) {
+		const float mu = (p + 0.5f) / phase_count;
+		const std::array<float, taps_per_phase> weights { {
+			lanczos2(mu + 1.0f), lanczos2(mu), lanczos2(1.0f - mu), lanczos2(2.0f - mu)
+		} };
+
+		float sum = 0.0f;
+		for(const auto w : weights) {
+			sum += w;
+		}
+		for(size_t n=0; n<taps_per_phase; n++) {
+			table[p][n] = std::round(weights[n] / sum * (1 << tap_bits));
+		}
+	}
+}
+
+void PolyphaseResampler::configure(const uint32_t input_rate, const uint32_t output_rate) {
+	// Largest step that can't wrap the phase accumulator.
+	constexpr uint64_t step_max = 0xffffffffULL - phase_one;
+	step = ((input_rate > 0) && (output_rate > 0))
+		? std::min<uint64_t>((static_cast<uint64_t>(input_rate) << phase_bits) / output_rate, step_max)
+		: phase_one;
+	reset();
+}
+
+void PolyphaseResampler::reset() {
+	history.fill({ 0, 0 });
+	phase = phase_one;
+}
+
+} /* namespace interpolation */
+} /* namespace dsp */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __POLYPHASE_RESAMPLER_H__
+#define __POLYPHASE_RESAMPLER_H__
+
+#include "dsp_types.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include <hal.h>
+
+namespace dsp {
+namespace interpolation {
+
+/* Arbitrary ratio resampler for complex baseband, C16 in and C8 out.
+ * Each output is a 4 tap FIR over the input history, with the taps taken
+ * from a polyphase table of a Lanczos (a = 2) kernel indexed by the
+ * fractional input position. The position advances by input_rate /
+ * output_rate per output sample, so the ratio needn't be rational or > 1.
+ */
+class PolyphaseResampler {
+public:
+	PolyphaseResampler();
+
+	void configure(const uint32_t input_rate, const uint32_t output_rate);
+	void reset();
+
+	// source() is called for each input sample consumed.
+	template<typename Source>
+	void execute(const buffer_c8_t& dst, Source source) {
+		for(size_t i=0; i<dst.count; i++) {
+			while( phase >= phase_one ) {
+				phase -= phase_one;
+				history[0] = history[1];
+				history[1] = history[2];
+				history[2] = history[3];
+				history[3] = source();
+			}
+
+			const auto& taps = table[phase >> (phase_bits - phase_count_log2)];
+			int32_t re = round_bias;
+			int32_t im = round_bias;
+			for(size_t n=0; n<taps_per_phase; n++) {
+				re += taps[n] * history[n].real();
+				im += taps[n] * history[n].imag();
+			}
+			dst.p[i] = {
+				static_cast<int8_t>(__SSAT(re >> (tap_bits + 8), 8)),
+				static_cast<int8_t>(__SSAT(im >> (tap_bits + 8), 8))
+			};
+
+			phase += step;
+		}
+	}
+
+private:
+	static constexpr size_t taps_per_phase = 4;
+	static constexpr size_t phase_count_log2 = 7;
+	static constexpr size_t phase_bits = 24;
+	static constexpr uint32_t phase_one = 1UL << phase_bits;
+	static constexpr size_t tap_bits = 14;
+	static constexpr int32_t round_bias = 1L << (tap_bits + 7);
+
+	using taps_t = std::array<int16_t, taps_per_phase>;
+
+	std::array<taps_t, 1 << phase_count_log2> table { };
+	std::array<complex16_t, taps_per_phase> history { };
+	uint32_t phase { phase_one };
+	uint32_t step { phase_one };
+};
+
+} /* namespace interpolation */
+} /* namespace dsp */
+
+#endif/*__POLYPHASE_RESAMPLER_H__*/
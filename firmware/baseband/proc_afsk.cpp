@@ -22,7 +22,6 @@
 
 #include "proc_afsk.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
@@ -74,23 +73,10 @@ void AFSKProcessor::execute(const buffer_c8_t& buffer) {
 			sample_count++;
 		}
 		
-		if (cur_bit)
-			tone_phase += afsk_phase_inc_mark;
-		else
-			tone_phase += afsk_phase_inc_space;
-
-		tone_sample = sine_table_i8[(tone_phase & 0xFF000000U) >> 24];
-
-		delta = tone_sample * fm_delta;
-		
-		phase += delta;
-		sphase = phase + (64 << 24);
-
-		re = (sine_table_i8[(sphase & 0xFF000000U) >> 24]);
-		im = (sine_table_i8[(phase & 0xFF000000U) >> 24]);
-			
-		buffer.p[i] = {re, im};
+		modulation[i] = tone(cur_bit);
 	}
+	
+	fm.execute({ modulation.data(), buffer.count }, buffer);
 }
 
 void AFSKProcessor::on_message(const Message* const msg) {
@@ -99,10 +85,9 @@ void AFSKProcessor::on_message(const Message* const msg) {
 	if (message.id == Message::ID::AFSKTxConfigure) {
 		if (message.samples_per_bit) {
 			afsk_samples_per_bit = message.samples_per_bit;
-			afsk_phase_inc_mark = message.phase_inc_mark * AFSK_DELTA_COEF;
-			afsk_phase_inc_space = message.phase_inc_space * AFSK_DELTA_COEF;
+			tone.configure(message.phase_inc_space * AFSK_DELTA_COEF, message.phase_inc_mark * AFSK_DELTA_COEF);
 			afsk_repeat = message.repeat - 1;
-			fm_delta = message.fm_delta * (0xFFFFFFULL / AFSK_SAMPLERATE);
+			fm.set_deviation(message.fm_delta, AFSK_SAMPLERATE);
 			symbol_count = message.symbol_count - 1;
 
 			sample_count = afsk_samples_per_bit;
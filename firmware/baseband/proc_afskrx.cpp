@@ -61,83 +61,73 @@ void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 		prev_filtered = sample_filtered;
 		prev_mixed = sample_mixed;
 		
-		// Slice
-		sample_bits <<= 1;
-		sample_bits |= (sample_filtered < -20) ? 1 : 0;
+		// Mark (1) is a negative correlator output, the slicer threshold is fixed
+		slicer(__SSAT(-sample_filtered, 16),
+			[this](const uint_fast8_t bit) {
+				this->on_bit(bit);
+			}
+		);
+	}
+}
+
+void AFSKRxProcessor::on_bit(const uint_fast8_t bit) {
+	if (trigger_word) {
 		
-		// Check for "clean" transition: either 0011 or 1100
-		if ((((sample_bits >> 2) ^ sample_bits) & 3) == 3) {
-			// Adjust phase
-			if (phase < 0x8000)
-				phase += 0x800;		// Is this a proper value ?
-			else
-				phase -= 0x800;
-		}
+		// Continuous-stream value-triggered mode (AX.25) - UNTESTED
+		word_bits <<= 1;
+		word_bits |= bit;
 		
-		phase += phase_inc;
+		bit_counter++;
 		
-		if (phase >= 0x10000) {
-			phase &= 0xFFFF;
-			
-			if (trigger_word) {
-				
-				// Continuous-stream value-triggered mode (AX.25) - UNTESTED
-				word_bits <<= 1;
-				word_bits |= (sample_bits & 1);
-				
-				bit_counter++;
-				
-				if (triggered) {
-					if (bit_counter == word_length) {
-						bit_counter = 0;
-						
-						data_message.is_data = true;
-						data_message.value = word_bits & word_mask;
-						shared_memory.application_queue.push(data_message);
-					}
-				} else {
-					if ((word_bits & word_mask) == trigger_value) {
-						triggered = !triggered;
-						bit_counter = 0;
-						
-						data_message.is_data = true;
-						data_message.value = trigger_value;
-						shared_memory.application_queue.push(data_message);
-					}
-				}
-				
-			} else {
-				
-				// RS232-like modem mode
-				if (state == WAIT_START) {
-					if (!(sample_bits & 1)) {
-						// Got start bit
-						state = RECEIVE;
-						bit_counter = 0;
-					}
-				} else if (state == WAIT_STOP) {
-					if (sample_bits & 1) {
-						// Got stop bit
-						state = WAIT_START;
-					}
-				} else {
-					word_bits <<= 1;
-					word_bits |= (sample_bits & 1);
-					
-					bit_counter++;
-				}
+		if (triggered) {
+			if (bit_counter == word_length) {
+				bit_counter = 0;
 				
-				if (bit_counter == word_length) {
-					bit_counter = 0;
-					state = WAIT_STOP;
-					
-					data_message.is_data = true;
-					data_message.value = word_bits;
-					shared_memory.application_queue.push(data_message);
-				}
+				data_message.is_data = true;
+				data_message.value = word_bits & word_mask;
+				shared_memory.application_queue.push(data_message);
+			}
+		} else {
+			if ((word_bits & word_mask) == trigger_value) {
+				triggered = !triggered;
+				bit_counter = 0;
 				
+				data_message.is_data = true;
+				data_message.value = trigger_value;
+				shared_memory.application_queue.push(data_message);
 			}
 		}
+		
+	} else {
+		
+		// RS232-like modem mode
+		if (state == WAIT_START) {
+			if (!bit) {
+				// Got start bit
+				state = RECEIVE;
+				bit_counter = 0;
+			}
+		} else if (state == WAIT_STOP) {
+			if (bit) {
+				// Got stop bit
+				state = WAIT_START;
+			}
+		} else {
+			word_bits <<= 1;
+			word_bits |= bit;
+			
+			bit_counter++;
+		}
+		
+		if (bit_counter == word_length) {
+			bit_counter = 0;
+			state = WAIT_STOP;
+			
+			data_message.is_data = true;
+			data_message.value = word_bits;
+			shared_memory.application_queue.push(data_message);
+		}
+		
 	}
 }
 
@@ -167,8 +157,8 @@ void AFSKRxProcessor::configure(const AFSKRxConfigureMessage& message) {
 	
 	samples_per_bit = audio_fs / message.baudrate;
 	
-	phase_inc = (0x10000 * message.baudrate) / audio_fs;
-	phase = 0;
+	slicer.configure(audio_fs, message.baudrate);
+	slicer.set_dc_level(20);
 	
 	trigger_word = message.trigger_word;
 	word_length = message.word_length;
@@ -29,6 +29,7 @@
 
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
+#include "dsp_fsk_slicer.hpp"
 
 #include "audio_output.hpp"
 
@@ -75,6 +76,7 @@ private:
 	dsp::decimate::FIRAndDecimateComplex channel_filter { };
 	
 	dsp::demodulate::FM demod { };
+	dsp::fsk::BitSlicer<dsp::fsk::GardnerDetector> slicer { };
 	
 	AudioOutput audio_output { };
 
@@ -82,8 +84,6 @@ private:
 	size_t delay_line_index { };
 	uint32_t bit_counter { 0 };
 	uint32_t word_bits { 0 };
-	uint32_t sample_bits { 0 };
-	uint32_t phase { }, phase_inc { };
 	int32_t sample_mixed { }, prev_mixed { }, sample_filtered { }, prev_filtered { };
 	uint32_t word_length { };
 	uint32_t word_mask { };
@@ -91,11 +91,11 @@ private:
 	
 	bool configured { false };
 	bool wait_start { };
-	bool bit_value { };
 	bool trigger_word { };
 	bool triggered { };
 	
 	void configure(const AFSKRxConfigureMessage& message);
+	void on_bit(const uint_fast8_t bit);
 	
 	AFSKDataMessage data_message { false, 0 };
 };
@@ -24,7 +24,6 @@
 #include "proc_am_tv.hpp"
 
 #include "portapack_shared_memory.hpp"
-#include "dsp_fft.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
@@ -33,37 +32,39 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	if( !configured ) {
 		return;
 	}
-	
-	std::fill(spectrum.begin(), spectrum.end(), 0);
 
-	for(size_t i=0; i<spectrum.size(); i++) {
-		spectrum[i] += buffer.p[i];
-	}
+	/* The envelope doesn't care that the carrier sits fs/4 off center, so
+	 * every 2MHz sample is used as is, 128 per 64us line.
+	 */
+	tv_sync.execute(buffer,
+		[this](const VideoLine& line) {
+			this->on_line(line);
+		}
+	);
+}
 
-	const buffer_c16_t buffer_c16 {spectrum.data(),spectrum.size(),buffer.sampling_rate};
-	channel_spectrum.feed(buffer_c16);
+void WidebandFMAudio::on_line(const VideoLine& line) {
+	if( !streaming ) {
+		return;
+	}
 
-        int8_t re ;
-	//int8_t im;  
-	//int8_t mag;
+	if( (line.field % field_decimation) != 0 ) {
+		return;
+	}
 
-        for (size_t i = 0; i < 128; i++) 
-	{
-		re = buffer.p[i].real();
-		//im = buffer.p[i].imag();
-		//mag = __builtin_sqrtf((re * re) + (im * im)) ;
-		const unsigned int v =  re + 127.0f; //timescope
-		audio_spectrum.db[i] = std::max(0U, std::min(255U, v));
+	if( (line.line_number < VideoLine::active_first_line) ||
+		(line.line_number >= (VideoLine::active_first_line + VideoLine::active_lines)) ) {
+		return;
 	}
-	AudioSpectrumMessage message { &audio_spectrum };
-	shared_memory.application_queue.push(message);
+
+	// Drop lines rather than block if the application falls behind.
+	fifo.in(line);
 }
 
 void WidebandFMAudio::on_message(const Message* const message) {
 	switch(message->id) {
-	case Message::ID::UpdateSpectrum:
 	case Message::ID::SpectrumStreamingConfig:
-		channel_spectrum.on_message(message);
+		set_streaming(*reinterpret_cast<const SpectrumStreamingConfigMessage*>(message));
 		break;
 
 	case Message::ID::WFMConfigure:
@@ -75,6 +76,17 @@ void WidebandFMAudio::on_message(const Message* const message) {
 	}
 }
 
+void WidebandFMAudio::set_streaming(const SpectrumStreamingConfigMessage& message) {
+	if( message.mode == SpectrumStreamingConfigMessage::Mode::Running ) {
+		streaming = true;
+		VideoLineConfigMessage config_message { &fifo };
+		shared_memory.application_queue.push(config_message);
+	} else {
+		streaming = false;
+		fifo.reset_in();
+	}
+}
+
 void WidebandFMAudio::configure(const WFMConfigureMessage& message) {
 	(void)message; // avoid warning
 	configured = true;
@@ -29,11 +29,10 @@
 #include "rssi_thread.hpp"
 
 #include "dsp_types.hpp"
-#include "dsp_decimate.hpp"
-#include "dsp_demodulate.hpp"
-#include "block_decimator.hpp"
 
-#include "tv_collector.hpp"
+#include "tv_sync.hpp"
+
+#include "message.hpp"
 
 class WidebandFMAudio : public BasebandProcessor {
 public:
@@ -44,22 +43,26 @@ public:
 private:
 	static constexpr size_t baseband_fs = 2000000;
 
+	/* Only every 4th field (always the same parity) goes to the application,
+	 * which is as many lines as it can draw.
+	 */
+	static constexpr size_t field_decimation = 4;
+
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 
-	std::array<complex16_t, 512> dst { };
-	const buffer_c16_t dst_buffer {
-		dst.data(),
-		dst.size()
-	};
+	TVSync tv_sync { };
 
-	AudioSpectrum audio_spectrum { };
-	TvCollector channel_spectrum { };
-        std::array<complex16_t, 256> spectrum { };
+	VideoLine fifo_data[1 << VideoLineConfigMessage::fifo_k] { };
+	VideoLineFIFO fifo { fifo_data, VideoLineConfigMessage::fifo_k };
 
+	bool streaming { false };
 	bool configured { false };
-	void configure(const WFMConfigureMessage& message);
 
+	void on_line(const VideoLine& line);
+
+	void set_streaming(const SpectrumStreamingConfigMessage& message);
+	void configure(const WFMConfigureMessage& message);
 };
 
 #endif/*__PROC_AM_TV_H__*/
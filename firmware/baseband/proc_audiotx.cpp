@@ -22,7 +22,6 @@
 
 #include "proc_audiotx.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
@@ -42,20 +41,12 @@ void AudioTXProcessor::execute(const buffer_c8_t& buffer){
 			}
 		}
 		
-		sample = tone_gen.process(audio_sample - 0x80);
-		
-		// FM
-		delta = sample * fm_delta;
-		
-		phase += delta;
-		sphase = phase + (64 << 24);
-		
-		re = sine_table_i8[(sphase & 0xFF000000U) >> 24];
-		im = sine_table_i8[(phase & 0xFF000000U) >> 24];
-		
-		buffer.p[i] = { (int8_t)re, (int8_t)im };
+		const int32_t sample = tone_gen.process(audio_sample - 0x80);
+		modulation[i] = __SSAT(sample, 8) << 8;
 	}
 	
+	fm.execute({ modulation.data(), buffer.count }, buffer);
+	
 	progress_samples += buffer.count;
 	if (progress_samples >= progress_interval_samples) {
 		progress_samples -= progress_interval_samples;
@@ -92,7 +83,7 @@ void AudioTXProcessor::on_message(const Message* const message) {
 }
 
 void AudioTXProcessor::audio_config(const AudioTXConfigMessage& message) {
-	fm_delta = message.deviation_hz * (0xFFFFFFULL / baseband_fs);
+	fm.set_deviation(message.deviation_hz, baseband_fs);
 	tone_gen.configure(message.tone_key_delta, message.tone_key_mix_weight);
 	progress_interval_samples = message.divider;
 	resample_acc = 0;
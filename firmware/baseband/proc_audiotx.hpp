@@ -26,6 +26,7 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 #include "tone_gen.hpp"
+#include "dsp_dds.hpp"
 #include "stream_output.hpp"
 
 class AudioTXProcessor : public BasebandProcessor {
@@ -43,12 +44,11 @@ private:
 	
 	ToneGen tone_gen { };
 	
+	std::array<int16_t, 2048> modulation { };
+	dsp::dds::FM fm { };
+	
 	uint32_t resample_inc { }, resample_acc { };
-	uint32_t fm_delta { 0 };
-	uint32_t phase { 0 }, sphase { 0 };
 	uint8_t audio_sample { };
-	int32_t sample { 0 }, delta { };
-	int8_t re { 0 }, im { 0 };
 	
 	size_t progress_interval_samples = 0 , progress_samples = 0;
 	
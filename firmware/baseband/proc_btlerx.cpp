@@ -26,296 +26,118 @@
 
 #include "event_m4.hpp"
 
-void BTLERxProcessor::execute(const buffer_c8_t& buffer) {
-	if (!configured) return;
-	
-	// FM demodulation
-
-	/*const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	const auto channel = decim_1.execute(decim_0_out, dst_buffer);
-
-	feed_channel_stats(channel);
-	
-	auto audio_oversampled = demod.execute(channel, work_audio_buffer);*/
-
-	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	feed_channel_stats(decim_0_out);
-	
-	auto audio_oversampled = demod.execute(decim_0_out, work_audio_buffer);
-
-	/*std::fill(spectrum.begin(), spectrum.end(), 0);
-	for(size_t i=0; i<spectrum.size(); i++) {
-		spectrum[i] += buffer.p[i];
+/* CRC-24, x^24 + x^10 + x^9 + x^6 + x^4 + x^3 + x + 1, shifted LSB first as
+ * on air, so the register is bit-reversed relative to the spec.
+ */
+static constexpr uint32_t crc_polynomial_reflected = 0xDA6000;
+static constexpr uint32_t crc_init_advertising = 0xAAAAAA;	// 0x555555 reversed
+
+static constexpr std::array<uint32_t, 256> make_crc_table() {
+	std::array<uint32_t, 256> table { };
+	for(size_t i=0; i<table.size(); i++) {
+		uint32_t crc = i;
+		for(size_t b=0; b<8; b++) {
+			crc = (crc & 1) ? ((crc >> 1) ^ crc_polynomial_reflected) : (crc >> 1);
+		}
+		table[i] = crc;
 	}
-	const buffer_c16_t buffer_c16 {spectrum.data(),spectrum.size(),buffer.sampling_rate};
-	feed_channel_stats(buffer_c16);
-	
-	auto audio_oversampled = demod.execute(buffer_c16, work_audio_buffer);*/
-	// Audio signal processing
-	for (size_t c = 0; c < audio_oversampled.count; c++) {
-
-		/*const int32_t sample_int = audio_oversampled.p[c] * 32768.0f;
-		int32_t current_sample = __SSAT(sample_int, 16);
-		current_sample /= 128;*/
-                
-		int32_t current_sample = audio_oversampled.p[c]; //if I directly use this, some results can pass crc but not correct.
-                rb_head++;
-	        rb_head=(rb_head)%RB_SIZE;
-
-                rb_buf[rb_head] = current_sample;
-
-		skipSamples = skipSamples - 1;
-
-
-		if (skipSamples<1)
-		{
-				
-
-			int32_t threshold_tmp=0;
-			for (int c=0;c<8;c++)
-			{
-				threshold_tmp = threshold_tmp + (int32_t)rb_buf[(rb_head+c)%RB_SIZE];
-			}
-			g_threshold = (int32_t)threshold_tmp/8;
-
-				
-			int transitions=0;
-			if (rb_buf[(rb_head+9)%RB_SIZE] > g_threshold)
-			{
-				for (int c=0;c<8;c++)
-				{
-					if (rb_buf[(rb_head + c)%RB_SIZE] > rb_buf[(rb_head + c + 1)%RB_SIZE])
-					transitions = transitions + 1;
-				}
-			}
-			else
-			{
-				for (int c=0;c<8;c++)
-				{
-					if (rb_buf[(rb_head + c)%RB_SIZE] < rb_buf[(rb_head + c + 1)%RB_SIZE])
-					transitions = transitions + 1;
-				}
-			}
-			
-			bool packet_detected=false;
-			//if ( transitions==4 && abs(g_threshold)<15500)
-			if ( transitions==4)
-			{
-
-				
-				uint8_t packet_data[500];
-				int packet_length;
-				uint32_t packet_crc;
-				//uint32_t calced_crc; // NOTE: restore when CRC is passing
-				uint64_t packet_addr_l;
-				//uint32_t result; // NOTE: restore when CRC is passing
-				uint8_t crc[3];
-				uint8_t packet_header_arr[2];
-
-				packet_addr_l=0;
-				for (int i=0;i<4;i++) 
-				{                   
-				    bool current_bit;
-				    uint8_t byte=0;
-				    for (int c=0;c<8;c++)
-				    {
-				        if (rb_buf[(rb_head + (i+1)*8 + c)%RB_SIZE] > g_threshold)
-				            current_bit = true;
-				        else
-				            current_bit = false;
-				        byte |= current_bit << (7-c);
-				    }
-				    uint8_t byte_temp = (uint8_t) (((byte * 0x0802LU & 0x22110LU) | (byte * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				    packet_addr_l|=((uint64_t)byte_temp)<<(8*i);
-				}
-
-				channel_number = 38;
-
-				
-				for (int t=0;t<2;t++)
-				{
-				    bool current_bit;
-				    uint8_t byte=0;
-				    for (int c=0;c<8;c++)
-				    {
-				        if (rb_buf[(rb_head + 5*8+t*8 + c)%RB_SIZE] > g_threshold)
-				            current_bit = true;
-				        else
-				            current_bit = false;
-				        byte |= current_bit << (7-c);
-				    }
-
-				    packet_header_arr[t] = byte;
-				}
-
-				
-
-				uint8_t byte_temp2 = (uint8_t) (((channel_number * 0x0802LU & 0x22110LU) | (channel_number * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				uint8_t lfsr_1 = byte_temp2 | 2;
-				int header_length = 2;
-				int header_counter = 0;
-				while(header_length--)
-				{
-				    for(uint8_t i = 0x80; i; i >>= 1)
-				    {
-				        if(lfsr_1 & 0x80)
-				        {
-				            lfsr_1 ^= 0x11;
-				            (packet_header_arr[header_counter]) ^= i;
-				        }
-				        lfsr_1 <<= 1;
-				    }
-				    header_counter = header_counter + 1;
-				}
-
-				
-
-				if (packet_addr_l==0x8E89BED6)
-				{  
-
-				    uint8_t byte_temp3 = (uint8_t) (((packet_header_arr[1] * 0x0802LU & 0x22110LU) | (packet_header_arr[1] * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				    packet_length=byte_temp3&0x3F;
-				
-				} 
-				else 
-				{
-				    packet_length=0;
-				}
-
-				for (int t=0;t<packet_length+2+3;t++)
-				{
-				    bool current_bit;
-				    uint8_t byte=0;
-				    for (int c=0;c<8;c++)
-				    {
-				        if (rb_buf[(rb_head + 5*8+t*8 + c)%RB_SIZE] > g_threshold)
-				            current_bit = true;
-				        else
-				            current_bit = false;
-				        byte |= current_bit << (7-c);
-				    }
-
-				    packet_data[t] = byte;
-				}
-
-				
+	return table;
+}
 
-				uint8_t byte_temp4 = (uint8_t) (((channel_number * 0x0802LU & 0x22110LU) | (channel_number * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				uint8_t lfsr_2 = byte_temp4 | 2;
-				int pdu_crc_length = packet_length+2+3;
-				int pdu_crc_counter = 0;
-				while(pdu_crc_length--)
-				{
-				    for(uint8_t i = 0x80; i; i >>= 1)
-				    {
-				        if(lfsr_2 & 0x80)
-				        {
-				            lfsr_2 ^= 0x11;
-				            (packet_data[pdu_crc_counter]) ^= i;
-				        }
-				        lfsr_2 <<= 1;
-				    }
-				    pdu_crc_counter = pdu_crc_counter + 1;
-				}
+static constexpr std::array<uint32_t, 256> crc_table = make_crc_table();
 
-				
+static uint32_t crc24(const uint8_t* const data, const size_t length) {
+	uint32_t crc = crc_init_advertising;
+	for(size_t i=0; i<length; i++) {
+		crc = (crc >> 8) ^ crc_table[(crc ^ data[i]) & 0xff];
+	}
+	return crc;
+}
 
-				if (packet_addr_l==0x8E89BED6)
-				{  
-				    crc[0]=crc[1]=crc[2]=0x55;
-				}
-				else 
-				{
-				    crc[0]=crc[1]=crc[2]=0;
-				}
+void BTLERxProcessor::execute(const buffer_c8_t& buffer) {
+	if (!configured) return;
 
-				uint8_t v, t, d, crc_length;
-				uint32_t crc_result=0;
-				crc_length = packet_length + 2;
-				int counter = 0;
-				while(crc_length--)
-				{
-				    uint8_t byte_temp5 = (uint8_t) (((packet_data[counter] * 0x0802LU & 0x22110LU) | (packet_data[counter] * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				    d = byte_temp5;
-				    for(v = 0; v < 8; v++, d >>= 1)
-				    {
-				        t = crc[0] >> 7;
-				        crc[0] <<= 1;
-				        if(crc[1] & 0x80) crc[0] |= 1;
-				        crc[1] <<= 1;
-				        if(crc[2] & 0x80) crc[1] |= 1;
-				        crc[2] <<= 1;
-				        if(t != (d & 1))
-				        {
-				            crc[2] ^= 0x5B;
-				            crc[1] ^= 0x06;
-				        }
-				    }
-				    counter = counter + 1;
-				}
-				for (v=0;v<3;v++) crc_result=(crc_result<<8)|crc[v];
-				//calced_crc = crc_result; // NOTE: restore when CRC is passing
+	/* 4MHz complex<int8_t>[2048]
+	 * -> Shift by -fs/4
+	 * -> 3rd order CIC decimation by 2
+	 * -> 2MHz complex<int16_t>[1024] */
+	const auto channel = decim_0.execute(buffer, dst_buffer);
+	feed_channel_stats(channel);
 
-				packet_crc=0;
-				for (int c=0;c<3;c++) packet_crc=(packet_crc<<8)|packet_data[packet_length+2+c];
+	/* -> FM demodulation
+	 * -> 2MHz int16_t[1024], 2 samples per bit */
+	const auto frequency = demod.execute(channel, work_demod_buffer);
 
-				if (packet_addr_l==0x8E89BED6)
-				//if (packet_crc==calced_crc) // NOTE: restore when CRC is passing
-				{
-				    uint8_t mac_data[6];
-				    int counter = 0;
-				    for (int i = 7; i >= 2; i--) 
-				    {
-				        uint8_t byte_temp6 = (uint8_t) (((packet_data[i] * 0x0802LU & 0x22110LU) | (packet_data[i] * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-					//result = byte_temp6; // NOTE: restore when CRC is passing
-					mac_data[counter] = byte_temp6; 
-					counter = counter + 1;
-				    }
+	for(size_t i=0; i<frequency.count; i++) {
+		const int32_t sample = frequency.p[i];
 
-				    data_message.is_data = false;
-			            data_message.value = 'A';
-				    shared_memory.application_queue.push(data_message);
+		if( state == State::Search ) {
+			search(sample);
+		} else if( sample_phase == packet_phase ) {
+			receive_bit(sample > threshold);
+		}
 
-				    data_message.is_data = true;
-			            data_message.value = mac_data[0];
-				    shared_memory.application_queue.push(data_message);
+		sample_phase = (sample_phase + 1) % samples_per_bit;
+	}
+}
 
-				    data_message.is_data = true;
-			            data_message.value = mac_data[1];
-				    shared_memory.application_queue.push(data_message);
+void BTLERxProcessor::search(const int32_t sample) {
+	const int32_t dc = dc_tracker(sample);
+
+	// Bits arrive LSB first, so shift in from the top.
+	auto& shift = correlator[sample_phase];
+	shift = (shift >> 1) | ((sample > dc) ? 0x80000000 : 0);
+
+	const size_t errors = __builtin_popcount(shift ^ btle::advertising_access_address);
+	if( errors <= access_address_errors_max ) {
+		state = State::Receive;
+		packet_phase = sample_phase;
+		threshold = dc;
+		current_byte = 0;
+		bit_count = 0;
+		byte_count = 0;
+		bytes_expected = btle::Packet::header_length;
+	}
+}
 
-				    data_message.is_data = true;
-			            data_message.value = mac_data[2];
-				    shared_memory.application_queue.push(data_message);
+void BTLERxProcessor::receive_bit(const uint32_t bit) {
+	current_byte |= bit << bit_count;
+	if( ++bit_count < 8 ) {
+		return;
+	}
 
-				    data_message.is_data = true;
-			            data_message.value = mac_data[3];
-				    shared_memory.application_queue.push(data_message);
+	pdu[byte_count] = current_byte ^ whitening[byte_count];
+	byte_count++;
+	current_byte = 0;
+	bit_count = 0;
 
-				    data_message.is_data = true;
-			            data_message.value = mac_data[4];
-				    shared_memory.application_queue.push(data_message);
+	if( byte_count == btle::Packet::header_length ) {
+		const size_t payload_length = pdu[1] & 0x3F;
+		bytes_expected = btle::Packet::header_length + payload_length + crc_length;
+	}
 
-				    data_message.is_data = true;
-			            data_message.value = mac_data[5];
-				    shared_memory.application_queue.push(data_message);
+	if( byte_count == bytes_expected ) {
+		packet_end();
+	}
+}
 
-				    data_message.is_data = false;
-			            data_message.value = 'B';
-				    shared_memory.application_queue.push(data_message);
+void BTLERxProcessor::packet_end() {
+	const size_t length = byte_count - crc_length;
+	const uint32_t packet_crc = pdu[length] | (pdu[length + 1] << 8) | (pdu[length + 2] << 16);
 
-				    packet_detected = true;
-				}
-				else
-				    packet_detected = false;
-			}
+	if( crc24(pdu.data(), length) == packet_crc ) {
+		btle::Packet packet;
+		packet.channel_number = channel_number;
+		packet.length = length;
+		std::copy(&pdu[0], &pdu[length], packet.pdu.begin());
 
-			if (packet_detected) 
-			{
-				skipSamples=20;
-			}
-		}
+		const BTLEPacketMessage message { packet };
+		shared_memory.application_queue.push(message);
 	}
+
+	// Don't let the tail of this packet re-trigger the correlator.
+	correlator.fill(0);
+	state = State::Search;
 }
 
 void BTLERxProcessor::on_message(const Message* const message) {
@@ -323,12 +145,30 @@ void BTLERxProcessor::on_message(const Message* const message) {
 		configure(*reinterpret_cast<const BTLERxConfigureMessage*>(message));
 }
 
-void BTLERxProcessor::configure(const BTLERxConfigureMessage& message) {	
-	(void)message; //avoid warning
-	decim_0.configure(taps_200k_wfm_decim_0.taps, 33554432);
-	decim_1.configure(taps_200k_wfm_decim_1.taps, 131072);
-	demod.configure(audio_fs, 5000);
+void BTLERxProcessor::configure(const BTLERxConfigureMessage& message) {
+	channel_number = message.channel_number;
+
+	/* Whitening LFSR x^7 + x^4 + 1, position 0 set to 1 and positions 1..6
+	 * to the channel index (held bit-reversed here). Precomputed as one XOR
+	 * byte per PDU byte, in the same LSB-first order as the received bytes.
+	 */
+	const uint8_t channel_reversed = ((channel_number * 0x0802LU & 0x22110LU) | (channel_number * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16;
+	uint8_t lfsr = channel_reversed | 2;
+	for(auto& w : whitening) {
+		w = 0;
+		for(size_t b=0; b<8; b++) {
+			if( lfsr & 0x80 ) {
+				lfsr ^= 0x11;
+				w |= 1 << b;
+			}
+			lfsr <<= 1;
+		}
+	}
+
+	demod.configure(demod_fs, 500000);
 
+	correlator.fill(0);
+	state = State::Search;
 	configured = true;
 }
 
@@ -30,12 +30,20 @@
 
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
+#include "dsp_fsk_slicer.hpp"
 
-#include "audio_output.hpp"
-
-#include "fifo.hpp"
+#include "btle_packet.hpp"
 #include "message.hpp"
 
+#include <array>
+
+/* BLE 1M PHY advertising receiver.
+ * 4MHz complex baseband (tuned fs/4 low) is shifted to DC, decimated to 2
+ * samples per bit and FM demodulated a block at a time. Each sample phase
+ * feeds its own 32-bit shift register which is compared to the advertising
+ * access address; the phase that hits is then sliced against the DC level
+ * latched during the access address.
+ */
 class BTLERxProcessor : public BasebandProcessor {
 public:
 	void execute(const buffer_c8_t& buffer) override;
@@ -44,52 +52,61 @@ public:
 	
 private:
 	static constexpr size_t baseband_fs = 4000000;
-	static constexpr size_t audio_fs = baseband_fs / 8 / 8 / 2;
-	
+	static constexpr size_t demod_fs = baseband_fs / 2;
+	static constexpr size_t samples_per_bit = demod_fs / 1000000;
+
+	// Bit errors tolerated in the access address, CRC rejects false hits.
+	static constexpr size_t access_address_errors_max = 1;
+	// DC tracker time constant, 2^5 samples = 16 bits.
+	static constexpr size_t dc_shift = 5;
+
+	static constexpr size_t crc_length = 3;
+	static constexpr size_t pdu_length_max = btle::Packet::header_length + btle::Packet::payload_length_max + crc_length;
+
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 	
-	std::array<complex16_t, 512> dst { };
+	std::array<complex16_t, 1024> dst { };
 	const buffer_c16_t dst_buffer {
 		dst.data(),
 		dst.size()
 	};
 
-        std::array<complex16_t, 512> spectrum { };
-	const buffer_c16_t spectrum_buffer {
-		spectrum.data(),
-		spectrum.size()
-	};
-
-	const buffer_s16_t work_audio_buffer {
+	const buffer_s16_t work_demod_buffer {
 		(int16_t*)dst.data(),
 		sizeof(dst) / sizeof(int16_t)
 	};
 
+	dsp::decimate::TranslateByFSOver4AndDecimateBy2CIC3 decim_0 { };
+	dsp::demodulate::FM demod { };
 
-	// Array size ok down to 375 bauds (24000 / 375)
-	std::array<int32_t, 64> delay_line { 0 };
-	std::array<int16_t, 1000> rb_buf { 0 };
+	enum class State {
+		Search,
+		Receive,
+	};
 
-	/*dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
-	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::decimate::FIRAndDecimateComplex channel_filter { };*/
-	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
-	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
-	
-	dsp::demodulate::FM demod { };
-	int rb_head {-1};
-	int32_t g_threshold {0};  
-	uint8_t channel_number {38};
-	int skipSamples {1000};
-	int RB_SIZE {1000};
+	State state { State::Search };
+	size_t sample_phase { 0 };
+	std::array<uint32_t, samples_per_bit> correlator { };
+	dsp::fsk::DCTracker dc_tracker { dc_shift };
+
+	size_t packet_phase { 0 };
+	int32_t threshold { 0 };
+	uint32_t current_byte { 0 };
+	size_t bit_count { 0 };
+	size_t byte_count { 0 };
+	size_t bytes_expected { 0 };
+	std::array<uint8_t, pdu_length_max> pdu { };
+
+	uint8_t channel_number { 37 };
+	std::array<uint8_t, pdu_length_max> whitening { };
 
 	bool configured { false };
 
-	
 	void configure(const BTLERxConfigureMessage& message);
-	
-	AFSKDataMessage data_message { false, 0 };
+	void search(const int32_t sample);
+	void receive_bit(const uint32_t bit);
+	void packet_end();
 };
 
 #endif/*__PROC_BTLERX_H__*/
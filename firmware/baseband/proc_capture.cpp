@@ -43,8 +43,17 @@ void CaptureProcessor::execute(const buffer_c8_t& buffer) {
 	const auto& channel = decimator_out;
 
 	if( stream ) {
-		const size_t bytes_to_write = sizeof(*decimator_out.p) * decimator_out.count;
-		const size_t written = stream->write(decimator_out.p, bytes_to_write);
+		// The file's format is fixed by its metadata, so every block must be encoded.
+		static_assert(iq::encoded_size(iq::Format::C8, decimator_out_max) <= sizeof(encoded), "encoded too small for C8");
+		static_assert(iq::encoded_size(iq::Format::BlockFloat, decimator_out_max) <= sizeof(encoded), "encoded too small for BlockFloat");
+
+		const void* data = decimator_out.p;
+		size_t bytes_to_write = sizeof(*decimator_out.p) * decimator_out.count;
+		if( format != iq::Format::C16 ) {
+			bytes_to_write = iq::encode(format, decimator_out.p, decimator_out.count, encoded.data());
+			data = encoded.data();
+		}
+		const size_t written = stream->write(data, bytes_to_write);
 		if( written != bytes_to_write )
 		{
 			//TODO eventually report error somewhere
@@ -99,6 +108,7 @@ void CaptureProcessor::samplerate_config(const SamplerateConfigMessage& message)
 
 void CaptureProcessor::capture_config(const CaptureConfigMessage& message) {
 	if( message.config ) {
+		format = message.config->format;
 		stream = std::make_unique<StreamInput>(message.config);
 	} else {
 		stream.reset();
@@ -34,6 +34,7 @@
 #include "stream_input.hpp"
 
 #include <array>
+#include <algorithm>
 #include <memory>
 
 class CaptureProcessor : public BasebandProcessor {
@@ -52,7 +53,9 @@ private:
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 
-	std::array<complex16_t, 512> dst { };
+	static constexpr size_t dst_samples = 512;
+
+	std::array<complex16_t, dst_samples> dst { };
 	const buffer_c16_t dst_buffer {
 		dst.data(),
 		dst.size()
@@ -60,11 +63,21 @@ private:
 
 	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
 	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
+
+	// decim_1 works within dst, so it never returns more samples than this.
+	static constexpr size_t decimator_out_max = dst_samples / dsp::decimate::FIRC16xR16x16Decim2::decimation_factor;
 	int32_t channel_filter_low_f = 0;
 	int32_t channel_filter_high_f = 0;
 	int32_t channel_filter_transition = 0;
 
 	std::unique_ptr<StreamInput> stream { };
+	iq::Format format { iq::Format::C16 };
+
+	// Compressed formats are staged here, C16 is written straight from dst.
+	std::array<uint8_t, std::max(
+		iq::encoded_size(iq::Format::C8, decimator_out_max),
+		iq::encoded_size(iq::Format::BlockFloat, decimator_out_max)
+	)> encoded { };
 
 	SpectrumCollector channel_spectrum { };
 	size_t spectrum_interval_samples = 0;
@@ -51,41 +51,9 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
 		audio_output.write(audio);
 		
 		if (ctcss_detect_enabled) {
-			/* 24kHz int16_t[16]
-			 * -> FIR filter, <300Hz pass, >300Hz stop, gain of 1
-			 * -> 12kHz int16_t[8] */
-			auto audio_ctcss = ctcss_filter.execute(audio, work_audio_buffer);
-			
-			// s16 to f32 for hpf
-			std::array<float, 8> audio_f;
-			for (size_t i = 0; i < audio_ctcss.count; i++) {
-				audio_f[i] = audio_ctcss.p[i] * ki;
-			}
-			
-			hpf.execute_in_place(buffer_f32_t {
-				audio_f.data(),
-				audio_ctcss.count,
-				audio_ctcss.sampling_rate
-				});
-			
-			// Zero-crossing detection
-			for (size_t c = 0; c < audio_ctcss.count; c++) {
-				cur_sample = audio_f[c];
-				if (cur_sample * prev_sample < 0.0) {
-					z_acc += z_timer;
-					z_timer = 0;
-					z_count++;
-				} else
-					z_timer++;
-				prev_sample = cur_sample;
-			}
-			
-			if (z_count >= 30) {
-				ctcss_message.value = (100 * 12000 / 2 * z_count) / z_acc;
-				shared_memory.application_queue.push(ctcss_message);
-				z_count = 0;
-				z_acc = 0;
-			}
+			tone_detector.execute(audio, [](const CodedSquelchMessage& message) {
+				shared_memory.application_queue.push(message);
+			});
 		}
 	} else {
 		// Direction-finding mode; output tone with pitch related to RSSI
@@ -151,8 +119,7 @@ void NarrowbandFMAudio::configure(const NBFMConfigureMessage& message) {
 	channel_spectrum.set_decimation_factor(1.0f);
 	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config, (float)message.squelch_level / 100.0);
 	
-	hpf.configure(audio_24k_hpf_30hz_config);
-	ctcss_filter.configure(taps_64_lp_025_025.taps);
+	tone_detector.configure(demod_input_fs);
 
 	configured = true;
 }
@@ -29,7 +29,7 @@
 
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
-#include "dsp_iir.hpp"
+#include "tone_detector.hpp"
 
 #include "audio_output.hpp"
 #include "spectrum_collector.hpp"
@@ -53,10 +53,6 @@ private:
 		dst.data(),
 		dst.size()
 	};
-	const buffer_s16_t work_audio_buffer {
-		(int16_t*)dst.data(),
-		sizeof(dst) / sizeof(int16_t)
-	};
 	
 	std::array<int16_t, 16> audio { };
 	const buffer_s16_t audio_buffer {
@@ -77,9 +73,7 @@ private:
 	int32_t channel_filter_high_f = 0;
 	int32_t channel_filter_transition = 0;
 	
-	// For CTCSS decoding
-	dsp::decimate::FIR64AndDecimateBy2Real ctcss_filter { };
-	IIRBiquadFilter hpf { };
+	ToneDetector tone_detector { };
 
 	dsp::demodulate::FM demod { };
 
@@ -91,11 +85,7 @@ private:
 	uint32_t tone_delta { 0 };
 	bool pitch_rssi_enabled { false };
 	
-	float cur_sample { }, prev_sample { };
-	uint32_t z_acc { 0}, z_timer { 0 }, z_count { 0 };
 	bool ctcss_detect_enabled { true };
-	static constexpr float k = 32768.0f;
-	static constexpr float ki = 1.0f / k;
 
 	bool configured { false };
 	void pitch_rssi_config(const PitchRSSIConfigureMessage& message);
@@ -103,7 +93,6 @@ private:
 	void capture_config(const CaptureConfigMessage& message);
 	
 	//RequestSignalMessage sig_message { RequestSignalMessage::Signal::Squelched };
-	CodedSquelchMessage ctcss_message { 0 };
 };
 
 #endif/*__PROC_NFM_AUDIO_H__*/
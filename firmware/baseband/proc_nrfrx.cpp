@@ -26,240 +26,143 @@
 
 #include "event_m4.hpp"
 
+#include <algorithm>
+
 void NRFRxProcessor::execute(const buffer_c8_t& buffer) {
 	if (!configured) return;
 	
-	// FM demodulation
-
+	/* 4MHz complex<int8_t>[2048]
+	 * -> Shift by -fs/4, FIR decimation by 4
+	 * -> 1MHz complex<int16_t>[512] */
 	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
 	feed_channel_stats(decim_0_out);
 	
-	auto audio_oversampled = demod.execute(decim_0_out, work_audio_buffer);
-	// Audio signal processing
-	for (size_t c = 0; c < audio_oversampled.count; c++) {
-                int g_srate = 4; //4 for 250KPS
-		//int g_srate = 1; //1 for 1MPS, not working yet
-		int32_t current_sample = audio_oversampled.p[c]; //if I directly use this, some results can pass crc but not correct.
-                rb_head++;
-	        rb_head=(rb_head)%RB_SIZE;
-
-                rb_buf[rb_head] = current_sample;
+	/* -> FM demodulation
+	 * -> 1MHz int16_t[512], 4 samples per bit */
+	const auto frequency = demod.execute(decim_0_out, work_demod_buffer);
 
-		skipSamples = skipSamples - 1;
+	slicer.execute(frequency,
+		[this](const uint_fast8_t bit) {
+			this->on_bit(bit);
+		}
+	);
+}
 
-		if (skipSamples<1)
-		{
-			int32_t threshold_tmp=0;
-			for (int c=0;c<8*g_srate;c++)
-			{
-				threshold_tmp = threshold_tmp + (int32_t)rb_buf[(rb_head+c)%RB_SIZE];
-			}
+void NRFRxProcessor::on_bit(const uint_fast8_t bit) {
+	if( state == State::Search ) {
+		/* Preamble alternates and runs into the first address bit, so nine
+		 * alternating bits in a row. That ninth bit is kept.
+		 */
+		search_bits = (search_bits << 1) | bit;
+		const auto pattern = search_bits & 0x1ff;
+		if( (pattern == 0x155) || (pattern == 0x0aa) ) {
+			state = State::Receive;
+			slicer.set_dc_hold(true);
+			packet_bits.fill(0);
+			packet_bits[0] = bit << 7;
+			bit_count = 1;
+			bits_expected = alignments - 1 + header_bits;
+		}
+		return;
+	}
 
-			g_threshold = (int32_t)threshold_tmp/(8*g_srate);
-	
-			int transitions=0;
-			if (rb_buf[(rb_head + 9*g_srate)%RB_SIZE] > g_threshold)
-			{
-				for (int c=0;c<8;c++)
-				{
-					if (rb_buf[(rb_head + c*g_srate)%RB_SIZE] > rb_buf[(rb_head + (c+1)*g_srate)%RB_SIZE])
-						transitions = transitions + 1;
-				}
-			}
-			else
-			{
-				for (int c=0;c<8;c++)
-				{
-					if (rb_buf[(rb_head + c*g_srate)%RB_SIZE] < rb_buf[(rb_head + (c+1)*g_srate)%RB_SIZE])
-						transitions = transitions + 1;
-				}
+	if( bit ) {
+		packet_bits[bit_count >> 3] |= 0x80 >> (bit_count & 7);
+	}
+	bit_count++;
+
+	if( bit_count == (alignments - 1 + header_bits) ) {
+		// Packet control field: 6 bit length, 2 bit PID, no-ack flag
+		bits_expected = 0;
+		for(size_t offset=0; offset<alignments; offset++) {
+			const size_t payload_length = read_bits(offset + address_length * 8, 6);
+			if( payload_length > payload_length_max ) {
+				alignment_bits[offset] = 0;
+				continue;
 			}
-			
-			bool packet_detected=false;
-			//if ( transitions==4 && abs(g_threshold)<15500)
-			if ( transitions==4 && abs(g_threshold)<15500)
-			{
-				int packet_length = 0;
-				uint8_t tmp_buf[10];
-				uint8_t packet_data[500];
-				uint8_t packet_packed[50];
-				uint16_t pcf;
-				uint32_t packet_crc;
-				uint32_t calced_crc;
-				uint64_t packet_addr_l;
-
-				/* extract address */
-				packet_addr_l=0;
-
-				for (int t=0;t<5;t++)
-				{
-					bool current_bit;
-					uint8_t byte=0;
-					for (int c=0;c<8;c++) 
-					{
-						if (rb_buf[(rb_head+(1*8+t*8+c)*g_srate)%RB_SIZE] > g_threshold)
-							current_bit = true;
-						else
-							current_bit = false;
-						byte |= current_bit << (7-c);
-					}
-					tmp_buf[t]=byte;
-				}
-
-				for (int t=0;t<5;t++) packet_addr_l|=((uint64_t)tmp_buf[t])<<(4-t)*8;
-
-				//channel_number = 26;
-
-				
-				/* extract pcf */
-				for (int t=0;t<2;t++)
-				{
-					bool current_bit;
-					uint8_t byte=0;
-					for (int c=0;c<8;c++) 
-					{
-						if (rb_buf[(rb_head+(6*8+t*8+c)*g_srate)%RB_SIZE] > g_threshold)
-							current_bit = true;
-						else
-							current_bit = false;
-						byte |= current_bit << (7-c);
-					}
-					tmp_buf[t]=byte;
-				}
-
-				pcf = tmp_buf[0]<<8 | tmp_buf[1];
-				pcf >>=7;
-
-				/* extract packet length, avoid excessive length packets */
-				if(packet_length == 0)
-					packet_length=(int)pcf>>3;
-				if (packet_length>32) 
-					packet_detected = false;
-
-				/* extract data */
-				for (int t=0;t<packet_length;t++)
-				{
-					bool current_bit;
-					uint8_t byte=0;
-					for (int c=0;c<8;c++) 
-					{
-						if (rb_buf[(rb_head+(6*8+9+t*8+c)*g_srate)%RB_SIZE] > g_threshold)
-							current_bit = true;
-						else
-							current_bit = false;
-						byte |= current_bit << (7-c);
-					}
-					packet_data[t]=byte;
-				}
-
-				/* Prepare packed bit stream for CRC calculation */
-				uint64_t packet_header=packet_addr_l;
-				packet_header<<=9;
-				packet_header|=pcf;
-				for (int c=0;c<7;c++){
-					packet_packed[c]=(packet_header>>((6-c)*8))&0xFF;
-				}
-
-				for (int c=0;c<packet_length;c++){
-					packet_packed[c+7]=packet_data[c];
-				}
-
-				/* calculate packet crc */
-				const uint8_t* data = packet_packed; 
-				size_t data_len =  7+packet_length;
-				bool bit;
-				uint8_t cc;
-				uint_fast16_t crc=0x3C18;
-				while (data_len--) {
-				cc = *data++;
-				for (uint8_t i = 0x80; i > 0; i >>= 1) 
-				{
-					bit = crc & 0x8000;
-					if (cc & i) 
-					{
-						bit = !bit;
-					}
-					crc <<= 1;
-					if (bit) 
-					{
-						crc ^= 0x1021;
-					}
-				}
-					crc &= 0xffff;
-				}
-				calced_crc = (uint16_t)(crc & 0xffff);
+			alignment_bits[offset] = offset + header_bits + payload_length * 8 + crc_bits;
+			bits_expected = std::max(bits_expected, alignment_bits[offset]);
+		}
+		if( bits_expected == 0 ) {
+			packet_end();
+		}
+		return;
+	}
 
-				/* extract crc */
-				for (int t=0;t<2;t++)
-				{
-					bool current_bit;
-					uint8_t byte=0;
-					for (int c=0;c<8;c++) 
-					{
-						if (rb_buf[(rb_head+((6+packet_length)*8+9+t*8+c)*g_srate)%RB_SIZE] > g_threshold)
-							current_bit = true;
-						else
-							current_bit = false;
-						byte |= current_bit << (7-c);
-					}
-					tmp_buf[t]=byte;
-				}
-				packet_crc = tmp_buf[0]<<8 | tmp_buf[1];
+	if( bit_count < (alignments - 1 + header_bits) ) {
+		return;
+	}
 
-				/* NRF24L01+ packet found, dump information */
-				//if (packet_addr_l==0xE7E7E7E7)
-				if (packet_crc==calced_crc)
-				{
-					data_message.is_data = false;
-					data_message.value = 'A';
-					shared_memory.application_queue.push(data_message);
+	for(size_t offset=0; offset<alignments; offset++) {
+		if( bit_count == alignment_bits[offset] ) {
+			const size_t data_bits = alignment_bits[offset] - offset - crc_bits;
+			if( crc_ok(offset, data_bits) ) {
+				send_packet(offset, data_bits);
+				packet_end();
+				return;
+			}
+		}
+	}
 
-					data_message.is_data = true;
-					data_message.value = packet_addr_l;
-					shared_memory.application_queue.push(data_message);
+	if( bit_count == bits_expected ) {
+		packet_end();
+	}
+}
 
-					for (int c=0;c<7;c++)
-					{
-						data_message.is_data = true;
-						data_message.value = packet_addr_l >> 8;
-						shared_memory.application_queue.push(data_message);
-					}
-					/*data_message.is_data = true;
-					data_message.value = packet_addr_l;
-					shared_memory.application_queue.push(data_message);
+bool NRFRxProcessor::crc_ok(const size_t position, const size_t data_bits) const {
+	// CRC-16-CCITT over address, PCF and payload, MSB first
+	uint16_t crc = 0xffff;
+	for(size_t i=position; i<(position + data_bits); i++) {
+		const uint16_t data_bit = read_bits(i, 1);
+		const bool feedback = ((crc >> 15) ^ data_bit) & 1;
+		crc <<= 1;
+		if( feedback ) {
+			crc ^= 0x1021;
+		}
+	}
 
-					data_message.is_data = true;
-					data_message.value = packet_addr_l >> 8;
-					shared_memory.application_queue.push(data_message);*/
+	return crc == read_bits(position + data_bits, crc_bits);
+}
 
-					data_message.is_data = false;
-					data_message.value = 'B';
-					shared_memory.application_queue.push(data_message);
+void NRFRxProcessor::send_packet(const size_t position, const size_t data_bits) {
+	data_message.is_data = false;
+	data_message.value = 'A';
+	shared_memory.application_queue.push(data_message);
 
-					for (int c=0;c<packet_length;c++)
-					{
-						data_message.is_data = true;
-						data_message.value = packet_data[c];
-						shared_memory.application_queue.push(data_message);
-					}
+	for(size_t i=0; i<address_length; i++) {
+		data_message.is_data = true;
+		data_message.value = read_bits(position + i * 8, 8);
+		shared_memory.application_queue.push(data_message);
+	}
 
-					data_message.is_data = false;
-					data_message.value = 'C';
-					shared_memory.application_queue.push(data_message);
+	data_message.is_data = false;
+	data_message.value = 'B';
+	shared_memory.application_queue.push(data_message);
 
+	const size_t payload_length = (data_bits - header_bits) / 8;
+	for(size_t i=0; i<payload_length; i++) {
+		data_message.is_data = true;
+		data_message.value = read_bits(position + header_bits + i * 8, 8);
+		shared_memory.application_queue.push(data_message);
+	}
 
-					packet_detected = true;
-				}
-				else
-					packet_detected = false;
-			}
+	data_message.is_data = false;
+	data_message.value = 'C';
+	shared_memory.application_queue.push(data_message);
+}
 
-			if (packet_detected) 
-			{
-				skipSamples=20;
-			}
-		}
+uint32_t NRFRxProcessor::read_bits(const size_t position, const size_t length) const {
+	uint32_t value = 0;
+	for(size_t i=position; i<(position + length); i++) {
+		value = (value << 1) | ((packet_bits[i >> 3] >> (7 - (i & 7))) & 1);
 	}
+	return value;
+}
+
+void NRFRxProcessor::packet_end() {
+	state = State::Search;
+	search_bits = 0;
+	slicer.set_dc_hold(false);
 }
 
 void NRFRxProcessor::on_message(const Message* const message) {
@@ -268,11 +171,12 @@ void NRFRxProcessor::on_message(const Message* const message) {
 }
 
 void NRFRxProcessor::configure(const NRFRxConfigureMessage& message) {	
-	(void)message; //avoir unused warning
+	(void)message; // Modem settings don't apply, nRF24 rate is fixed here
 	decim_0.configure(taps_200k_wfm_decim_0.taps, 33554432);
-	decim_1.configure(taps_200k_wfm_decim_1.taps, 131072);
-	demod.configure(audio_fs, 5000);
+	demod.configure(demod_fs, 250000);
+	slicer.configure(demod_fs, symbol_rate);
 
+	state = State::Search;
 	configured = true;
 }
 
@@ -30,12 +30,17 @@
 
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
+#include "dsp_fsk_slicer.hpp"
 
-#include "audio_output.hpp"
-
-#include "fifo.hpp"
 #include "message.hpp"
 
+#include <array>
+
+/* nRF24L01+ Enhanced ShockBurst receiver, 250kbps.
+ * Packets are found by their alternating preamble, 5 byte address assumed,
+ * and only sent to the application if the CRC-16 checks at one of a few bit
+ * offsets from the preamble match.
+ */
 class NRFRxProcessor : public BasebandProcessor {
 public:
 	void execute(const buffer_c8_t& buffer) override;
@@ -44,7 +49,19 @@ public:
 	
 private:
 	static constexpr size_t baseband_fs = 4000000;
-	static constexpr size_t audio_fs = baseband_fs / 8 / 8 / 2;
+	static constexpr size_t demod_fs = baseband_fs / 4;
+	static constexpr size_t symbol_rate = 250000;
+
+	static constexpr size_t address_length = 5;
+	static constexpr size_t payload_length_max = 32;
+	static constexpr size_t header_bits = address_length * 8 + 9;
+	static constexpr size_t crc_bits = 16;
+
+	/* The preamble match fires early whenever the bits before it happen to
+	 * alternate as well, by one bit half of the time, by two a quarter of
+	 * the time... so each packet is tried at this many bit offsets.
+	 */
+	static constexpr size_t alignments = 4;
 	
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
@@ -55,40 +72,35 @@ private:
 		dst.size()
 	};
 
-        std::array<complex16_t, 512> spectrum { };
-	const buffer_c16_t spectrum_buffer {
-		spectrum.data(),
-		spectrum.size()
-	};
-
-	const buffer_s16_t work_audio_buffer {
+	const buffer_s16_t work_demod_buffer {
 		(int16_t*)dst.data(),
 		sizeof(dst) / sizeof(int16_t)
 	};
 
-
-	// Array size ok down to 375 bauds (24000 / 375)
-	std::array<int32_t, 64> delay_line { 0 };
-	std::array<int16_t, 1000> rb_buf { 0 };
-
-	/*dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
-	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::decimate::FIRAndDecimateComplex channel_filter { };*/
 	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
-	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
-	
 	dsp::demodulate::FM demod { };
-	int rb_head {-1};
-	int32_t g_threshold {0};  
-	//uint8_t g_srate {8}; 
-	uint8_t channel_number {38};
-	int skipSamples {1000};
-	int RB_SIZE {1000};
+	dsp::fsk::BitSlicer<dsp::fsk::GardnerDetector> slicer { };
+
+	enum class State {
+		Search,
+		Receive,
+	};
+
+	State state { State::Search };
+	uint32_t search_bits { 0 };
+	size_t bit_count { 0 };
+	size_t bits_expected { 0 };
+	std::array<size_t, alignments> alignment_bits { };	// Packet end at each offset, 0 if invalid
+	std::array<uint8_t, (alignments - 1 + header_bits + payload_length_max * 8 + crc_bits + 7) / 8> packet_bits { };
 
 	bool configured { false };
 
-	
 	void configure(const NRFRxConfigureMessage& message);
+	void on_bit(const uint_fast8_t bit);
+	uint32_t read_bits(const size_t position, const size_t length) const;
+	bool crc_ok(const size_t position, const size_t data_bits) const;
+	void send_packet(const size_t position, const size_t data_bits);
+	void packet_end();
 	
 	AFSKDataMessage data_message { false, 0 };
 };
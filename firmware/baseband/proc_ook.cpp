@@ -22,14 +22,11 @@
 
 #include "proc_ook.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
 
 void OOKProcessor::execute(const buffer_c8_t& buffer) {
-	int8_t re, im;
-	
 	// This is called at 2.28M/2048 = 1113Hz
 	
 	if (!configured) return;
@@ -80,18 +77,11 @@ void OOKProcessor::execute(const buffer_c8_t& buffer) {
 			s--;
 		}
 		
-		if (cur_bit) {
-			phase = (phase + 200);			// What ?
-			sphase = phase + (64 << 18);
-
-			re = (sine_table_i8[(sphase & 0x03FC0000) >> 18]);
-			im = (sine_table_i8[(phase & 0x03FC0000) >> 18]);
-		} else {
-			re = 0;
-			im = 0;
-		}
-	
-		buffer.p[i] = {re, im};
+		// Plain carrier, keyed
+		if (cur_bit)
+			buffer.p[i] = { 127, 0 };
+		else
+			buffer.p[i] = { 0, 0 };
 	}
 }
 
@@ -28,6 +28,8 @@
 
 #include "utility.hpp"
 
+#include <algorithm>
+
 ReplayProcessor::ReplayProcessor() {
 	channel_filter_low_f = taps_200k_decim_1.low_frequency_normalized * 1000000;
 	channel_filter_high_f = taps_200k_decim_1.high_frequency_normalized * 1000000;
@@ -45,27 +47,13 @@ void ReplayProcessor::execute(const buffer_c8_t& buffer) {
 	
 	if (!configured) return;
 	
-	// File data is in C16 format, we need C8
-	// File samplerate is 500kHz, we're at 4MHz
-	// iq_buffer can only be 512 C16 samples (RAM limitation)
-	// To fill up the 2048-sample C8 buffer, we need:
-	// 2048 samples * 2 bytes per sample = 4096 bytes
-	// Since we're oversampling by 4M/500k = 8, we only need 2048/8 = 256 samples from the file and duplicate them 8 times each
-	// So 256 * 4 bytes per sample (C16) = 1024 bytes from the file
+	// The file is read in blocks of iq.size() samples, decoded to C16 and
+	// interpolated up to the baseband rate, however many file samples that takes.
+	underrun = false;
 	if( stream ) {
-		const size_t bytes_to_read = sizeof(*buffer.p) * 2 * (buffer.count / 8);	// *2 (C16), /8 (oversampling) should be == 1024
-		bytes_read += stream->read(iq_buffer.p, bytes_to_read);
-	}
-	
-	// Fill and "stretch"
-	for (size_t i = 0; i < buffer.count; i++) {
-		if (i & 3) {
-			buffer.p[i] = buffer.p[i - 1];
-		} else {
-			auto re_out = iq_buffer.p[i >> 3].real() >> 8;
-			auto im_out = iq_buffer.p[i >> 3].imag() >> 8;
-			buffer.p[i] = { (int8_t)re_out, (int8_t)im_out };
-		}
+		resampler.execute(buffer, [this]() { return this->next_sample(); });
+	} else {
+		std::fill(buffer.p, buffer.p + buffer.count, complex8_t { 0, 0 });
 	}
 	
 	spectrum_samples += buffer.count;
@@ -79,6 +67,41 @@ void ReplayProcessor::execute(const buffer_c8_t& buffer) {
 	}
 }
 
+complex16_t ReplayProcessor::next_sample() {
+	if( iq_index >= iq.size() ) {
+		if( !fill_input() ) {
+			return { 0, 0 };
+		}
+	}
+	return iq[iq_index++];
+}
+
+bool ReplayProcessor::fill_input() {
+	// Once the FIFO has run dry, send silence for the rest of this buffer.
+	if( underrun ) {
+		return false;
+	}
+
+	/* A short read leaves the bytes it got at the start of iq and the rest
+	 * is picked up on the next attempt, so the file stays sample aligned
+	 * through underruns.
+	 */
+	const size_t bytes_to_read = iq::encoded_size(format, iq.size());
+	const auto p = reinterpret_cast<uint8_t*>(iq.data());
+	const size_t bytes = stream->read(&p[iq_bytes], bytes_to_read - iq_bytes);
+	bytes_read += bytes;
+	iq_bytes += bytes;
+	if( iq_bytes < bytes_to_read ) {
+		underrun = true;
+		return false;
+	}
+
+	iq::decode(format, iq.data(), iq.size());
+	iq_bytes = 0;
+	iq_index = 0;
+	return true;
+}
+
 void ReplayProcessor::on_message(const Message* const message) {
 	switch(message->id) {
 	case Message::ID::UpdateSpectrum:
@@ -110,11 +133,22 @@ void ReplayProcessor::samplerate_config(const SamplerateConfigMessage& message)
 	baseband_fs = message.sample_rate;
 	baseband_thread.set_sampling_rate(baseband_fs);
 	spectrum_interval_samples = baseband_fs / spectrum_rate_hz;
+	configure_resampler();
+}
+
+void ReplayProcessor::configure_resampler() {
+	// Files without a rate were recorded at 1/8 of the baseband rate.
+	resampler.configure(file_fs ? file_fs : (baseband_fs / 8), baseband_fs);
+	iq_index = iq.size();
+	iq_bytes = 0;
 }
 
 void ReplayProcessor::replay_config(const ReplayConfigMessage& message) {
 	if( message.config ) {
 		
+		format = message.config->format;
+		file_fs = message.config->sample_rate;
+		configure_resampler();
 		stream = std::make_unique<StreamOutput>(message.config);
 		
 		// Tell application that the buffers and FIFO pointers are ready, prefill
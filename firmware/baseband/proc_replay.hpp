@@ -26,6 +26,7 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 
+#include "polyphase_resampler.hpp"
 #include "spectrum_collector.hpp"
 
 #include "stream_output.hpp"
@@ -59,6 +60,13 @@ private:
 	int32_t channel_filter_transition = 0;
 
 	std::unique_ptr<StreamOutput> stream { };
+	iq::Format format { iq::Format::C16 };
+	uint32_t file_fs { 0 };
+
+	dsp::interpolation::PolyphaseResampler resampler { };
+	size_t iq_index { 0 };
+	size_t iq_bytes { 0 };
+	bool underrun { false };
 
 	SpectrumCollector channel_spectrum { };
 	size_t spectrum_interval_samples = 0;
@@ -69,6 +77,9 @@ private:
 
 	void samplerate_config(const SamplerateConfigMessage& message);
 	void replay_config(const ReplayConfigMessage& message);
+	void configure_resampler();
+	complex16_t next_sample();
+	bool fill_input();
 	
 	TXProgressMessage txprogress_message { };
 	RequestSignalMessage sig_message { RequestSignalMessage::Signal::FillRequest };
@@ -22,7 +22,6 @@
 
 #include "proc_siggen.hpp"
 #include "portapack_shared_memory.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
@@ -39,49 +38,44 @@ void SigGenProcessor::execute(const buffer_c8_t& buffer) {
 		} else
 			sample_count--;
 		
-		if (tone_shape == 0) {
-			// CW
-			re = 127;
-			im = 0;
-		} else {
-			
-			if (tone_shape == 1) {
-				// Sine
-				sample = (sine_table_i8[(tone_phase & 0xFF000000) >> 24]);
-			} else if (tone_shape == 2) {
-				// Tri
-				int8_t a = (tone_phase & 0xFF000000) >> 24;
-				sample = (a & 0x80) ? ((a << 1) ^ 0xFF) - 0x80 : (a << 1) + 0x80;
-			} else if (tone_shape == 3) {
-				// Saw up
-				sample = ((tone_phase & 0xFF000000) >> 24);
-			} else if (tone_shape == 4) {
-				// Saw down
-				sample = ((tone_phase & 0xFF000000) >> 24) ^ 0xFF;
-			} else if (tone_shape == 5) {
-				// Square
-				sample = (((tone_phase & 0xFF000000) >> 24) & 0x80) ? 127 : -128;
-			} else if (tone_shape == 6) {
-				// Noise
-				sample = (lfsr & 0xFF000000) >> 24;
-				feedback = ((lfsr >> 31) ^ (lfsr >> 29) ^ (lfsr >> 15) ^ (lfsr >> 11)) & 1;
-				lfsr = (lfsr << 1) | feedback;
-				if (!lfsr) lfsr = 0x1337;				// Shouldn't do this :(
-			}
-			
-			tone_phase += tone_delta;
-			
-			// Do FM
-			delta = sample * fm_delta;
-			
-			phase += delta;
-			sphase = phase + (64 << 24);
-
-			re = (sine_table_i8[(sphase & 0xFF000000) >> 24]);
-			im = (sine_table_i8[(phase & 0xFF000000) >> 24]);
+		// Shapes are built from the top 16 bits of the tone phase
+		const uint16_t tone_phase_16 = tone_phase >> 16;
+		int32_t sample = 0;
+		
+		if (tone_shape == 1) {
+			// Sine
+			sample = dsp::dds::sin_q15(tone_phase);
+		} else if (tone_shape == 2) {
+			// Tri
+			sample = (tone_phase_16 & 0x8000) ? (0xFFFF - tone_phase_16) * 2 - 0x8000 : tone_phase_16 * 2 - 0x8000;
+		} else if (tone_shape == 3) {
+			// Saw up
+			sample = (int16_t)tone_phase_16;
+		} else if (tone_shape == 4) {
+			// Saw down
+			sample = (int16_t)(tone_phase_16 ^ 0xFFFF);
+		} else if (tone_shape == 5) {
+			// Square
+			sample = (tone_phase_16 & 0x8000) ? 32767 : -32768;
+		} else if (tone_shape == 6) {
+			// Noise
+			sample = (int16_t)(lfsr >> 16);
+			feedback = ((lfsr >> 31) ^ (lfsr >> 29) ^ (lfsr >> 15) ^ (lfsr >> 11)) & 1;
+			lfsr = (lfsr << 1) | feedback;
+			if (!lfsr) lfsr = 0x1337;				// Shouldn't do this :(
 		}
-
-		buffer.p[i] = {re, im};
+		
+		tone_phase += tone_delta;
+		
+		modulation[i] = sample;
+	}
+	
+	if (tone_shape == 0) {
+		// CW
+		for (size_t i = 0; i < buffer.count; i++)
+			buffer.p[i] = { 127, 0 };
+	} else {
+		fm.execute({ modulation.data(), buffer.count }, buffer);
 	}
 };
 
@@ -101,7 +95,7 @@ void SigGenProcessor::on_message(const Message* const msg) {
 			} else
 				auto_off = false;
 			
-			fm_delta = message.bw * (0xFFFFFFULL / 1536000);
+			fm.set_deviation(message.bw, 1536000);
 			tone_shape = message.shape;
 			
 			lfsr = 0x54DF0119;
@@ -26,6 +26,7 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 #include "portapack_shared_memory.hpp"
+#include "dsp_dds.hpp"
 
 class SigGenProcessor : public BasebandProcessor {
 public:
@@ -38,13 +39,14 @@ private:
 	
 	BasebandThread baseband_thread { 1536000, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 	
-	uint32_t tone_delta { 0 }, fm_delta { };
+	std::array<int16_t, 2048> modulation { };
+	dsp::dds::FM fm { };
+	
+	uint32_t tone_delta { 0 };
 	uint32_t lfsr { }, feedback { }, tone_shape { };
     uint32_t sample_count { 0 };
     bool auto_off { };
-	uint32_t tone_phase { 0 }, phase { 0 }, delta { 0 }, sphase { 0 };
-	int8_t sample { 0 };
-	int8_t re { 0 }, im { 0 };
+	uint32_t tone_phase { 0 };
 	
 	TXProgressMessage txprogress_message { };
 };
@@ -21,7 +21,6 @@
  */
 
 #include "proc_sstvtx.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
@@ -93,20 +92,11 @@ void SSTVTXProcessor::execute(const buffer_c8_t& buffer) {
 		}
 
 		// Tone synth
-		tone_sample = (sine_table_i8[(tone_phase & 0xFF000000U) >> 24]);
-		tone_phase += tone_delta;
-		
-		// FM
-		delta = tone_sample * fm_delta;
-		
-		phase += delta;
-		sphase = phase + (64 << 24);
-
-		re = (sine_table_i8[(sphase & 0xFF000000U) >> 24]);
-		im = (sine_table_i8[(phase & 0xFF000000U) >> 24]);
-		
-		buffer.p[i] = {re, im};
+		tone.set_phase_increment(tone_delta);
+		modulation[i] = tone();
 	}
+	
+	fm.execute({ modulation.data(), buffer.count }, buffer);
 }
 
 void SSTVTXProcessor::on_message(const Message* const msg) {
@@ -131,11 +121,11 @@ void SSTVTXProcessor::on_message(const Message* const msg) {
 				vis_code_sequence[c + 1] = ((vis_code >> c) & 1) ? SSTV_VIS_ONE : SSTV_VIS_ZERO;
 			vis_code_sequence[9] = SSTV_VIS_SS;
 			
-			fm_delta = 9000 * (0xFFFFFFULL / 3072000);	// Fixed bw for now
+			fm.set_deviation(9000, 3072000);	// Fixed bw for now
 			
 			pixel_index = 0;
 			sample_count = 0;
-			tone_phase = 0;
+			tone.reset();
 			state = STATE_CALIBRATION;
 			substep = 0;
 			
@@ -27,6 +27,7 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 #include "sstv.hpp"
+#include "dsp_dds.hpp"
 
 using namespace sstv;
 
@@ -67,15 +68,13 @@ private:
 
 	sstv_scanline * current_scanline { };
 	
-	uint8_t pixel_luma { };
-	uint32_t fm_delta { 0 };
-	uint32_t tone_phase { 0 };
+	std::array<int16_t, 2048> modulation { };
+	dsp::dds::NCO tone { };
+	dsp::dds::FM fm { };
+	
 	uint32_t tone_delta { 0 };
     uint32_t pixel_index { 0 };
     uint32_t sample_count { 0 };
-	uint32_t phase { 0 }, sphase { 0 };
-	int32_t tone_sample { 0 }, delta { 0 };
-	int8_t re { }, im { };
 	
 	RequestSignalMessage sig_message { RequestSignalMessage::Signal::FillRequest };
 };
@@ -21,7 +21,6 @@
  */
 
 #include "proc_tones.hpp"
-#include "sine_table_int8.hpp"
 #include "event_m4.hpp"
 
 #include <cstdint>
@@ -41,12 +40,11 @@ void TonesProcessor::execute(const buffer_c8_t& buffer) {
 			silence_count--;
 			if (!silence_count) {
 				sample_count = 0;
-				tone_a_phase = 0;
-				tone_b_phase = 0;
+				tone_a.reset();
+				tone_b.reset();
 			}
 			tone_sample = 0;
-			re = 0;
-			im = 0;
+			buffer.p[i] = { 0, 0 };
 		} else {
 			if (!sample_count) {
 				digit = shared_memory.bb_data.tones_data.message[digit_pos];
@@ -67,10 +65,10 @@ void TonesProcessor::execute(const buffer_c8_t& buffer) {
 					sample_count = shared_memory.bb_data.tones_data.silence;
 				} else {
 					if (!dual_tone) {
-						tone_a_delta = tone_deltas[digit];
+						tone_a.set_phase_increment(tone_deltas[digit]);
 					} else {
-						tone_a_delta = tone_deltas[digit << 1];
-						tone_b_delta = tone_deltas[(digit << 1) + 1];
+						tone_a.set_phase_increment(tone_deltas[digit << 1]);
+						tone_b.set_phase_increment(tone_deltas[(digit << 1) + 1]);
 					}
 					sample_count = tone_durations[digit];
 				}
@@ -83,38 +81,24 @@ void TonesProcessor::execute(const buffer_c8_t& buffer) {
 				tone_sample = 0;
 			} else {
 				if (!dual_tone) {
-					tone_sample = (sine_table_i8[(tone_a_phase & 0xFF000000U) >> 24]);
-					tone_a_phase += tone_a_delta;
+					tone_sample = tone_a();
 				} else {
-					tone_sample = sine_table_i8[(tone_a_phase & 0xFF000000U) >> 24] >> 1;
-					tone_sample += sine_table_i8[(tone_b_phase & 0xFF000000U) >> 24] >> 1;
-					
-					tone_a_phase += tone_a_delta;
-					tone_b_phase += tone_b_delta;
+					tone_sample = (tone_a() + tone_b()) >> 1;
 				}
 			}
 		
-			// FM
-			delta = tone_sample * fm_delta;
-			
-			phase += delta;
-			sphase = phase + (64 << 24);
-
-			re = (sine_table_i8[(sphase & 0xFF000000U) >> 24]);
-			im = (sine_table_i8[(phase & 0xFF000000U) >> 24]);
+			buffer.p[i] = fm(tone_sample);
 		}
 		
 		// Headphone output sample generation: 1536000/24000 = 64
 		if (audio_out) {
 			if (!as) {
 				as = 64;
-				audio_buffer.p[ai++] = tone_sample * 128;
+				audio_buffer.p[ai++] = tone_sample >> 1;
 			} else {
 				as--;
 			}
 		}
-		
-		buffer.p[i] = {re, im};
 	}
 	
 	if (audio_out) audio_output.write(audio_buffer);
@@ -131,7 +115,7 @@ void TonesProcessor::on_message(const Message* const p) {
 				tone_deltas[c] = shared_memory.bb_data.tones_data.tone_defs[c].delta;
 				tone_durations[c] = shared_memory.bb_data.tones_data.tone_defs[c].duration;
 			}
-			fm_delta = message.fm_delta * (0xFFFFFFULL / 1536000);
+			fm.set_deviation(message.fm_delta, 1536000);
 			audio_out = message.audio_out;
 			dual_tone = message.dual_tone;
 			
@@ -142,8 +126,8 @@ void TonesProcessor::on_message(const Message* const p) {
 			
 			digit_pos = 0;
 			sample_count = 0;
-			tone_a_phase = 0;
-			tone_b_phase = 0;
+			tone_a.reset();
+			tone_b.reset();
 			as = 0;
 			
 			configured = true;
@@ -34,6 +34,7 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 		return;
 	}
 	
+	ScopedCycleTimer timer_channel { profiler, stage_channel };
 	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
 	const auto channel = decim_1.execute(decim_0_out, dst_buffer);
 
@@ -45,6 +46,7 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 		spectrum_samples -= spectrum_interval_samples;
 		channel_spectrum.feed(channel, channel_filter_low_f, channel_filter_high_f, channel_filter_transition);
 	}
+	timer_channel.stop();
 
 	/* 384kHz complex<int16_t>[256]
 	 * -> FM demodulation
@@ -53,12 +55,23 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	 *		pass < +/- 100kHz, stop > +/- 200kHz
 	 */
 
+	ScopedCycleTimer timer_demod { profiler, stage_demod };
 	auto audio_oversampled = demod.execute(channel, work_audio_buffer);
 
 	/* 384kHz int16_t[256]
 	 * -> 4th order CIC decimation by 2, gain of 1
 	 * -> 192kHz int16_t[128] */
 	auto audio_4fs = audio_dec_1.execute(audio_oversampled, work_audio_buffer);
+	timer_demod.stop();
+
+	/* 192kHz int16_t[128] MPX
+	 * -> multiplex decoder, RDS
+	 * -> 48kHz int16_t[32] L-R, when stereo */
+	ScopedCycleTimer timer_mpx { profiler, stage_mpx };
+	const auto difference_audio = decode_multiplex(audio_4fs);
+	timer_mpx.stop();
+
+	ScopedCycleTimer timer_audio { profiler, stage_audio };
 
 	/* 192kHz int16_t[128]
 	 * -> 4th order CIC decimation by 2, gain of 1
@@ -123,9 +136,38 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 	 * -> 48kHz int16_t[32] */
 	auto audio = audio_filter.execute(audio_2fs, work_audio_buffer);
 
-	/* -> 48kHz int16_t[32] */
-	audio_output.write(audio);
-	
+	if( difference_audio ) {
+		/* -> 48kHz int16_t[32] L+R, L-R */
+		audio_output.write(audio, difference_audio);
+	} else {
+		/* -> 48kHz int16_t[32] */
+		audio_output.write(audio);
+	}
+}
+
+buffer_s16_t WidebandFMAudio::decode_multiplex(const buffer_s16_t& mpx) {
+	/* 192kHz int16_t[128] MPX
+	 * -> pilot PLL, 38kHz L-R demodulation, 57kHz RDS tap
+	 * -> 192kHz int16_t[128] L-R, 24kHz complex<int16_t>[16] RDS
+	 * The RDS carrier is locked to the pilot, so this runs in mono too.
+	 */
+	const auto stereo_out = stereo_decoder.execute(mpx, difference_buffer, rds_buffer);
+
+	rds_demod.execute(stereo_out.rds,
+		[](const rds::ReceivedGroup& group) {
+			const RDSGroupMessage message { group };
+			shared_memory.application_queue.push(message);
+		}
+	);
+
+	if( !stereo ) {
+		return { };
+	}
+
+	/* L-R through the same CIC and FIR stages as L+R.
+	 * 192kHz int16_t[128] -> 96kHz int16_t[64] -> 48kHz int16_t[32] */
+	const auto difference_2fs = difference_dec_2.execute(stereo_out.difference, difference_buffer);
+	return difference_filter.execute(difference_2fs, difference_buffer);
 }
 
 void WidebandFMAudio::post_message(const buffer_c16_t& data) {
@@ -163,6 +205,8 @@ void WidebandFMAudio::configure(const WFMConfigureMessage& message) {
 	constexpr size_t decim_1_output_fs = decim_1_input_fs / decim_1.decimation_factor;
 
 	constexpr size_t demod_input_fs = decim_1_output_fs;
+	constexpr size_t stereo_input_fs = demod_input_fs / 2;
+	constexpr size_t rds_input_fs = stereo_input_fs / 8;
 
 	spectrum_interval_samples = decim_1_output_fs / spectrum_rate_hz;
 	spectrum_samples = 0;
@@ -174,6 +218,10 @@ void WidebandFMAudio::configure(const WFMConfigureMessage& message) {
 	channel_filter_transition = message.decim_1_filter.transition_normalized * decim_1_input_fs;
 	demod.configure(demod_input_fs, message.deviation);
 	audio_filter.configure(message.audio_filter.taps);
+	difference_filter.configure(message.audio_filter.taps);
+	stereo_decoder.configure(stereo_input_fs);
+	rds_demod.configure(rds_input_fs);
+	stereo = message.stereo;
 	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config);
 
 	channel_spectrum.set_decimation_factor(1);
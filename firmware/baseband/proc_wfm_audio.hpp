@@ -30,6 +30,8 @@
 #include "dsp_types.hpp"
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
+#include "dsp_stereo.hpp"
+#include "rds_demodulator.hpp"
 #include "block_decimator.hpp"
 
 #include "audio_output.hpp"
@@ -76,6 +78,23 @@ private:
 	dsp::decimate::DecimateBy2CIC4Real audio_dec_2 { };
 	dsp::decimate::FIR64AndDecimateBy2Real audio_filter { };
 
+	// Multiplex: pilot and RDS always, L-R (stereo only) through the mono path's 192kHz -> 48kHz structure
+	dsp::stereo::MultiplexDecoder stereo_decoder { };
+	std::array<int16_t, 128> difference { };
+	const buffer_s16_t difference_buffer {
+		difference.data(),
+		difference.size()
+	};
+	std::array<complex16_t, 128> rds { };
+	const buffer_c16_t rds_buffer {
+		rds.data(),
+		rds.size()
+	};
+	dsp::decimate::DecimateBy2CIC4Real difference_dec_2 { };
+	dsp::decimate::FIR64AndDecimateBy2Real difference_filter { };
+	RDSDemodulator rds_demod { };
+	bool stereo { false };
+
 	AudioOutput audio_output { };
 	
 	// For fs=96kHz FFT streaming
@@ -95,10 +114,16 @@ private:
 	size_t spectrum_interval_samples = 0;
 	size_t spectrum_samples = 0;
 
+	const CycleProfiler::stage_t stage_channel { profiler.add_stage("channel") };
+	const CycleProfiler::stage_t stage_demod { profiler.add_stage("demod") };
+	const CycleProfiler::stage_t stage_mpx { profiler.add_stage("mpx") };
+	const CycleProfiler::stage_t stage_audio { profiler.add_stage("audio") };
+
 	bool configured { false };
 	void configure(const WFMConfigureMessage& message);
 	void capture_config(const CaptureConfigMessage& message);
 	void post_message(const buffer_c16_t& data);
+	buffer_s16_t decode_multiplex(const buffer_s16_t& mpx);
 };
 
 #endif/*__PROC_WFM_AUDIO_H__*/
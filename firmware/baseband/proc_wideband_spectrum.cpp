@@ -34,6 +34,11 @@ void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
 	
 	if (!configured) return;
 
+	if( wideband_spectrum.running() ) {
+		wideband_spectrum.feed(buffer);
+		return;
+	}
+
 	if( phase == 0 ) {
 		std::fill(spectrum.begin(), spectrum.end(), 0);
 	}
@@ -62,20 +67,22 @@ void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
 }
 
 void WidebandSpectrum::on_message(const Message* const msg) {
-	const WidebandSpectrumConfigMessage message = *reinterpret_cast<const WidebandSpectrumConfigMessage*>(msg);
-	
 	switch(msg->id) {
 	case Message::ID::UpdateSpectrum:
+		channel_spectrum.on_message(msg);
+		wideband_spectrum.update();
+		break;
+
 	case Message::ID::SpectrumStreamingConfig:
 		channel_spectrum.on_message(msg);
 		break;
 		
 	case Message::ID::WidebandSpectrumConfig:
-		baseband_fs = message.sampling_rate;
-		trigger = message.trigger;
-		baseband_thread.set_sampling_rate(baseband_fs);
-		phase = 0;
-		configured = true;
+		configure(*reinterpret_cast<const WidebandSpectrumConfigMessage*>(msg));
+		break;
+
+	case Message::ID::SignalDetectConfig:
+		wideband_spectrum.set_detect_threshold(reinterpret_cast<const SignalDetectConfigMessage*>(msg)->threshold);
 		break;
 
 	default:
@@ -83,6 +90,15 @@ void WidebandSpectrum::on_message(const Message* const msg) {
 	}
 }
 
+void WidebandSpectrum::configure(const WidebandSpectrumConfigMessage& message) {
+	baseband_fs = message.sampling_rate;
+	trigger = message.trigger;
+	baseband_thread.set_sampling_rate(baseband_fs);
+	phase = 0;
+	wideband_spectrum.configure(message.fft_size, message.averages, message.slice);
+	configured = true;
+}
+
 int main() {
 	EventDispatcher event_dispatcher { std::make_unique<WidebandSpectrum>() };
 	event_dispatcher.run();
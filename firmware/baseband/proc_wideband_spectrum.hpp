@@ -27,6 +27,7 @@
 #include "rssi_thread.hpp"
 
 #include "spectrum_collector.hpp"
+#include "wideband_spectrum_collector.hpp"
 
 #include "message.hpp"
 
@@ -49,10 +50,13 @@ private:
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 
 	SpectrumCollector channel_spectrum { };
+	WidebandSpectrumCollector wideband_spectrum { };
 
 	std::array<complex16_t, 256> spectrum { };
 
 	size_t phase = 0, trigger = 127;
+
+	void configure(const WidebandSpectrumConfigMessage& message);
 };
 
 #endif/*__PROC_WIDEBAND_SPECTRUM_H__*/
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "rds_demodulator.hpp"
+
+static inline bool first_half(const uint32_t phase) {
+	return phase < 0x80000000;
+}
+
+static inline bool wraps(const uint32_t phase, const uint32_t phase_inc) {
+	return (phase + phase_inc) < phase;
+}
+
+void RDSDemodulator::configure(const uint32_t sampling_rate) {
+	phase = 0;
+	timing_adjust = 0;
+	phase_inc = symbol_rate / sampling_rate * 4294967296.0f;
+	acc_prompt = { };
+	acc_early = { };
+	acc_late = { };
+	acc_half = { };
+	energy_early = 0;
+	energy_late = 0;
+	energy_prompt_avg = 0;
+	energy_half_avg = 0;
+	last_symbol = { };
+	block_sync.reset();
+}
+
+bool RDSDemodulator::feed(const complex16_t sample) {
+	const std::complex<float> x { static_cast<float>(sample.real()), static_cast<float>(sample.imag()) };
+
+	/* Biphase symbol: matched filter is +1 over the first half and -1 over
+	 * the second half of the symbol period.
+	 */
+	const auto phase_early = phase + gate_offset;
+	const auto phase_late = phase - gate_offset;
+	const auto phase_half = phase + 0x80000000;
+	acc_prompt += first_half(phase) ? x : -x;
+	acc_early += first_half(phase_early) ? x : -x;
+	acc_late += first_half(phase_late) ? x : -x;
+	acc_half += first_half(phase_half) ? x : -x;
+
+	if( wraps(phase_early, phase_inc) ) {
+		energy_early = std::norm(acc_early);
+		acc_early = { };
+	}
+	if( wraps(phase_late, phase_inc) ) {
+		energy_late = std::norm(acc_late);
+		acc_late = { };
+	}
+	if( wraps(phase_half, phase_inc) ) {
+		energy_half_avg += (std::norm(acc_half) - energy_half_avg) * energy_alpha;
+		acc_half = { };
+	}
+
+	bool group_complete = false;
+	if( wraps(phase, phase_inc) ) {
+		const auto symbol = acc_prompt;
+		acc_prompt = { };
+		energy_prompt_avg += (std::norm(symbol) - energy_prompt_avg) * energy_alpha;
+
+		/* Half a symbol off is also a local energy maximum (when adjacent
+		 * symbols are equal), but on average only half as strong.
+		 */
+		if( energy_half_avg > energy_prompt_avg ) {
+			phase += 0x80000000;
+			std::swap(energy_prompt_avg, energy_half_avg);
+			acc_early = { };
+			acc_late = { };
+		}
+
+		// More energy in the early gate means we're sampling late: advance.
+		const float energy_total = energy_early + energy_late;
+		if( energy_total > 0.0f ) {
+			const float error = (energy_early - energy_late) / energy_total;
+			timing_adjust = error * timing_gain;
+		}
+
+		// Differential coding: a phase reversal between symbols is a 1.
+		const bool bit = (std::real(symbol * std::conj(last_symbol)) < 0.0f);
+		last_symbol = symbol;
+
+		group_complete = block_sync.execute(bit);
+	}
+
+	phase += phase_inc;
+
+	/* Apply timing corrections a quarter symbol away from any gate's dump
+	 * point, so a correction can never cause a dump to be skipped or repeated.
+	 */
+	if( timing_adjust && (phase >= 0x40000000) && (phase < 0x60000000) ) {
+		phase += timing_adjust;
+		timing_adjust = 0;
+	}
+
+	return group_complete;
+}
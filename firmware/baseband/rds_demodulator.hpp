@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RDS_DEMODULATOR_H__
+#define __RDS_DEMODULATOR_H__
+
+#include "dsp_types.hpp"
+#include "rds_packet.hpp"
+#include "rds_sync.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <complex>
+
+/* RDS BPSK demodulator, fed with the complex 57kHz subcarrier tap of the
+ * stereo decoder. Integrate-and-dump over each biphase half-symbol is the
+ * matched filter, early/late gates track the 1187.5 baud clock (with a
+ * half-symbol gate to escape the biphase false lock point), and the
+ * differential decode (phase change = 1) makes it insensitive to carrier
+ * phase, so it works on mono stations without a pilot as well.
+ */
+class RDSDemodulator {
+public:
+	void configure(const uint32_t sampling_rate);
+
+	// group_handler is called with each completed rds::ReceivedGroup.
+	template<typename GroupHandler>
+	void execute(const buffer_c16_t& src, GroupHandler group_handler) {
+		for(size_t i=0; i<src.count; i++) {
+			if( feed(src.p[i]) ) {
+				group_handler(block_sync.group());
+			}
+		}
+	}
+
+	bool synchronized() const {
+		return block_sync.synchronized();
+	}
+
+private:
+	static constexpr float symbol_rate = 1187.5f;
+	static constexpr uint32_t gate_offset = 0x20000000;	// 1/8 symbol
+	static constexpr float timing_gain = 0x04000000;	// 1/64 symbol at full error
+	static constexpr float energy_alpha = 1.0f / 64.0f;
+
+	uint32_t phase { 0 };
+	uint32_t phase_inc { 0 };
+	int32_t timing_adjust { 0 };
+
+	std::complex<float> acc_prompt { };
+	std::complex<float> acc_early { };
+	std::complex<float> acc_late { };
+	std::complex<float> acc_half { };
+	float energy_early { 0 };
+	float energy_late { 0 };
+	float energy_prompt_avg { 0 };
+	float energy_half_avg { 0 };
+	std::complex<float> last_symbol { };
+
+	rds::BlockSync block_sync { };
+
+	bool feed(const complex16_t sample);
+};
+
+#endif/*__RDS_DEMODULATOR_H__*/
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "rssi_envelope_collector.hpp"
+
+#include <algorithm>
+
+void RSSIEnvelopeCollector::configure(const RSSIStreamConfig& new_config, const uint32_t new_sampling_rate) {
+	config = new_config;
+
+	// A full batch no more often than batches_per_second_max.
+	constexpr uint32_t batch_rate_max = RSSIEnvelopeMessage::samples_max * batches_per_second_max;
+	const uint32_t decimation_min = (new_sampling_rate + batch_rate_max - 1) / batch_rate_max;
+	config.decimation = std::max({ config.decimation, decimation_min, uint32_t { 1 } });
+
+	/* Keep the pre-trigger window within the history and leave at least half
+	 * of the first batch for the burst itself.
+	 */
+	const size_t pre_trigger_max = std::min(history_mask, RSSIEnvelopeMessage::samples_max / 2);
+	config.pre_trigger = static_cast<uint16_t>(std::min<size_t>(config.pre_trigger, pre_trigger_max));
+
+	sampling_rate = new_sampling_rate;
+	decimation_count = 0;
+	peak = 0;
+	history_in = 0;
+	history_count = 0;
+	in_burst = false;
+	hang = 0;
+
+	message.count = 0;
+	message.trigger = RSSIEnvelopeMessage::no_trigger;
+	message.burst_end = false;
+	message.sampling_rate = sampling_rate / config.decimation;
+	message_sent = false;
+
+	budget_start = sample_index;
+	budget_messages = 0;
+}
+
+bool RSSIEnvelopeCollector::within_budget(const uint64_t timestamp) {
+	if( (timestamp - budget_start) >= sampling_rate ) {
+		budget_start = timestamp;
+		budget_messages = 0;
+	}
+
+	// Over budget, the batch is dropped rather than risk filling the queue.
+	if( budget_messages >= messages_per_second_max ) {
+		return false;
+	}
+	budget_messages++;
+	return true;
+}
+
+void RSSIEnvelopeCollector::append(const uint8_t value, const uint64_t timestamp) {
+	if( message.count == 0 ) {
+		message.timestamp = timestamp;
+	}
+	message.samples[message.count++] = value;
+}
+
+bool RSSIEnvelopeCollector::feed(const uint8_t value, const uint64_t timestamp) {
+	if( message_sent ) {
+		message.count = 0;
+		message.trigger = RSSIEnvelopeMessage::no_trigger;
+		message.burst_end = false;
+		message_sent = false;
+	}
+
+	if( config.mode == RSSIStreamConfig::Mode::Burst ) {
+		if( in_burst ) {
+			append(value, timestamp);
+			if( value >= config.threshold ) {
+				hang = config.post_trigger;
+			} else if( (hang == 0) || (--hang == 0) ) {
+				in_burst = false;
+				message.burst_end = true;
+				message_sent = true;
+			}
+		} else if( value >= config.threshold ) {
+			// Pre-trigger window, oldest first, then the triggering sample.
+			const size_t pre_trigger = std::min<size_t>(config.pre_trigger, history_count);
+			for(size_t n=pre_trigger; n>0; n--) {
+				append(history[(history_in - n) & history_mask], timestamp - n * config.decimation);
+			}
+			message.trigger = message.count;
+			append(value, timestamp);
+
+			in_burst = true;
+			hang = config.post_trigger;
+		}
+	} else {
+		append(value, timestamp);
+	}
+
+	history[history_in++ & history_mask] = value;
+	history_count = std::min(history_count + 1, history_mask);
+
+	if( message.count >= message.samples.size() ) {
+		message_sent = true;
+	}
+
+	return message_sent;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __RSSI_ENVELOPE_COLLECTOR_H__
+#define __RSSI_ENVELOPE_COLLECTOR_H__
+
+#include "rssi.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Peak-hold decimated RSSI envelope, either streamed continuously or gated
+ * by a threshold with pre/post trigger windows, so short bursts that vanish
+ * into a 100ms RSSIStatistics average still reach the application.
+ *
+ * The envelope is collected straight into the outgoing message, which is
+ * handed to the callback once full or once a burst has ended. The message
+ * must be copied before process() is called again.
+ *
+ * The application queue is only 2KB, so decimation is raised until a
+ * continuous stream fits batches_per_second_max, and no more than
+ * messages_per_second_max are sent in any second, however short the bursts.
+ */
+class RSSIEnvelopeCollector {
+public:
+	void configure(const RSSIStreamConfig& new_config, const uint32_t sampling_rate);
+
+	template<typename Callback>
+	void process(const rf::rssi::buffer_t& buffer, Callback callback) {
+		if( (config.mode == RSSIStreamConfig::Mode::Stopped) || (buffer.p == nullptr) ) {
+			sample_index += buffer.count;
+			return;
+		}
+
+		for(size_t i=0; i<buffer.count; i++) {
+			const uint8_t value = buffer.p[i];
+			if( value > peak ) {
+				peak = value;
+			}
+
+			if( ++decimation_count >= config.decimation ) {
+				const auto timestamp = sample_index + i + 1 - config.decimation;
+				if( feed(peak, timestamp) && within_budget(timestamp) ) {
+					callback(message);
+				}
+				decimation_count = 0;
+				peak = 0;
+			}
+		}
+
+		sample_index += buffer.count;
+	}
+
+private:
+	static constexpr uint32_t batches_per_second_max = 20;
+	static constexpr uint32_t messages_per_second_max = 2 * batches_per_second_max;
+
+	static constexpr size_t history_k = 7;
+	static constexpr size_t history_mask = (1U << history_k) - 1;
+
+	RSSIStreamConfig config { };
+
+	uint32_t sampling_rate { 0 };
+	uint64_t sample_index { 0 };
+	uint32_t decimation_count { 0 };
+	uint8_t peak { 0 };
+
+	std::array<uint8_t, 1U << history_k> history { };
+	size_t history_in { 0 };
+	size_t history_count { 0 };
+
+	bool in_burst { false };
+	uint32_t hang { 0 };
+
+	bool message_sent { false };
+	RSSIEnvelopeMessage message { };
+
+	uint64_t budget_start { 0 };
+	uint32_t budget_messages { 0 };
+
+	bool feed(const uint8_t value, const uint64_t timestamp);
+	bool within_budget(const uint64_t timestamp);
+	void append(const uint8_t value, const uint64_t timestamp);
+};
+
+#endif/*__RSSI_ENVELOPE_COLLECTOR_H__*/
@@ -28,10 +28,13 @@
 #include "message.hpp"
 #include "portapack_shared_memory.hpp"
 
-WORKING_AREA(rssi_thread_wa, 128);
+WORKING_AREA(rssi_thread_wa, 256);
 
 Thread* RSSIThread::thread = nullptr;
 
+RSSIStreamConfig RSSIThread::stream_config { };
+bool RSSIThread::stream_config_pending { false };
+
 RSSIThread::RSSIThread(const tprio_t priority) {
 	thread = chThdCreateStatic(rssi_thread_wa, sizeof(rssi_thread_wa),
 		priority, ThreadBase::fn,
@@ -45,6 +48,13 @@ RSSIThread::~RSSIThread() {
 	thread = nullptr;
 }
 
+void RSSIThread::configure_stream(const RSSIStreamConfig& config) {
+	chSysLock();
+	stream_config = config;
+	stream_config_pending = true;
+	chSysUnlock();
+}
+
 void RSSIThread::run() {
 	rf::rssi::init();
 	rf::rssi::dma::allocate(4, 400);
@@ -67,6 +77,21 @@ void RSSIThread::run() {
 				shared_memory.application_queue.push(message);
 			}
 		);
+
+		if( stream_config_pending ) {
+			chSysLock();
+			const auto config = stream_config;
+			stream_config_pending = false;
+			chSysUnlock();
+			envelope.configure(config, sampling_rate);
+		}
+
+		envelope.process(
+			buffer,
+			[](const RSSIEnvelopeMessage& message) {
+				shared_memory.application_queue.push(message);
+			}
+		);
 	}
 
 	rf::rssi::stop();
@@ -23,6 +23,8 @@
 #define __RSSI_THREAD_H__
 
 #include "thread_base.hpp"
+#include "rssi_envelope_collector.hpp"
+#include "message.hpp"
 
 #include <ch.h>
 
@@ -33,11 +35,19 @@ public:
 	RSSIThread(const tprio_t priority);
 	~RSSIThread();
 
+	// May be called from any thread, takes effect from the next RSSI buffer.
+	static void configure_stream(const RSSIStreamConfig& config);
+
 private:
 	void run() override;
 
 	static Thread* thread;
 
+	static RSSIStreamConfig stream_config;
+	static bool stream_config_pending;
+
+	RSSIEnvelopeCollector envelope { };
+
 	const uint32_t sampling_rate { 400000 };
 };
 
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "signal_detector.hpp"
+
+#include <algorithm>
+
+void SignalDetector::execute(
+	const WidebandSpectrumTrace& trace,
+	const std::array<int32_t, width>& column_offset,
+	const size_t slice,
+	SignalCandidatesMessage& result
+) {
+	const size_t index = std::min(slice, slices_max - 1);
+	auto& floor = floors[index];
+	const uint32_t slice_bit = 1UL << index;
+	if( slices_valid & slice_bit ) {
+		update_floor(floor, trace);
+	} else {
+		for(size_t c=0; c<width; c++) {
+			floor[c] = trace.mean[c] << 8;
+		}
+		slices_valid |= slice_bit;
+	}
+	update_reference(floor);
+
+	result.slice = slice;
+	result.sampling_rate = trace.sampling_rate;
+	result.noise_floor = trace.noise_floor;
+	result.count = 0;
+
+	if( !enabled() ) {
+		return;
+	}
+
+	const auto detected = [this, &trace](const size_t c) {
+		return (trace.max[c] >= (reference[c] + threshold));
+	};
+
+	const uint32_t column_width = trace.sampling_rate / width;
+	size_t c = 0;
+	while( c < width ) {
+		if( !detected(c) ) {
+			c++;
+			continue;
+		}
+
+		const size_t first = c;
+		size_t last = c;
+		size_t peak = c;
+		size_t gap = 0;
+		int64_t weighted_offset = 0;
+		uint32_t weight_sum = 0;
+		for(; c<width; c++) {
+			if( detected(c) ) {
+				const uint32_t weight = trace.max[c] - reference[c];
+				weighted_offset += static_cast<int64_t>(column_offset[c]) * weight;
+				weight_sum += weight;
+				if( trace.max[c] > trace.max[peak] ) {
+					peak = c;
+				}
+				last = c;
+				gap = 0;
+			} else if( ++gap > merge_gap ) {
+				break;
+			}
+		}
+
+		add_candidate(result, {
+			static_cast<int32_t>(weighted_offset / weight_sum),
+			(last - first + 1) * column_width,
+			trace.max[peak],
+			static_cast<uint8_t>(trace.max[peak] - reference[peak])
+		});
+	}
+}
+
+void SignalDetector::update_floor(std::array<uint16_t, width>& floor, const WidebandSpectrumTrace& trace) {
+	for(size_t c=0; c<width; c++) {
+		const uint32_t level = trace.mean[c] << 8;
+		const uint32_t current = floor[c];
+		if( level < current ) {
+			floor[c] = current - (current - level) / 4;
+		} else {
+			floor[c] = std::min(current + floor_rise, level);
+		}
+	}
+}
+
+void SignalDetector::update_reference(const std::array<uint16_t, width>& floor) {
+	floor_sum[0] = 0;
+	for(size_t c=0; c<width; c++) {
+		floor_sum[c + 1] = floor_sum[c] + floor[c];
+	}
+
+	const auto average = [this](const size_t first, const size_t last) -> uint32_t {
+		return (floor_sum[last] - floor_sum[first]) / (last - first);
+	};
+
+	// Signals wider than the training cells would otherwise hide their own middle.
+	std::array<uint16_t, width> sorted;
+	std::copy(floor.begin(), floor.end(), sorted.begin());
+	std::nth_element(sorted.begin(), sorted.begin() + width / 2, sorted.end());
+	const uint32_t median = sorted[width / 2];
+
+	for(size_t c=0; c<width; c++) {
+		uint32_t result = median;
+
+		if( c > guard_columns ) {
+			const size_t first = (c > (guard_columns + training_columns)) ? (c - guard_columns - training_columns) : 0;
+			result = std::min(result, average(first, c - guard_columns));
+		}
+
+		const size_t first = c + guard_columns + 1;
+		if( first < width ) {
+			const size_t last = std::min(width, first + training_columns);
+			result = std::min(result, average(first, last));
+		}
+
+		reference[c] = (result + 0x80) >> 8;
+	}
+}
+
+void SignalDetector::add_candidate(SignalCandidatesMessage& result, const SignalCandidate& candidate) const {
+	constexpr size_t candidates_max = SignalCandidatesMessage::candidates_max;
+
+	size_t j = std::min(result.count, candidates_max - 1);
+	if( (result.count == candidates_max) && (candidate.snr <= result.candidates[j].snr) ) {
+		return;
+	}
+	for(; (j > 0) && (result.candidates[j - 1].snr < candidate.snr); j--) {
+		result.candidates[j] = result.candidates[j - 1];
+	}
+	result.candidates[j] = candidate;
+	result.count = std::min(result.count + 1, candidates_max);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SIGNAL_DETECTOR_H__
+#define __SIGNAL_DETECTOR_H__
+
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Finds emitters in wideband spectrum traces.
+ *
+ * Each column's noise floor follows the mean trace as a running minimum:
+ * it drops quickly to quieter levels and creeps back up slowly. A column
+ * is detected when its max level clears a smallest-of cell averaging CFAR
+ * reference taken from the floors either side of it, so a carrier that has
+ * been on long enough to pull its own floor up is still caught. The
+ * reference is capped at the median floor of the slice. Adjacent
+ * detections, allowing single column gaps, form one candidate.
+ *
+ * Has no OS or hardware dependencies so it can be built and exercised on a
+ * host against recorded traces.
+ */
+class SignalDetector {
+public:
+	static constexpr size_t width = WidebandSpectrumTrace::width;
+	static constexpr size_t slices_max = 16;
+
+	void set_threshold(const uint8_t new_threshold) {
+		threshold = new_threshold;
+	}
+
+	bool enabled() const {
+		return threshold != 0;
+	}
+
+	// Forgets the noise floors, e.g. after a gain change.
+	void reset() {
+		slices_valid = 0;
+	}
+
+	/* column_offset is the frequency of each column's strongest bin, Hz from
+	 * center. Slices beyond slices_max share the last floor.
+	 */
+	void execute(
+		const WidebandSpectrumTrace& trace,
+		const std::array<int32_t, width>& column_offset,
+		const size_t slice,
+		SignalCandidatesMessage& result
+	);
+
+private:
+	static constexpr size_t guard_columns = 2;
+	static constexpr size_t training_columns = 8;
+	static constexpr size_t merge_gap = 1;
+	static constexpr uint32_t floor_rise = 26;	// 0.05dB per trace, 8.8 fixed point
+
+	uint8_t threshold { 0 };
+	uint32_t slices_valid { 0 };
+
+	// Trace units in 8.8 fixed point.
+	std::array<std::array<uint16_t, width>, slices_max> floors { };
+	std::array<uint32_t, width + 1> floor_sum { };
+	std::array<uint8_t, width> reference { };
+
+	void update_floor(std::array<uint16_t, width>& floor, const WidebandSpectrumTrace& trace);
+	void update_reference(const std::array<uint16_t, width>& floor);
+	void add_candidate(SignalCandidatesMessage& result, const SignalCandidate& candidate) const;
+};
+
+#endif/*__SIGNAL_DETECTOR_H__*/
@@ -54,13 +54,14 @@ void SpectrumCollector::set_state(const SpectrumStreamingConfigMessage& message)
 
 void SpectrumCollector::start() {
 	streaming = true;
-	ChannelSpectrumConfigMessage message { &fifo };
+	samples_since_spectrum = 0;
+	ChannelSpectrumConfigMessage message { &exchange };
 	shared_memory.application_queue.push(message);
 }
 
 void SpectrumCollector::stop() {
 	streaming = false;
-	fifo.reset_in();
+	exchange.reset();
 }
 
 void SpectrumCollector::set_decimation_factor(
@@ -95,7 +96,16 @@ void SpectrumCollector::feed(
 
 void SpectrumCollector::post_message(const buffer_c16_t& data) {
 	// Called from baseband processing thread.
+	samples_since_spectrum += data.count;
+
+	// Don't compute spectra faster than the application asked for.
+	const auto rate = exchange.requested_rate();
+	if( rate && (samples_since_spectrum < (data.sampling_rate / rate)) ) {
+		return;
+	}
+
 	if( streaming && !channel_spectrum_request_update ) {
+		samples_since_spectrum = 0;
 		fft_swap(data, channel_spectrum);
 		channel_spectrum_sampling_rate = data.sampling_rate;
 		channel_spectrum_request_update = true;
@@ -148,7 +158,8 @@ void SpectrumCollector::update() {
 		/* Decimated buffer is full. Compute spectrum. */
 		fft_c_preswapped(channel_spectrum, 0, 8);
 
-		ChannelSpectrum spectrum;
+		// Straight into the exchange, the application reads it in place.
+		auto& spectrum = exchange.slot();
 		spectrum.sampling_rate = channel_spectrum_sampling_rate;
 		spectrum.channel_filter_low_frequency = channel_filter_low_frequency;
 		spectrum.channel_filter_high_frequency = channel_filter_high_frequency;
@@ -161,7 +172,7 @@ void SpectrumCollector::update() {
 			const unsigned int v = (db * mag_scale) + 255.0f;
 			spectrum.db[i] = std::max(0U, std::min(255U, v));
 		}
-		fifo.in(spectrum);
+		exchange.publish();
 	}
 
 	channel_spectrum_request_update = false;
@@ -50,8 +50,8 @@ public:
 
 private:
 	BlockDecimator<complex16_t, 256> channel_spectrum_decimator { 1 };
-	ChannelSpectrum fifo_data[1 << ChannelSpectrumConfigMessage::fifo_k] { };
-	ChannelSpectrumFIFO fifo { fifo_data, ChannelSpectrumConfigMessage::fifo_k };
+	ChannelSpectrumExchange exchange { };
+	size_t samples_since_spectrum { 0 };
 
 	volatile bool channel_spectrum_request_update { false };
 	bool streaming { false };
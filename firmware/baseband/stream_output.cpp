@@ -72,6 +72,7 @@ size_t StreamOutput::read(void* const data, const size_t length) {
 	}
 
 	config->baseband_bytes_received += length;
+	config->baseband_bytes_missed += (length - read);
 
 	return read;
 }
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "tone_detector.hpp"
+
+#include "dsp_fir_taps.hpp"
+
+#include <algorithm>
+
+// Tone frequencies in 1/100 Hz, same order as the application's tone_keys.
+static constexpr std::array<uint16_t, 50> ctcss_tones { {
+	 6700,  6940,  7190,  7440,  7700,  7970,  8250,  8540,  8850,  9150,
+	 9480,  9740, 10000, 10350, 10720, 11090, 11480, 11880, 12300, 12730,
+	13180, 13650, 14130, 14620, 15140, 15670, 15980, 16220, 16550, 16790,
+	17130, 17380, 17730, 17990, 18350, 18620, 18990, 19280, 19660, 19950,
+	20350, 20650, 21070, 21810, 22570, 22910, 23360, 24180, 25030, 25410
+} };
+
+static constexpr std::array<uint16_t, 8> dtmf_tones { {
+	697, 770, 852, 941,			// Rows
+	1209, 1336, 1477, 1633		// Columns
+} };
+
+static constexpr char dtmf_keys[16] = {
+	'1', '2', '3', 'A',
+	'4', '5', '6', 'B',
+	'7', '8', '9', 'C',
+	'*', '0', '#', 'D'
+};
+
+// Golay (23,12) generator, x^11 + x^10 + x^6 + x^5 + x^4 + x^2 + 1.
+static constexpr uint32_t golay_generator = 0xc75;
+
+static uint32_t golay_parity(const uint32_t data) {
+	uint32_t word = data << 11;
+	for(size_t i=22; i>=11; i--) {
+		if( word & (1UL << i) ) {
+			word ^= golay_generator << (i - 11);
+		}
+	}
+	return word;
+}
+
+void DCSCorrelator::configure(const uint32_t sampling_rate) {
+	phase_inc = bit_rate / sampling_rate * 4294967296.0f;
+	phase = 0;
+	dc_acc = 0;
+	previous = 0;
+	bit_acc = 0;
+	history = 0;
+	word = 0;
+	inverted_ = false;
+	repeats = 0;
+	bits_since_word = no_word;
+}
+
+/* Same layout as the application's dcs_word(): code in bits 0-8, 100 in
+ * bits 9-11, Golay parity of the lower 12 bits in bits 12-22.
+ */
+bool DCSCorrelator::valid(const uint32_t word) {
+	return (((word >> 9) & 7) == 4) && (golay_parity(word & 0xfff) == (word >> 12));
+}
+
+void DCSCorrelator::execute(const int16_t sample) {
+	// Slow DC tracker (~0.7s at 3kHz), long runs of equal bits must survive it.
+	dc_acc += sample - (dc_acc >> 11);
+	const int32_t x = sample - (dc_acc >> 11);
+
+	// Transitions happen on bit boundaries, pull phase zero towards them.
+	if( (x ^ previous) < 0 ) {
+		phase -= static_cast<uint32_t>(static_cast<int32_t>(phase) / 8);
+	}
+	previous = x;
+
+	bit_acc += x;
+	const uint32_t next = phase + phase_inc;
+	if( next < phase ) {
+		bit(bit_acc > 0);
+		bit_acc = 0;
+	}
+	phase = next;
+}
+
+void DCSCorrelator::bit(const bool value) {
+	// Bits arrive LSB first: newest word in bits 23-45, the one before in 0-22.
+	history = (history >> 1) | (value ? (1ULL << (2 * word_bits - 1)) : 0);
+	if( bits_since_word < no_word ) {
+		bits_since_word++;
+	}
+
+	const uint32_t current = (history >> word_bits) & word_mask;
+	if( current != (history & word_mask) ) {
+		return;
+	}
+
+	bool current_inverted = false;
+	uint32_t candidate = current;
+	if( !valid(candidate) ) {
+		candidate = ~current & word_mask;
+		current_inverted = true;
+		if( !valid(candidate) ) {
+			return;
+		}
+	}
+
+	/* Some codes are rotations of others, stay on the first one found for as
+	 * long as it keeps repeating.
+	 */
+	if( (candidate == word) && (current_inverted == inverted_) ) {
+		repeats = (bits_since_word == word_bits) ? std::min<size_t>(repeats + 1, 4) : 1;
+	} else if( bits_since_word > word_bits ) {
+		word = candidate;
+		inverted_ = current_inverted;
+		repeats = 1;
+	} else {
+		return;
+	}
+	bits_since_word = 0;
+}
+
+bool DCSCorrelator::detected() const {
+	return (repeats > 0) && (bits_since_word <= (2 * word_bits));
+}
+
+uint8_t DCSCorrelator::confidence() const {
+	return repeats * 25;
+}
+
+void ToneDetector::configure(const uint32_t sampling_rate) {
+	subaudio_filter.configure(taps_64_lp_025_025.taps);
+	subaudio_acc = 0;
+	subaudio_phase = 0;
+
+	dtmf_bank.configure(sampling_rate, sampling_rate / 40);
+	for(size_t i=0; i<dtmf_tones.size(); i++) {
+		dtmf_bank.set_frequency(i, dtmf_tones[i]);
+	}
+	dtmf_previous = 0;
+	dtmf_reported = 0;
+
+	const uint32_t subaudio_rate = sampling_rate / 2 / subaudio_decimation;
+	ctcss_bank.configure(subaudio_rate, subaudio_rate / 2);
+	for(size_t i=0; i<ctcss_tones.size(); i++) {
+		ctcss_bank.set_frequency(i, ctcss_tones[i] / 100.0f);
+	}
+
+	dcs.configure(subaudio_rate);
+}
+
+buffer_s16_t ToneDetector::decimate(const buffer_s16_t& audio) {
+	// <300Hz FIR and decimation by 2, then a boxcar for the rest.
+	const auto filtered = subaudio_filter.execute(audio, { subaudio.data(), subaudio.size() });
+
+	size_t count = 0;
+	for(size_t i=0; i<filtered.count; i++) {
+		subaudio_acc += filtered.p[i];
+		if( ++subaudio_phase == subaudio_decimation ) {
+			subaudio[count++] = subaudio_acc / static_cast<int32_t>(subaudio_decimation);
+			subaudio_acc = 0;
+			subaudio_phase = 0;
+		}
+	}
+
+	return { subaudio.data(), count, filtered.sampling_rate / subaudio_decimation };
+}
+
+CodedSquelchMessage ToneDetector::dtmf_report() {
+	size_t row = 0;
+	size_t column = 4;
+	for(size_t i=1; i<4; i++) {
+		if( dtmf_bank.power(i) > dtmf_bank.power(row) ) {
+			row = i;
+		}
+		if( dtmf_bank.power(4 + i) > dtmf_bank.power(column) ) {
+			column = 4 + i;
+		}
+	}
+
+	/* A clean key puts half of the energy in each tone. Allow ~8dB of twist
+	 * and some speech or noise on top.
+	 */
+	const auto row_confidence = dtmf_bank.confidence(row);
+	const auto column_confidence = dtmf_bank.confidence(column);
+	const auto confidence = row_confidence + column_confidence;
+	const bool present = (row_confidence > 0.1f) && (column_confidence > 0.1f) && (confidence > 0.6f);
+	const char key = present ? dtmf_keys[(row * 4) + (column - 4)] : 0;
+
+	CodedSquelchMessage report { CodedSquelchMessage::Type::DTMF, 0, 0 };
+	if( key && (key == dtmf_previous) && (key != dtmf_reported) ) {
+		report.value = key;
+		report.confidence = std::min(confidence, 1.0f) * 100;
+		dtmf_reported = key;
+	}
+	if( !key ) {
+		dtmf_reported = 0;
+	}
+	dtmf_previous = key;
+
+	return report;
+}
+
+CodedSquelchMessage ToneDetector::subaudible_report() {
+	if( dcs.detected() ) {
+		return { CodedSquelchMessage::Type::DCS, dcs.code() | (dcs.inverted() ? 0x200U : 0U), dcs.confidence() };
+	}
+
+	const auto best = ctcss_bank.strongest();
+	return {
+		CodedSquelchMessage::Type::CTCSS,
+		ctcss_tones[best],
+		static_cast<uint8_t>(ctcss_bank.confidence(best) * 100)
+	};
+}
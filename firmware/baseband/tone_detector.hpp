@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TONE_DETECTOR_H__
+#define __TONE_DETECTOR_H__
+
+#include "dsp_types.hpp"
+#include "dsp_decimate.hpp"
+#include "dsp_goertzel.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* DCS (digital coded squelch) receiver: 134.4 bps NRZ, 23 bit Golay words
+ * repeated back to back. Bit clock is recovered from transitions, bits are
+ * integrate-and-dump, and every bit position is tested for a valid word in
+ * either polarity so no frame sync is needed.
+ */
+class DCSCorrelator {
+public:
+	void configure(const uint32_t sampling_rate);
+	void execute(const int16_t sample);
+
+	// The same word was seen twice in a row, recently.
+	bool detected() const;
+
+	uint32_t code() const {
+		return word & 0x1ff;
+	}
+
+	bool inverted() const {
+		return inverted_;
+	}
+
+	uint8_t confidence() const;
+
+	static bool valid(const uint32_t word);
+
+private:
+	static constexpr float bit_rate = 134.4f;
+	static constexpr size_t word_bits = 23;
+	static constexpr uint32_t word_mask = (1UL << word_bits) - 1;
+	static constexpr size_t no_word = 255;
+
+	int32_t dc_acc { 0 };
+	int32_t previous { 0 };
+	int32_t bit_acc { 0 };
+	uint32_t phase { 0 };
+	uint32_t phase_inc { 0 };
+
+	uint64_t history { 0 };
+	uint32_t word { 0 };
+	bool inverted_ { false };
+	size_t repeats { 0 };
+	size_t bits_since_word { no_word };
+
+	void bit(const bool value);
+};
+
+/* Coded squelch and DTMF detection on demodulated NFM audio, in one pass:
+ * - DTMF: Goertzel bank over the full rate audio in 25ms blocks, a key is
+ *   reported once after being seen in two consecutive blocks.
+ * - CTCSS: Goertzel bank of all 50 tones over <300Hz audio decimated to
+ *   fs/8, in 0.5s blocks (2Hz bins, against >= 2.4Hz tone spacing).
+ * - DCS: correlator over the same sub-audible stream.
+ * Once per CTCSS block the best sub-audible match is reported, DCS taking
+ * precedence when a valid code is being received.
+ */
+class ToneDetector {
+public:
+	void configure(const uint32_t sampling_rate);
+
+	// report_handler() is called with each CodedSquelchMessage to send.
+	template<typename ReportHandler>
+	void execute(const buffer_s16_t& audio, ReportHandler report_handler) {
+		dtmf_bank.execute(audio, [this, &report_handler]() {
+			const auto report = dtmf_report();
+			if( report.value ) {
+				report_handler(report);
+			}
+		});
+
+		const auto subaudio = decimate(audio);
+		for(size_t i=0; i<subaudio.count; i++) {
+			dcs.execute(subaudio.p[i]);
+		}
+
+		ctcss_bank.execute(subaudio, [this, &report_handler]() {
+			report_handler(subaudible_report());
+		});
+	}
+
+private:
+	static constexpr size_t ctcss_tone_count = 50;
+	static constexpr uint32_t subaudio_decimation = 4;
+
+	dsp::decimate::FIR64AndDecimateBy2Real subaudio_filter { };
+	std::array<int16_t, 16> subaudio { };
+	int32_t subaudio_acc { 0 };
+	size_t subaudio_phase { 0 };
+
+	dsp::GoertzelBank<8> dtmf_bank { };
+	dsp::GoertzelBank<ctcss_tone_count> ctcss_bank { };
+	DCSCorrelator dcs { };
+
+	char dtmf_previous { 0 };
+	char dtmf_reported { 0 };
+
+	buffer_s16_t decimate(const buffer_s16_t& audio);
+	CodedSquelchMessage dtmf_report();
+	CodedSquelchMessage subaudible_report();
+};
+
+#endif/*__TONE_DETECTOR_H__*/
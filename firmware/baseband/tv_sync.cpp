@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "tv_sync.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+bool TVSync::feed(const uint32_t envelope) {
+	// Flywheel corrections may push the phase just past the line end.
+	const size_t index = std::min<size_t>(line_phase >> phase_bits, VideoLine::samples_per_line - 1);
+	line.luma[index] = std::min<uint32_t>(envelope, 255);
+	line_peak = std::max(line_peak, envelope);
+
+	if( envelope > sync_threshold ) {
+		sync_run++;
+	} else if( sync_run ) {
+		on_sync_pulse(sync_run);
+		sync_run = 0;
+	}
+
+	line_phase += 1 << phase_bits;
+	if( line_phase >= line_length ) {
+		line_phase -= line_length;
+		end_line();
+		return true;
+	}
+
+	return false;
+}
+
+void TVSync::on_sync_pulse(const size_t length) {
+	if( length >= broad_length_min ) {
+		broad_count++;
+		return;
+	}
+
+	if( (length < hsync_length_min) || (length > hsync_length_max) ) {
+		return;
+	}
+
+	// Leading edge should land on sample 0 of the line.
+	int32_t error = line_phase - static_cast<int32_t>(length << phase_bits);
+	if( error >= (line_length / 2) ) {
+		error -= line_length;
+	} else if( error < -(line_length / 2) ) {
+		error += line_length;
+	}
+
+	if( std::abs(error) <= lock_window ) {
+		line_phase -= error / 4;
+		h_misses = 0;
+		h_locked = true;
+	} else if( ++h_misses >= h_misses_max ) {
+		line_phase = length << phase_bits;
+		h_misses = 0;
+		h_locked = false;
+	}
+}
+
+void TVSync::end_line() {
+	line.line_number++;
+
+	if( broad_count ) {
+		in_vsync = true;
+	} else if( in_vsync ) {
+		in_vsync = false;
+		v_locked = true;
+		line.line_number = vsync_end_line;
+		line.field++;
+	} else if( line.line_number > field_lines_max ) {
+		v_locked = false;
+		line.line_number = 0;
+		line.field++;
+	}
+	broad_count = 0;
+
+	sync_level += (static_cast<int32_t>(line_peak) - sync_level) / 8;
+	sync_threshold = sync_level * 7 / 8;
+	line_peak = 0;
+
+	if( h_locked && !in_vsync ) {
+		int32_t back_porch = 0;
+		for(size_t i=back_porch_first_sample; i<back_porch_last_sample; i++) {
+			back_porch += line.luma[i];
+		}
+		back_porch /= (back_porch_last_sample - back_porch_first_sample);
+		blank_level += (back_porch - blank_level) / 4;
+	} else {
+		// Blanking is at 75% of sync tip.
+		blank_level = sync_level * 3 / 4;
+	}
+
+	/* White is ~2.2 sync heights below blanking. Everything at or above
+	 * blanking (including sync) is black.
+	 */
+	const int32_t sync_height = std::max<int32_t>(sync_level - blank_level, 4);
+	const int32_t gain_q8 = (255 * 256 * 5) / (11 * sync_height);
+	for(auto& sample : line.luma) {
+		const int32_t luma = ((blank_level - sample) * gain_q8) >> 8;
+		sample = std::max<int32_t>(0, std::min<int32_t>(255, luma));
+	}
+
+	line.locked = locked();
+}
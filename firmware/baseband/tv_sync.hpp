@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __TV_SYNC_H__
+#define __TV_SYNC_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+/* Negative modulation AM TV (PAL/SECAM timing) line and field sync.
+ * The envelope is split into lines by a flywheel locked to horizontal sync
+ * leading edges, each line is clamped to its back porch and scaled from
+ * the sync tip, and broad pulses restart the line count for a new field.
+ */
+class TVSync {
+public:
+	// line_handler is called with each completed VideoLine.
+	template<typename LineHandler>
+	void execute(const buffer_c8_t& src, LineHandler line_handler) {
+		for(size_t i=0; i<src.count; i++) {
+			const int32_t re = src.p[i].real();
+			const int32_t im = src.p[i].imag();
+			const uint32_t envelope = __builtin_sqrtf(re * re + im * im);
+			if( feed(envelope) ) {
+				line_handler(line);
+			}
+		}
+	}
+
+	bool locked() const {
+		return h_locked && v_locked;
+	}
+
+private:
+	static constexpr size_t phase_bits = 8;
+	static constexpr int32_t line_length = VideoLine::samples_per_line << phase_bits;
+
+	// Pulse lengths at 2Msps: hsync 4.7us, equalizing 2.35us, broad 27.3us.
+	static constexpr size_t hsync_length_min = 6;
+	static constexpr size_t hsync_length_max = 16;
+	static constexpr size_t broad_length_min = 40;
+
+	// Flywheel: follow edges within the window, resync after repeated misses.
+	static constexpr int32_t lock_window = 4 << phase_bits;
+	static constexpr size_t h_misses_max = 8;
+
+	static constexpr size_t back_porch_first_sample = 12;
+	static constexpr size_t back_porch_last_sample = 20;
+
+	// First line without broad pulses, and the longest field before V lock is lost.
+	static constexpr uint16_t vsync_end_line = 3;
+	static constexpr uint16_t field_lines_max = 330;
+
+	VideoLine line { };
+
+	int32_t line_phase { 0 };
+	size_t sync_run { 0 };
+	size_t h_misses { 0 };
+	size_t broad_count { 0 };
+	bool in_vsync { false };
+	bool h_locked { false };
+	bool v_locked { false };
+
+	uint32_t line_peak { 0 };
+	int32_t sync_level { 0 };
+	int32_t blank_level { 0 };
+	uint32_t sync_threshold { 0xffffffff };
+
+	bool feed(const uint32_t envelope);
+	void on_sync_pulse(const size_t length);
+	void end_line();
+};
+
+#endif/*__TV_SYNC_H__*/
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "wideband_spectrum_collector.hpp"
+
+#include "dsp_fft.hpp"
+
+#include "utility.hpp"
+#include "event_m4.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include <algorithm>
+
+void WidebandSpectrumCollector::configure(const size_t new_fft_size, const size_t new_averages, const size_t new_slice) {
+	// Called from event thread. Keep the baseband thread out until done.
+	const bool restart = (new_fft_size == fft_size);
+	fft_size = 0;
+
+	if( (new_fft_size != 1024) && (new_fft_size != 2048) ) {
+		stop();
+		return;
+	}
+
+	averages = std::max(new_averages, size_t { 1 });
+	averaged = 0;
+	slice = new_slice;
+	capture_ready = false;
+	std::fill(power.begin(), power.end(), 0.0f);
+
+	if( restart ) {
+		fft_size = new_fft_size;
+		return;
+	}
+
+	samples_since_trace = 0;
+	exchange.reset();
+	detector.reset();
+
+	fft_size = new_fft_size;
+
+	WidebandSpectrumTraceConfigMessage message { &exchange };
+	shared_memory.application_queue.push(message);
+}
+
+void WidebandSpectrumCollector::stop() {
+	fft_size = 0;
+	capture_ready = false;
+	exchange.reset();
+}
+
+void WidebandSpectrumCollector::set_detect_threshold(const uint8_t threshold) {
+	detector.set_threshold(threshold);
+	detector.reset();
+}
+
+void WidebandSpectrumCollector::feed(const buffer_c8_t& buffer) {
+	// Called from baseband processing thread.
+	samples_since_trace += buffer.count;
+
+	const size_t n = fft_size;
+	if( (n == 0) || capture_ready || (buffer.count < n) ) {
+		return;
+	}
+
+	// Don't start traces faster than the application asked for.
+	if( averaged == 0 ) {
+		const auto rate = exchange.requested_rate();
+		if( rate && (samples_since_trace < (buffer.sampling_rate / rate)) ) {
+			return;
+		}
+		samples_since_trace = 0;
+	}
+
+	std::copy(&buffer.p[0], &buffer.p[n], capture.begin());
+	sampling_rate = buffer.sampling_rate;
+	capture_ready = true;
+	EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
+}
+
+void WidebandSpectrumCollector::update() {
+	// Called from event thread (after EVT_MASK_SPECTRUM is flagged)
+	if( !running() || !capture_ready ) {
+		return;
+	}
+
+	accumulate();
+
+	averaged++;
+	if( averaged >= averages ) {
+		auto& trace = exchange.slot();
+		reduce(trace);
+
+		SignalCandidatesMessage message;
+		detector.execute(trace, column_offset, slice, message);
+		if( detector.enabled() ) {
+			shared_memory.application_queue.push(message);
+		}
+
+		exchange.publish();
+		std::fill(power.begin(), power.end(), 0.0f);
+		averaged = 0;
+	}
+
+	capture_ready = false;
+}
+
+void WidebandSpectrumCollector::accumulate() {
+	const size_t n = fft_size;
+	const size_t k = log_2(n);
+
+	for(size_t i=0; i<n; i++) {
+		const size_t i_rev = __RBIT(i) >> (32 - k);
+		const auto s = capture[i];
+		fft_buffer[i_rev] = { static_cast<float>(s.real()), static_cast<float>(s.imag()) };
+	}
+
+	fft_c_preswapped(fft_buffer.data(), n, 0, k);
+
+	/* Hann window as a three point convolution of the bins. Power goes in
+	 * with the lowest frequency first and DC in the middle.
+	 */
+	const size_t mask = n - 1;
+	const size_t half = n / 2;
+	for(size_t i=0; i<n; i++) {
+		const auto s = fft_buffer[i] * 0.5f - (fft_buffer[(i-1) & mask] + fft_buffer[(i+1) & mask]) * 0.25f;
+		power[(i + half) & mask] += magnitude_squared(s);
+	}
+}
+
+static uint8_t trace_level(const float mag2) {
+	const float db = mag2_to_dbv_norm(mag2);
+	constexpr float level_scale = 2.0f;
+	const int v = (db * level_scale) + 255.0f;
+	return std::max(0, std::min(255, v));
+}
+
+void WidebandSpectrumCollector::reduce(WidebandSpectrumTrace& trace) {
+	const size_t n = fft_size;
+	const size_t half = n / 2;
+	constexpr size_t width = WidebandSpectrumTrace::width;
+
+	// Blank the DC spike with the level either side of it.
+	const float dc_fill = (power[half - dc_guard_bins - 1] + power[half + dc_guard_bins + 1]) * 0.5f;
+	std::fill(&power[half - dc_guard_bins], &power[half + dc_guard_bins + 1], dc_fill);
+
+	// A full scale tone is (128 * n / 2)^2 per FFT through the window.
+	const float tone_scale = 64.0f * n;
+	const float scale = 1.0f / (tone_scale * tone_scale * averages);
+
+	for(size_t c=0; c<width; c++) {
+		const size_t first = c * n / width;
+		const size_t last = (c + 1) * n / width;
+		float sum = 0;
+		float max = 0;
+		size_t max_bin = first;
+		for(size_t i=first; i<last; i++) {
+			sum += power[i];
+			if( power[i] > max ) {
+				max = power[i];
+				max_bin = i;
+			}
+		}
+		trace.max[c] = trace_level(max * scale);
+		trace.mean[c] = trace_level(sum * scale / (last - first));
+		const int32_t bin_offset = static_cast<int32_t>(max_bin) - static_cast<int32_t>(half);
+		column_offset[c] = static_cast<float>(bin_offset) * sampling_rate / n;
+	}
+
+	std::array<uint8_t, width> sorted;
+	std::copy(trace.mean.begin(), trace.mean.end(), sorted.begin());
+	std::nth_element(sorted.begin(), sorted.begin() + width / 2, sorted.end());
+	trace.noise_floor = sorted[width / 2];
+
+	// Strongest local maxima of the max trace, in descending order.
+	const size_t threshold = trace.noise_floor + peak_threshold;
+	size_t count = 0;
+	for(size_t c=0; c<width; c++) {
+		const auto level = trace.max[c];
+		if( level < threshold ) {
+			continue;
+		}
+		if( ((c > 0) && (level < trace.max[c - 1])) || ((c < (width - 1)) && (level <= trace.max[c + 1])) ) {
+			continue;
+		}
+
+		size_t j = std::min(count, WidebandSpectrumTrace::peaks_max - 1);
+		if( (count == WidebandSpectrumTrace::peaks_max) && (level <= trace.peaks[j].level) ) {
+			continue;
+		}
+		for(; (j > 0) && (trace.peaks[j - 1].level < level); j--) {
+			trace.peaks[j] = trace.peaks[j - 1];
+		}
+
+		trace.peaks[j] = {
+			column_offset[c],
+			static_cast<uint8_t>(c),
+			level
+		};
+		count = std::min(count + 1, WidebandSpectrumTrace::peaks_max);
+	}
+	trace.peak_count = count;
+
+	trace.sampling_rate = sampling_rate;
+	trace.slice = slice;
+	trace.fft_size = n;
+	trace.averages = averages;
+}
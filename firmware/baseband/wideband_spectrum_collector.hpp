@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __WIDEBAND_SPECTRUM_COLLECTOR_H__
+#define __WIDEBAND_SPECTRUM_COLLECTOR_H__
+
+#include "dsp_types.hpp"
+#include "complex.hpp"
+
+#include "message.hpp"
+#include "signal_detector.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <complex>
+
+/* Full band spectrum of the raw baseband, for panoramic displays.
+ *
+ * The baseband thread only copies one buffer of samples aside. The FFT, a
+ * Hann window (applied in the frequency domain), power averaging and the
+ * reduction to one max/mean column per screen pixel plus a peak list all
+ * run in the event thread, which takes the next buffer once it is done.
+ * Traces are published through an exchange announced to the application
+ * with WidebandSpectrumTraceConfigMessage. With detection turned on, the
+ * candidates found in each trace follow in a SignalCandidatesMessage.
+ */
+class WidebandSpectrumCollector {
+public:
+	/* fft_size 1024 or 2048, anything else stops the collector. averages is
+	 * the number of FFTs per trace. Reconfiguring with the same size, e.g.
+	 * after retuning to another slice, only restarts the average.
+	 */
+	void configure(const size_t fft_size, const size_t averages, const size_t slice);
+	void stop();
+
+	void set_detect_threshold(const uint8_t threshold);
+
+	bool running() const {
+		return fft_size != 0;
+	}
+
+	void feed(const buffer_c8_t& buffer);
+	void update();
+
+private:
+	static constexpr size_t fft_size_max = 2048;
+	static constexpr size_t dc_guard_bins = 2;
+	static constexpr uint8_t peak_threshold = 20;	// 10dB over the noise floor
+
+	WidebandSpectrumTraceExchange exchange { };
+
+	std::array<complex8_t, fft_size_max> capture { };
+	std::array<std::complex<float>, fft_size_max> fft_buffer { };
+	std::array<float, fft_size_max> power { };
+	std::array<int32_t, WidebandSpectrumTrace::width> column_offset { };
+
+	SignalDetector detector { };
+
+	volatile size_t fft_size { 0 };
+	size_t averages { 1 };
+	size_t averaged { 0 };
+	size_t slice { 0 };
+	uint32_t sampling_rate { 0 };
+	size_t samples_since_trace { 0 };
+	volatile bool capture_ready { false };
+
+	void accumulate();
+	void reduce(WidebandSpectrumTrace& trace);
+};
+
+#endif/*__WIDEBAND_SPECTRUM_COLLECTOR_H__*/
@@ -24,6 +24,8 @@
 #include "sine_table.hpp"
 
 #include <math.h>
+#include <algorithm>
+#include <iterator>
 
 namespace adsb {
 
@@ -141,32 +143,23 @@ float cpr_mod(float a, float b) {
 	return a - (b * floor(a / b));
 }
 
-int cpr_NL_precise(float lat) {
-	return (int) floor(2 * PI / acos(1 - ((1 - cos(PI / (2 * NZ))) / pow(cos(PI * lat / 180), 2))));
+// Binary angle, 2^32 per turn: zone arithmetic wraps for free and needs no FPU.
+static constexpr float angle_to_degrees = 360.0f / 4294967296.0f;
+static constexpr float degrees_to_angle = 4294967296.0f / 360.0f;
+static constexpr uint32_t angle_90 = 0x40000000;
+
+static int32_t degrees_to_binary_angle(const float degrees) {
+	return static_cast<int32_t>(static_cast<uint32_t>(static_cast<int64_t>(degrees * degrees_to_angle)));
 }
 
-int cpr_NL_approx(float lat) {
-	if (lat < 0)
-		lat = -lat;		// Symmetry
-	
-	for (size_t c = 0; c < 58; c++) {
-		if (lat < adsb_lat_lut[c])
-			return 59 - c;
-	}
-	
-	return 1;	
+static int cpr_NL_angle(const int32_t lat) {
+	const uint32_t lat_abs = (lat < 0) ? -static_cast<uint32_t>(lat) : lat;
+	const auto c = std::upper_bound(std::begin(adsb_nl_lut), std::end(adsb_nl_lut), lat_abs) - std::begin(adsb_nl_lut);
+	return 59 - c;
 }
 
 int cpr_NL(float lat) {
-	// TODO prove that the approximate function is good
-	// enough for the precision we need. Uncomment if
-	// that is true. No performance penalty was noticed
-	// from testing, but if you find it might be an issue,
-	// switch to cpr_NL_approx() instead:
-
-	//return cpr_NL_approx(lat);
-
-	return cpr_NL_precise(lat);
+	return cpr_NL_angle(degrees_to_binary_angle(lat));
 }
 
 int cpr_N(float lat, int is_odd) {
@@ -223,81 +216,105 @@ void encode_frame_pos(ADSBFrame& frame, const uint32_t ICAO_address, const int32
 	frame.make_CRC();
 }
 
-// Decoding method from dump1090
+static int32_t cpr_mod(const int32_t a, const int32_t b) {
+	const int32_t r = a % b;
+	return (r < 0) ? (r + b) : r;
+}
+
+// (zone + cpr / 2^17) * (360 / zones) as a binary angle.
+static int32_t cpr_angle(const int32_t zone, const uint32_t cpr, const uint32_t zones) {
+	const int64_t position = ((static_cast<int64_t>(zone) * 131072) + cpr) * 32768;
+	return static_cast<int32_t>(static_cast<uint32_t>(position / static_cast<int64_t>(zones)));
+}
+
+/* Picks the zone nearest to reference, a binary angle, whose cpr offset
+ * (17 bits) is in a grid of the given number of zones per turn.
+ */
+static int32_t cpr_local_angle(const int32_t reference, const uint32_t cpr, const uint32_t zones) {
+	const int64_t scaled = static_cast<int64_t>(reference) * zones;
+	const int64_t offset = static_cast<int64_t>(static_cast<uint32_t>(scaled)) - (static_cast<int64_t>(cpr) << 15);
+	const int32_t zone = (scaled >> 32) + ((offset + (1LL << 31)) >> 32);
+	return cpr_angle(zone, cpr, zones);
+}
+
+static void decode_altitude(adsb_pos& position, const uint8_t* const raw_data) {
+	// Q-bit must be present
+	if (raw_data[5] & 1)
+		position.altitude = ((((raw_data[5] & 0xFE) << 3) | ((raw_data[6] & 0xF0) >> 4)) * 25) - 1000;
+}
+
+static bool set_position(adsb_pos& position, const int32_t latitude, const int32_t longitude) {
+	const uint32_t lat_abs = (latitude < 0) ? -static_cast<uint32_t>(latitude) : latitude;
+	if (lat_abs > angle_90)
+		return false;
+
+	position.latitude_angle = latitude;
+	position.longitude_angle = longitude;
+	position.latitude = latitude * angle_to_degrees;
+	position.longitude = longitude * angle_to_degrees;
+	position.valid = true;
+	return true;
+}
+
+// Global decoding of an even/odd pair, method from dump1090, in integer arithmetic
 adsb_pos decode_frame_pos(ADSBFrame& frame_even, ADSBFrame& frame_odd) {
-	uint8_t * raw_data;
-	uint32_t latcprE, latcprO, loncprE, loncprO;
-	float latE, latO, m, Dlon, cpr_lon_odd, cpr_lon_even, cpr_lat_odd, cpr_lat_even;
-	int ni;
-	adsb_pos position { false, 0, 0, 0 };
+	adsb_pos position { false, 0, 0, 0, 0, 0 };
 	
 	uint32_t time_even = frame_even.get_rx_timestamp();
 	uint32_t time_odd = frame_odd.get_rx_timestamp();
 	uint8_t * frame_data_even = frame_even.get_raw_data();
 	uint8_t * frame_data_odd = frame_odd.get_raw_data();
+	const bool use_odd = !(time_even > time_odd);
 	
 	// Return most recent altitude
-	if (time_even > time_odd)
-		raw_data = frame_data_even;
-	else
-		raw_data = frame_data_odd;
-
-	// Q-bit must be present
-	if (raw_data[5] & 1)
-		position.altitude = ((((raw_data[5] & 0xFE) << 3) | ((raw_data[6] & 0xF0) >> 4)) * 25) - 1000;
+	decode_altitude(position, use_odd ? frame_data_odd : frame_data_even);
 
 	// Position
-	latcprE = ((frame_data_even[6] & 3) << 15) | (frame_data_even[7] << 7) | (frame_data_even[8] >> 1);
-	loncprE = ((frame_data_even[8] & 1) << 16) | (frame_data_even[9] << 8) | frame_data_even[10];
+	const int32_t latcprE = ((frame_data_even[6] & 3) << 15) | (frame_data_even[7] << 7) | (frame_data_even[8] >> 1);
+	const int32_t loncprE = ((frame_data_even[8] & 1) << 16) | (frame_data_even[9] << 8) | frame_data_even[10];
 	
-	latcprO = ((frame_data_odd[6] & 3) << 15) | (frame_data_odd[7] << 7) | (frame_data_odd[8] >> 1);
-	loncprO = ((frame_data_odd[8] & 1) << 16) | (frame_data_odd[9] << 8) | frame_data_odd[10];
-
-	// Calculate the coefficients
-	cpr_lon_even = loncprE / CPR_MAX_VALUE;
-	cpr_lon_odd = loncprO / CPR_MAX_VALUE;
-
-	cpr_lat_odd = latcprO / CPR_MAX_VALUE;
-	cpr_lat_even = latcprE / CPR_MAX_VALUE;
+	const int32_t latcprO = ((frame_data_odd[6] & 3) << 15) | (frame_data_odd[7] << 7) | (frame_data_odd[8] >> 1);
+	const int32_t loncprO = ((frame_data_odd[8] & 1) << 16) | (frame_data_odd[9] << 8) | frame_data_odd[10];
 
-	// Compute latitude index
-	float j = floor(((59.0 * cpr_lat_even) - (60.0 * cpr_lat_odd)) + 0.5);
-	latE = (360.0 / 60.0) * (cpr_mod(j, 60) + cpr_lat_even);
-	latO = (360.0 / 59.0) * (cpr_mod(j, 59) + cpr_lat_odd);
-
-	if (latE >= 270) latE -= 360;
-	if (latO >= 270) latO -= 360;
+	// Compute latitude index, floor(x + 0.5) with x in 1/2^17 units
+	const int32_t j = ((59 * latcprE) - (60 * latcprO) + (1 << 16)) >> 17;
+	const int32_t latE = cpr_angle(cpr_mod(j, 60), latcprE, 60);
+	const int32_t latO = cpr_angle(cpr_mod(j, 59), latcprO, 59);
 
 	// Both frames must be in the same latitude zone
-	if (cpr_NL(latE) != cpr_NL(latO))
+	const int nl = cpr_NL_angle(latE);
+	if (nl != cpr_NL_angle(latO))
 		return position;
 
 	// Compute longitude
-	if (time_even > time_odd) {
-		// Use even frame2
-		ni = cpr_N(latE, 0);
-		Dlon = 360.0 / ni;
-		
-		m = floor((cpr_lon_even * (cpr_NL(latE) - 1)) - (cpr_lon_odd * cpr_NL(latE)) + 0.5);
-		
-		position.longitude = Dlon * (cpr_mod(m, ni) + cpr_lon_even);
-		
-		position.latitude = latE;
-	} else {
-		// Use odd frame
-		ni = cpr_N(latO, 1);
-		Dlon = 360.0 / ni;
-		
-		m = floor((cpr_lon_even * (cpr_NL(latO) - 1)) - (cpr_lon_odd * cpr_NL(latO)) + 0.5);
-		
-		position.longitude = Dlon * (cpr_mod(m, ni) + cpr_lon_odd);
-		
-		position.latitude = latO;
-	}
-	
-	if (position.longitude >= 180) position.longitude -= 360;
+	const int32_t m = ((loncprE * (nl - 1)) - (loncprO * nl) + (1 << 16)) >> 17;
+	const int32_t ni = std::max(nl - (use_odd ? 1 : 0), 1);
+	const int32_t lon = cpr_angle(cpr_mod(m, ni), use_odd ? loncprO : loncprE, ni);
+
+	set_position(position, use_odd ? latO : latE, lon);
+
+	return position;
+}
+
+/* Local decoding of a single frame against a reference position, which must
+ * be within half a zone (~180NM) of the aircraft: its last known position.
+ */
+adsb_pos decode_frame_pos_local(ADSBFrame& frame, const adsb_pos& reference) {
+	adsb_pos position { false, 0, 0, 0, 0, 0 };
 	
-	position.valid = true;
+	uint8_t * raw_data = frame.get_raw_data();
+	const int odd = (raw_data[6] & 4) ? 1 : 0;
+
+	decode_altitude(position, raw_data);
+
+	const uint32_t latcpr = ((raw_data[6] & 3) << 15) | (raw_data[7] << 7) | (raw_data[8] >> 1);
+	const uint32_t loncpr = ((raw_data[8] & 1) << 16) | (raw_data[9] << 8) | raw_data[10];
+
+	const int32_t lat = cpr_local_angle(reference.latitude_angle, latcpr, 60 - odd);
+	const int32_t ni = std::max(cpr_NL_angle(lat) - odd, 1);
+	const int32_t lon = cpr_local_angle(reference.longitude_angle, loncpr, ni);
+
+	set_position(position, lat, lon);
 
 	return position;
 }
@@ -54,6 +54,10 @@ struct adsb_pos {
 	float latitude;
 	float longitude;
 	int32_t altitude;
+	// Binary angles (2^32 per turn) the float fields were derived from,
+	// kept as the reference for local CPR decoding.
+	int32_t latitude_angle;
+	int32_t longitude_angle;
 };
 
 struct adsb_vel {
@@ -65,22 +69,27 @@ struct adsb_vel {
 
 const float CPR_MAX_VALUE = 131072.0;
 
-const float adsb_lat_lut[58] = {
-	10.47047130,    14.82817437,    18.18626357,    21.02939493,
-    23.54504487,    25.82924707,    27.93898710,    29.91135686,
-    31.77209708,    33.53993436,    35.22899598,    36.85025108,
-    38.41241892,    39.92256684,    41.38651832,    42.80914012,
-    44.19454951,    45.54626723,    46.86733252,    48.16039128,
-    49.42776439,    50.67150166,    51.89342469,    53.09516153,
-    54.27817472,    55.44378444,    56.59318756,    57.72747354,
-    58.84763776,    59.95459277,    61.04917774,    62.13216659,
-    63.20427479,    64.26616523,    65.31845310,    66.36171008,
-    67.39646774,    68.42322022,    69.44242631,    70.45451075,
-    71.45986473,    72.45884545,    73.45177442,    74.43893416,
-    75.42056257,    76.39684391,    77.36789461,    78.33374083,
-    79.29428225,    80.24923213,    81.19801349,    82.13956981,
-    83.07199445,    83.99173563,    84.89166191,    85.75541621,
-    86.53536998,    87.00000000
+/* NL transition latitudes as binary angles (2^32 per turn), rounded up so
+ * that |lat| < adsb_nl_lut[c] exactly when NL(lat) >= 59 - c. Generated
+ * from the DO-260B NL formula and checked against it for every binary
+ * angle from 0 to 90 degrees.
+ */
+const uint32_t adsb_nl_lut[58] = {
+	0x07721755, 0x0a8b6304, 0x0ceeb550, 0x0ef448d7,
+	0x10be3e9f, 0x125e1229, 0x13de232c, 0x15453244,
+	0x1697ef0b, 0x17d9c23c, 0x190d3e36, 0x1a34622d,
+	0x1b50c479, 0x1c63ae77, 0x1d6e2f8d, 0x1e712a88,
+	0x1f6d5f4a, 0x206371e6, 0x2153f001, 0x223f54e9,
+	0x23260cc7, 0x24087723, 0x24e6e8e1, 0x25c1addf,
+	0x26990a49, 0x276d3ba2, 0x283e79b4, 0x290cf742,
+	0x29d8e2b2, 0x2aa2668a, 0x2b69a9e5, 0x2c2ed0d5,
+	0x2cf1fcb3, 0x2db34c61, 0x2e72dc8c, 0x2f30c7d9,
+	0x2fed270d, 0x30a8112f, 0x31619ba1, 0x3219da2f,
+	0x32d0df13, 0x3386baf3, 0x343b7ccb, 0x34ef31c6,
+	0x35a1e4f9, 0x36539efb, 0x37046539, 0x37b438eb,
+	0x38631565, 0x3910ed49, 0x39bda5b3, 0x3a690d67,
+	0x3b12cb8b, 0x3bba3a96, 0x3c5e0e31, 0x3cfb4c0f,
+	0x3d89488a, 0x3dddddde
 };
 
 const float PI = 3.14159265358979323846;
@@ -96,6 +105,7 @@ void encode_frame_pos(ADSBFrame& frame, const uint32_t ICAO_address, const int32
 	const float latitude, const float longitude, const uint32_t time_parity);
 
 adsb_pos decode_frame_pos(ADSBFrame& frame_even, ADSBFrame& frame_odd);
+adsb_pos decode_frame_pos_local(ADSBFrame& frame, const adsb_pos& reference);
 
 void encode_frame_velo(ADSBFrame& frame, const uint32_t ICAO_address, const uint32_t speed,
 	const float angle, const int32_t v_rate);
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BTLE_PACKET_H__
+#define __BTLE_PACKET_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace btle {
+
+constexpr uint32_t advertising_access_address = 0x8E89BED6;
+
+// Advertising channel index to RF center frequency.
+constexpr uint32_t advertising_channel_frequency(const uint8_t channel_number) {
+	return (channel_number == 37) ? 2402000000 :
+		(channel_number == 38) ? 2426000000 : 2480000000;
+}
+
+enum class PDUType : uint8_t {
+	ADV_IND = 0,
+	ADV_DIRECT_IND = 1,
+	ADV_NONCONN_IND = 2,
+	SCAN_REQ = 3,
+	SCAN_RSP = 4,
+	CONNECT_REQ = 5,
+	ADV_SCAN_IND = 6,
+};
+
+/* Dewhitened advertising channel PDU (2 byte header + payload), CRC already
+ * checked and stripped.
+ */
+struct Packet {
+	static constexpr size_t header_length = 2;
+	static constexpr size_t payload_length_max = 63;
+
+	uint8_t channel_number { 0 };
+	size_t length { 0 };
+	std::array<uint8_t, header_length + payload_length_max> pdu { };
+
+	PDUType type() const {
+		return static_cast<PDUType>(pdu[0] & 0x0F);
+	}
+
+	size_t payload_length() const {
+		return pdu[1] & 0x3F;
+	}
+
+	// AdvA (or ScanA) is the first payload field for all advertising PDUs.
+	uint64_t advertiser_address() const {
+		uint64_t address = 0;
+		for(size_t i=0; i<6; i++) {
+			address |= static_cast<uint64_t>(pdu[header_length + i]) << (i * 8);
+		}
+		return address;
+	}
+};
+
+} /* namespace btle */
+
+#endif/*__BTLE_PACKET_H__*/
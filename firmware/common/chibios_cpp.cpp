@@ -22,9 +22,143 @@
 #include "chibios_cpp.hpp"
 
 #include <cstdint>
+#include <algorithm>
 
 #include <ch.h>
 
+#if defined(LPC43XX_M0)
+#include <array>
+
+/* Small blocks come from fixed-size pools in their own RAM instead of the
+ * heap. These are mostly strings, std::function state and such, created
+ * while a view is on screen but often outliving it (status bar title,
+ * settings, models). On the heap they end up between the view's blocks and
+ * keep its space from coalescing once it's popped, so a long session ends up
+ * with plenty free but no block large enough for a heavy app. Pool blocks
+ * also don't carry the heap's 8 byte header. Full pools fall back to the
+ * heap.
+ */
+namespace {
+
+struct SizeClass {
+	size_t block_size;
+	size_t blocks;
+	uint8_t* storage;
+	MemoryPool pool;
+	chibios::PoolStatistics statistics;
+
+	bool contains(const void* const p) const {
+		const auto address = reinterpret_cast<const uint8_t*>(p);
+		return (address >= storage) && (address < storage + (block_size * blocks));
+	}
+};
+
+alignas(stkalign_t) uint8_t pool_16[16 * 96];
+alignas(stkalign_t) uint8_t pool_32[32 * 64];
+alignas(stkalign_t) uint8_t pool_64[64 * 32];
+
+/* Only constant expressions here, so the table is in .data before any static
+ * constructor can call allocate(). A cast in here would make it dynamically
+ * initialized, after pools an earlier constructor had already handed out.
+ */
+std::array<SizeClass, chibios::pool_class_count> size_classes { {
+	{ 16, 96, pool_16, { }, { } },
+	{ 32, 64, pool_32, { }, { } },
+	{ 64, 32, pool_64, { }, { } },
+} };
+bool pools_ready { false };
+
+MemoryHeap* heap { nullptr };
+size_t heap_allocated { 0 };
+size_t heap_allocated_max { 0 };
+
+size_t heap_block_size(const void* const p) {
+	return (reinterpret_cast<const union heap_header*>(p) - 1)->h.size + sizeof(union heap_header);
+}
+
+void pools_init() {
+	for(auto& size_class : size_classes) {
+		chPoolInit(&size_class.pool, size_class.block_size, NULL);
+		chPoolLoadArray(&size_class.pool, size_class.storage, size_class.blocks);
+		size_class.statistics = { size_class.block_size, size_class.blocks, 0, 0, 0 };
+	}
+	pools_ready = true;
+}
+
+void* allocate(const size_t size) {
+	if( !pools_ready ) {
+		pools_init();
+	}
+
+	for(auto& size_class : size_classes) {
+		if( size <= size_class.block_size ) {
+			auto& statistics = size_class.statistics;
+			const auto p = chPoolAlloc(&size_class.pool);
+			chSysLock();
+			if( p ) {
+				statistics.used++;
+				statistics.used_max = std::max(statistics.used_max, statistics.used);
+			} else {
+				statistics.overflows++;
+			}
+			chSysUnlock();
+			if( p ) {
+				return p;
+			}
+			break;
+		}
+	}
+
+	const auto p = chHeapAlloc(0x0, size);
+	if( p ) {
+		chSysLock();
+		heap = (reinterpret_cast<union heap_header*>(p) - 1)->h.u.heap;
+		heap_allocated += heap_block_size(p);
+		heap_allocated_max = std::max(heap_allocated_max, heap_allocated);
+		chSysUnlock();
+	}
+	return p;
+}
+
+void release(void* const p) {
+	if( !p ) {
+		return;
+	}
+
+	for(auto& size_class : size_classes) {
+		if( size_class.contains(p) ) {
+			chPoolFree(&size_class.pool, p);
+			chSysLock();
+			size_class.statistics.used--;
+			chSysUnlock();
+			return;
+		}
+	}
+
+	chSysLock();
+	heap_allocated -= heap_block_size(p);
+	chSysUnlock();
+	chHeapFree(p);
+}
+
+} /* namespace */
+
+void* operator new(size_t size) {
+	return allocate(size);
+}
+
+void* operator new[](size_t size) {
+	return allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+	release(p);
+}
+
+void operator delete[](void* p) noexcept {
+	release(p);
+}
+#else
 void* operator new(size_t size) {
 	return chHeapAlloc(0x0, size);
 }
@@ -40,6 +174,7 @@ void operator delete(void* p) noexcept {
 void operator delete[](void* p) noexcept {
 	chHeapFree(p);
 }
+#endif
 
 void operator delete(void* ptr, std::size_t) noexcept {
 	::operator delete(ptr);
@@ -65,4 +200,40 @@ size_t heap_used() {
 	return heap_size() - (core_free + heap_free);
 }
 
+#if defined(LPC43XX_M0)
+HeapStatistics heap_statistics() {
+	HeapStatistics statistics { };
+
+	statistics.core_free = chCoreStatus();
+	statistics.free_fragments = chHeapStatus(NULL, &statistics.free_fragmented);
+
+	// Blocks handed out by new and their high-water mark
+	chSysLock();
+	statistics.used = heap_allocated;
+	statistics.used_max = heap_allocated_max;
+	const auto h = heap;
+	chSysUnlock();
+
+	// Largest free block, anything bigger has to come from untouched core memory
+	size_t largest = 0;
+	if( h ) {
+		chMtxLock(&h->h_mtx);
+		for(auto block = h->h_free.h.u.next; block; block = block->h.u.next) {
+			largest = std::max(largest, block->h.size);
+		}
+		chMtxUnlock();
+	}
+	statistics.largest_free = std::max(largest, statistics.core_free);
+
+	return statistics;
+}
+
+PoolStatistics pool_statistics(const size_t size_class) {
+	chSysLock();
+	const auto statistics = size_classes[size_class].statistics;
+	chSysUnlock();
+	return statistics;
+}
+#endif
+
 } /* namespace chibios */
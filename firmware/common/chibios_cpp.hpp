@@ -38,6 +38,30 @@ namespace chibios {
 size_t heap_size();
 size_t heap_used();
 
+#if defined(LPC43XX_M0)
+struct HeapStatistics {
+	size_t used;				// Heap blocks held through new, headers included
+	size_t used_max;			// High-water mark of used
+	size_t free_fragments;
+	size_t free_fragmented;		// Free bytes in the heap's free list
+	size_t largest_free;		// Largest block new can return
+	size_t core_free;			// Never yet used by the heap
+};
+
+struct PoolStatistics {
+	size_t block_size;
+	size_t blocks;
+	size_t used;
+	size_t used_max;
+	size_t overflows;			// Allocations that went to the heap, pool full
+};
+
+constexpr size_t pool_class_count = 3;
+
+HeapStatistics heap_statistics();
+PoolStatistics pool_statistics(const size_t size_class);
+#endif
+
 } /* namespace chibios */
 
 #endif/*__CHIBIOS_CPP_H__*/
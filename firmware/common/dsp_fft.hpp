@@ -99,14 +99,10 @@ void fft_swap_in_place(std::array<T, N>& data) {
 /* http://beige.ucs.indiana.edu/B673/node14.html */
 /* http://www.drdobbs.com/cpp/a-simple-and-efficient-fft-implementatio/199500857?pgno=3 */
 
-template<typename T, size_t N>
-void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to) {
-	static_assert(power_of_two(N), "only defined for N == power of two");
-	constexpr auto K = log_2(N);
-	if ((to > K) || (from > K)) return;
-
-	constexpr size_t K_max = 8;
-	static_assert(K <= K_max, "No FFT twiddle factors for K > 8");
+/* Size known only at run time, for processors that switch FFT length. */
+template<typename T>
+void fft_c_preswapped(T* const data, const size_t N, const size_t from, const size_t to) {
+	constexpr size_t K_max = 11;
 	static constexpr std::array<std::complex<float>, K_max> wp_table { {
 		{ -2.0f,                        0.0f                     },	// 2
 		{ -1.0f,                       -1.0f                     },	// 4
@@ -116,7 +112,11 @@ void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to
 		{ -0.0048152733278031137552f,  -0.098017140329560601994f },	// 64
 		{ -0.0012045437948276072852f,  -0.049067674327418014255f },	// 128
 		{ -0.00030118130379577988423f, -0.024541228522912288032f },	// 256
+		{ -0.000075298160855459076f,   -0.012271538285719925172f },	// 512
+		{ -0.000018824717398857340f,   -0.0061358846491544753596f },	// 1024
+		{ -0.0000047061904238284880f,  -0.0030679567629659762701f },	// 2048
 	} };
+	if ((to > K_max) || (from > K_max)) return;
 
 	/* Provide data to this function, pre-swapped. */
 	for(size_t k = from; k < to; k++) {
@@ -135,4 +135,14 @@ void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to
 	}
 }
 
+template<typename T, size_t N>
+void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to) {
+	static_assert(power_of_two(N), "only defined for N == power of two");
+	constexpr auto K = log_2(N);
+	static_assert(K <= 11, "No FFT twiddle factors for K > 11");
+	if ((to > K) || (from > K)) return;
+
+	fft_c_preswapped(data.data(), N, from, to);
+}
+
 #endif/*__DSP_FFT_H__*/
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "iq_format.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace iq {
+
+static uint8_t block_shift(const complex16_t* const src, const size_t count) {
+	// OR of the magnitudes has the same top bit as their maximum.
+	int32_t peak = 0;
+	for(size_t i=0; i<count; i++) {
+		peak |= std::abs(static_cast<int32_t>(src[i].real()));
+		peak |= std::abs(static_cast<int32_t>(src[i].imag()));
+	}
+
+	uint8_t shift = 0;
+	while( (peak >> shift) > 127 ) {
+		shift++;
+	}
+	return shift;
+}
+
+size_t encode(const Format format, const complex16_t* const src, const size_t count, uint8_t* const dst) {
+	auto p = reinterpret_cast<int8_t*>(dst);
+
+	switch(format) {
+	case Format::C8:
+		for(size_t i=0; i<count; i++) {
+			*(p++) = src[i].real() >> 8;
+			*(p++) = src[i].imag() >> 8;
+		}
+		break;
+
+	case Format::BlockFloat:
+		for(size_t n=0; n<count; n+=block_samples) {
+			const auto length = std::min(block_samples, count - n);
+			const auto shift = block_shift(&src[n], length);
+			*(p++) = shift;
+			*(p++) = 0;
+			for(size_t i=n; i<(n + length); i++) {
+				*(p++) = src[i].real() >> shift;
+				*(p++) = src[i].imag() >> shift;
+			}
+		}
+		break;
+
+	default:
+		std::copy(src, src + count, reinterpret_cast<complex16_t*>(dst));
+		break;
+	}
+
+	return encoded_size(format, count);
+}
+
+/* Both encodings are smaller than C16 and each encoded sample sits at or
+ * before its decoded position, so expanding from the end backwards never
+ * overwrites bytes that are still to be read.
+ */
+void decode(const Format format, complex16_t* const buffer, const size_t count) {
+	const auto p = reinterpret_cast<const int8_t*>(buffer);
+
+	switch(format) {
+	case Format::C8:
+		for(size_t i=count; i>0; i--) {
+			const int16_t re = p[(i - 1) * 2 + 0];
+			const int16_t im = p[(i - 1) * 2 + 1];
+			buffer[i - 1] = { static_cast<int16_t>(re * 256), static_cast<int16_t>(im * 256) };
+		}
+		break;
+
+	case Format::BlockFloat:
+		for(size_t blocks=(count + block_samples - 1) / block_samples; blocks>0; blocks--) {
+			const size_t n = (blocks - 1) * block_samples;
+			const auto length = std::min(block_samples, count - n);
+			const auto block = &p[(blocks - 1) * block_bytes];
+			const auto shift = static_cast<uint8_t>(block[0]);
+			for(size_t i=length; i>0; i--) {
+				const int16_t re = block[block_header_bytes + (i - 1) * 2 + 0];
+				const int16_t im = block[block_header_bytes + (i - 1) * 2 + 1];
+				buffer[n + i - 1] = { static_cast<int16_t>(re * (1 << shift)), static_cast<int16_t>(im * (1 << shift)) };
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+} /* namespace iq */
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __IQ_FORMAT_H__
+#define __IQ_FORMAT_H__
+
+#include "complex.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace iq {
+
+/* Sample formats for captured baseband files. C16 is the native output of
+ * the capture decimators, C8 keeps the top byte of each component and
+ * BlockFloat ("CBF") shares one exponent between a block of 8 bit samples.
+ */
+enum class Format : uint8_t {
+	C16 = 0,
+	C8 = 1,
+	BlockFloat = 2,
+};
+
+/* A BlockFloat stream is a sequence of blocks, each a shift byte and a pad
+ * byte followed by block_samples interleaved int8 I/Q mantissas. A sample is
+ * (mantissa << shift). The shift is picked from the largest component in the
+ * block, so weak signals keep the low order bits that C8 truncates away.
+ */
+constexpr size_t block_samples = 64;
+constexpr size_t block_header_bytes = 2;
+constexpr size_t block_bytes = block_header_bytes + block_samples * 2;
+
+constexpr size_t encoded_size(const Format format, const size_t count) {
+	return (format == Format::C8) ? (count * 2)
+		: (format == Format::BlockFloat) ? ((count / block_samples) * block_bytes + ((count % block_samples) ? (block_header_bytes + (count % block_samples) * 2) : 0))
+		: (count * sizeof(complex16_t));
+}
+
+/* Used as the file extension and in the capture metadata file. */
+constexpr const char* name(const Format format) {
+	return (format == Format::C8) ? "C8"
+		: (format == Format::BlockFloat) ? "CBF"
+		: "C16";
+}
+
+/* Writes encoded_size(format, count) bytes to dst. */
+size_t encode(const Format format, const complex16_t* const src, const size_t count, uint8_t* const dst);
+
+/* Expands encoded_size(format, count) bytes at the start of buffer to count
+ * C16 samples, in place.
+ */
+void decode(const Format format, complex16_t* const buffer, const size_t count);
+
+} /* namespace iq */
+
+#endif/*__IQ_FORMAT_H__*/
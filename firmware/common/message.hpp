@@ -34,15 +34,19 @@
 
 #include "acars_packet.hpp"
 #include "adsb_frame.hpp"
+#include "btle_packet.hpp"
 #include "ert_packet.hpp"
 #include "pocsag_packet.hpp"
 #include "aprs_packet.hpp"
 #include "sonde_packet.hpp"
 #include "tpms_packet.hpp"
+#include "rds_packet.hpp"
 #include "jammer.hpp"
 #include "dsp_fir_taps.hpp"
 #include "dsp_iir.hpp"
 #include "fifo.hpp"
+#include "triple_buffer.hpp"
+#include "iq_format.hpp"
 
 #include "utility.hpp"
 
@@ -109,6 +113,16 @@ public:
 		AudioSpectrum = 52,
 		APRSPacket = 53,
 		APRSRxConfigure = 54,
+		RDSGroup = 55,
+		ProcessorProfile = 56,
+		BTLEPacket = 57,
+		VideoLineConfig = 58,
+		RSSIStreamConfig = 59,
+		RSSIEnvelope = 60,
+		CoreClock = 61,
+		WidebandSpectrumTraceConfig = 62,
+		SignalDetectConfig = 63,
+		SignalCandidates = 64,
 		MAX
 	};
 
@@ -140,6 +154,50 @@ public:
 	RSSIStatistics statistics;
 };
 
+struct RSSIStreamConfig {
+	enum class Mode : uint8_t {
+		Stopped = 0,
+		Stream = 1,		// Continuous envelope, in batches
+		Burst = 2,		// Only envelope around samples >= threshold
+	};
+
+	Mode mode { Mode::Stopped };
+	uint8_t threshold { 0 };
+	uint16_t pre_trigger { 0 };		// Envelope samples kept ahead of the trigger
+	uint16_t post_trigger { 0 };	// Envelope samples below threshold that end a burst
+	uint32_t decimation { 1 };		// RSSI samples per envelope sample (peak), raised to a rate limit
+};
+
+class RSSIStreamConfigMessage : public Message {
+public:
+	constexpr RSSIStreamConfigMessage(
+		const RSSIStreamConfig& config
+	) : Message { ID::RSSIStreamConfig },
+		config { config }
+	{
+	}
+
+	RSSIStreamConfig config;
+};
+
+class RSSIEnvelopeMessage : public Message {
+public:
+	static constexpr size_t samples_max = 240;
+	static constexpr uint16_t no_trigger = 0xffff;
+
+	constexpr RSSIEnvelopeMessage(
+	) : Message { ID::RSSIEnvelope }
+	{
+	}
+
+	uint64_t timestamp { 0 };			// RSSI sample index of samples[0]
+	uint32_t sampling_rate { 0 };		// Envelope sample rate
+	uint16_t count { 0 };
+	uint16_t trigger { no_trigger };	// Index of the triggering sample, if in this batch
+	bool burst_end { false };			// Burst mode: last batch of the burst
+	std::array<uint8_t, samples_max> samples { };
+};
+
 struct BasebandStatistics {
 	uint32_t idle_ticks { 0 };
 	uint32_t main_ticks { 0 };
@@ -160,6 +218,55 @@ public:
 	BasebandStatistics statistics;
 };
 
+struct ProcessorProfile {
+	static constexpr size_t stages_max = 8;
+	static constexpr size_t name_length = 7;
+
+	struct Stage {
+		std::array<char, name_length + 1> name { };
+		uint32_t calls { 0 };
+		uint32_t cycles_min { 0 };
+		uint32_t cycles_max { 0 };
+		uint32_t cycles_total { 0 };
+
+		uint32_t cycles_mean() const {
+			return calls ? (cycles_total / calls) : 0;
+		}
+	};
+
+	/* Stage 0 is the whole BasebandProcessor::execute(), measured by the
+	 * baseband thread. cycles_elapsed is the length of the report interval,
+	 * so cycles_total / cycles_elapsed is the share of the M4 a stage used.
+	 */
+	uint32_t cycles_elapsed { 0 };
+	size_t stage_count { 0 };
+	std::array<Stage, stages_max> stages { };
+};
+
+class CoreClockMessage : public Message {
+public:
+	constexpr CoreClockMessage(
+		const uint32_t clock_f
+	) : Message { ID::CoreClock },
+		clock_f { clock_f }
+	{
+	}
+
+	uint32_t clock_f;
+};
+
+class ProcessorProfileMessage : public Message {
+public:
+	constexpr ProcessorProfileMessage(
+		const ProcessorProfile& profile
+	) : Message { ID::ProcessorProfile },
+		profile { profile }
+	{
+	}
+
+	ProcessorProfile profile;
+};
+
 struct ChannelStatistics {
 	int32_t max_db;
 	size_t count;
@@ -261,19 +368,34 @@ public:
 	Mode mode { Mode::Stopped };
 };
 
+/* fft_size 0 keeps the 256 bin channel spectrum, summed over trigger + 1
+ * buffers. 1024 or 2048 computes full band traces instead, each averaged
+ * over the given number of FFTs, see WidebandSpectrumTrace. Applications
+ * stepping the LO number each tuning with slice, the signal detector keeps
+ * a noise floor per slice.
+ */
 class WidebandSpectrumConfigMessage : public Message {
 public:
 	constexpr WidebandSpectrumConfigMessage (
 		size_t sampling_rate,
-		size_t trigger
+		size_t trigger,
+		size_t fft_size = 0,
+		size_t averages = 0,
+		size_t slice = 0
 	) : Message { ID::WidebandSpectrumConfig },
 		sampling_rate { sampling_rate },
-		trigger { trigger }
+		trigger { trigger },
+		fft_size { fft_size },
+		averages { averages },
+		slice { slice }
 	{
 	}
 
 	size_t sampling_rate { 0 };
 	size_t trigger { 0 };
+	size_t fft_size { 0 };
+	size_t averages { 0 };
+	size_t slice { 0 };
 };
 
 struct AudioSpectrum {
@@ -301,20 +423,131 @@ struct ChannelSpectrum {
 	int32_t channel_filter_transition { 0 };
 };
 
-using ChannelSpectrumFIFO = FIFO<ChannelSpectrum>;
+using ChannelSpectrumExchange = TripleBuffer<ChannelSpectrum>;
 
 class ChannelSpectrumConfigMessage : public Message {
 public:
-	static constexpr size_t fifo_k = 2;
-	
 	constexpr ChannelSpectrumConfigMessage(
-		ChannelSpectrumFIFO* fifo
+		ChannelSpectrumExchange* exchange
 	) : Message { ID::ChannelSpectrumConfig },
+		exchange { exchange }
+	{
+	}
+
+	ChannelSpectrumExchange* exchange { nullptr };
+};
+
+/* Full band spectrum reduced to one column per screen pixel, lowest
+ * frequency first. Levels are 0.5dB per unit, 255 is a full scale tone.
+ */
+struct WidebandSpectrumTrace {
+	static constexpr size_t width = 240;
+	static constexpr size_t peaks_max = 8;
+
+	struct Peak {
+		int32_t frequency_offset;	// Hz from center
+		uint8_t column;
+		uint8_t level;
+	};
+
+	std::array<uint8_t, width> max { { 0 } };
+	std::array<uint8_t, width> mean { { 0 } };
+	std::array<Peak, peaks_max> peaks { };
+	size_t peak_count { 0 };
+	uint8_t noise_floor { 0 };
+	uint32_t sampling_rate { 0 };
+	uint32_t slice { 0 };
+	uint16_t fft_size { 0 };
+	uint16_t averages { 0 };
+};
+
+using WidebandSpectrumTraceExchange = TripleBuffer<WidebandSpectrumTrace>;
+
+class WidebandSpectrumTraceConfigMessage : public Message {
+public:
+	constexpr WidebandSpectrumTraceConfigMessage(
+		WidebandSpectrumTraceExchange* exchange
+	) : Message { ID::WidebandSpectrumTraceConfig },
+		exchange { exchange }
+	{
+	}
+
+	WidebandSpectrumTraceExchange* exchange { nullptr };
+};
+
+/* Level over the noise floor to detect at, in trace units, 0 turns it off.
+ * Also forgets the noise floors, so send it again after changing gain or
+ * the frequencies of the slices.
+ */
+class SignalDetectConfigMessage : public Message {
+public:
+	constexpr SignalDetectConfigMessage(
+		uint8_t threshold
+	) : Message { ID::SignalDetectConfig },
+		threshold { threshold }
+	{
+	}
+
+	uint8_t threshold { 0 };
+};
+
+struct SignalCandidate {
+	int32_t center_offset;	// Hz from center
+	uint32_t bandwidth;		// Hz
+	uint8_t level;			// Peak, trace units
+	uint8_t snr;			// Peak over the noise reference, trace units
+};
+
+/* Emitters found in one wideband trace, strongest over their noise
+ * reference first.
+ */
+class SignalCandidatesMessage : public Message {
+public:
+	static constexpr size_t candidates_max = 16;
+
+	constexpr SignalCandidatesMessage(
+	) : Message { ID::SignalCandidates }
+	{
+	}
+
+	uint32_t slice { 0 };
+	uint32_t sampling_rate { 0 };
+	uint8_t noise_floor { 0 };
+	size_t count { 0 };
+	std::array<SignalCandidate, candidates_max> candidates { };
+};
+
+/* One horizontal line of analog TV, aligned so the horizontal sync leading
+ * edge is sample 0. 64us at 2Msps.
+ */
+struct VideoLine {
+	static constexpr size_t samples_per_line = 128;
+	static constexpr size_t active_first_sample = 22;
+	static constexpr size_t active_samples = 104;
+	static constexpr size_t active_first_line = 23;
+	static constexpr size_t active_lines = 288;
+
+	// Counted from the start of vertical sync.
+	uint16_t line_number { 0 };
+	uint8_t field { 0 };
+	bool locked { false };
+	std::array<uint8_t, samples_per_line> luma { { 0 } };
+};
+
+using VideoLineFIFO = FIFO<VideoLine>;
+
+class VideoLineConfigMessage : public Message {
+public:
+	static constexpr size_t fifo_k = 7;
+	
+	constexpr VideoLineConfigMessage(
+		VideoLineFIFO* fifo
+	) : Message { ID::VideoLineConfig },
 		fifo { fifo }
 	{
 	}
 
-	ChannelSpectrumFIFO* fifo { nullptr };
+	VideoLineFIFO* fifo { nullptr };
 };
 
 class AISPacketMessage : public Message {
@@ -400,14 +633,29 @@ public:
 
 class CodedSquelchMessage : public Message {
 public:
+	enum class Type : uint8_t {
+		CTCSS = 0,
+		DCS = 1,
+		DTMF = 2,
+	};
+
 	constexpr CodedSquelchMessage(
-		const uint32_t value
+		const Type type,
+		const uint32_t value,
+		const uint8_t confidence
 	) : Message { ID::CodedSquelch },
-		value { value }
+		type { type },
+		value { value },
+		confidence { confidence }
 	{
 	}
 	
+	Type type;
+	/* CTCSS: tone frequency in 1/100 Hz.
+	 * DCS: 9 bit code, bit 9 set if received inverted.
+	 * DTMF: key character. */
 	uint32_t value;
+	uint8_t confidence;		// Percent
 };
 
 class ShutdownMessage : public Message {
@@ -511,14 +759,16 @@ public:
 		const fir_taps_real<64> audio_filter,
 		const size_t deviation,
 		const iir_biquad_config_t audio_hpf_config,
-		const iir_biquad_config_t audio_deemph_config
+		const iir_biquad_config_t audio_deemph_config,
+		const bool stereo
 	) : Message { ID::WFMConfigure },
 		decim_0_filter(decim_0_filter),
 		decim_1_filter(decim_1_filter),
 		audio_filter(audio_filter),
 		deviation { deviation },
 		audio_hpf_config(audio_hpf_config),
-		audio_deemph_config(audio_deemph_config)
+		audio_deemph_config(audio_deemph_config),
+		stereo { stereo }
 	{
 	}
 
@@ -528,6 +778,7 @@ public:
 	const size_t deviation;
 	const iir_biquad_config_t audio_hpf_config;
 	const iir_biquad_config_t audio_deemph_config;
+	const bool stereo;
 };
 
 class AMConfigureMessage : public Message {
@@ -624,6 +875,7 @@ public:
 struct CaptureConfig {
 	const size_t write_size;
 	const size_t buffer_count;
+	const iq::Format format;
 	uint64_t baseband_bytes_received;
 	uint64_t baseband_bytes_dropped;
 	FIFO<StreamBuffer*>* fifo_buffers_empty;
@@ -631,9 +883,11 @@ struct CaptureConfig {
 
 	constexpr CaptureConfig(
 		const size_t write_size,
-		const size_t buffer_count
+		const size_t buffer_count,
+		const iq::Format format = iq::Format::C16
 	) : write_size { write_size },
 		buffer_count { buffer_count },
+		format { format },
 		baseband_bytes_received { 0 },
 		baseband_bytes_dropped { 0 },
 		fifo_buffers_empty { nullptr },
@@ -666,20 +920,37 @@ public:
 struct ReplayConfig {
 	const size_t read_size;
 	const size_t buffer_count;
+	const iq::Format format;
+	const uint32_t sample_rate;		// File sample rate, 0 if fixed by the baseband image
 	uint64_t baseband_bytes_received;
+	uint64_t baseband_bytes_missed;
 	FIFO<StreamBuffer*>* fifo_buffers_empty;
 	FIFO<StreamBuffer*>* fifo_buffers_full;
 
 	constexpr ReplayConfig(
 		const size_t read_size,
-		const size_t buffer_count
+		const size_t buffer_count,
+		const iq::Format format = iq::Format::C16,
+		const uint32_t sample_rate = 0
 	) : read_size { read_size },
 		buffer_count { buffer_count },
+		format { format },
+		sample_rate { sample_rate },
 		baseband_bytes_received { 0 },
+		baseband_bytes_missed { 0 },
 		fifo_buffers_empty { nullptr },
 		fifo_buffers_full { nullptr }
 	{
 	}
+
+	size_t missed_percent() const {
+		if( baseband_bytes_missed == 0 ) {
+			return 0;
+		} else {
+			const size_t percent = baseband_bytes_missed * 100U / baseband_bytes_received;
+			return std::max(1U, percent);
+		}
+	}
 };
 
 class ReplayConfigMessage : public Message {
@@ -741,21 +1012,26 @@ public:
 class BTLERxConfigureMessage : public Message {
 public:
 	constexpr BTLERxConfigureMessage(
-		const uint32_t baudrate,
-		const uint32_t word_length,
-		const uint32_t trigger_value,
-		const bool trigger_word
+		const uint8_t channel_number
 	) : Message { ID::BTLERxConfigure },
-		baudrate(baudrate),
-		word_length(word_length),
-		trigger_value(trigger_value),
-		trigger_word(trigger_word)
+		channel_number(channel_number)
 	{
-    }
-	const uint32_t baudrate;
-	const uint32_t word_length;
-	const uint32_t trigger_value;
-	const bool trigger_word;
+	}
+
+	// Advertising channel index (37..39), seeds the dewhitening LFSR.
+	const uint8_t channel_number;
+};
+
+class BTLEPacketMessage : public Message {
+public:
+	constexpr BTLEPacketMessage(
+		const btle::Packet& packet
+	) : Message { ID::BTLEPacket },
+		packet { packet }
+	{
+	}
+
+	btle::Packet packet;
 };
 
 class NRFRxConfigureMessage : public Message {
@@ -1033,6 +1309,18 @@ public:
 };
 
 
+class RDSGroupMessage : public Message {
+public:
+	constexpr RDSGroupMessage(
+		const rds::ReceivedGroup& group
+	) : Message { ID::RDSGroup },
+		group { group }
+	{
+	}
+
+	rds::ReceivedGroup group;
+};
+
 class ADSBConfigureMessage : public Message {
 public:
 	constexpr ADSBConfigureMessage(
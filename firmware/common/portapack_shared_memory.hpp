@@ -64,6 +64,23 @@ struct SharedMemory {
 		JammerChannel jammer_channels[24];
 		uint8_t data[512];
 	} bb_data { { { { 0, 0 } }, 0, { 0 } } };
+
+	// Core clock set by the application, 0 until it first changes from the default.
+	uint32_t core_clock_f { 0 };
+
+	/* Written by the baseband processor once per profile interval, see
+	 * CycleProfiler. sequence is bumped last, so a reader that sees it change
+	 * can take the other two.
+	 */
+	struct ProcessorLoad {
+		uint32_t cycles_busy;
+		uint32_t cycles_elapsed;
+		uint32_t sequence;
+	};
+	volatile ProcessorLoad processor_load { 0, 0, 0 };
+
+	// Set by the application while it wants a ProcessorProfileMessage per interval.
+	volatile bool processor_profile_requested { false };
 };
 
 extern SharedMemory& shared_memory;
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RDS_PACKET_H__
+#define __RDS_PACKET_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace rds {
+
+enum class BlockStatus : uint8_t {
+	Invalid = 0,
+	Valid = 1,
+	Corrected = 2,
+};
+
+// One received group: 4 blocks of 16 information bits, checkwords stripped.
+struct ReceivedGroup {
+	std::array<uint16_t, 4> block { { 0, 0, 0, 0 } };
+	std::array<BlockStatus, 4> status { { BlockStatus::Invalid, BlockStatus::Invalid, BlockStatus::Invalid, BlockStatus::Invalid } };
+
+	bool valid(const size_t index) const {
+		return (index < status.size()) && (status[index] != BlockStatus::Invalid);
+	}
+
+	void clear() {
+		block.fill(0);
+		status.fill(BlockStatus::Invalid);
+	}
+};
+
+} /* namespace rds */
+
+#endif/*__RDS_PACKET_H__*/
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "rds_sync.hpp"
+
+#include <algorithm>
+
+namespace rds {
+
+/* Checkword = (data * x^10 mod g(x)) xor offset, so the syndrome of an
+ * error-free block is the offset word itself.
+ */
+static constexpr uint32_t offset_a = 0x0fc;
+static constexpr uint32_t offset_b = 0x198;
+static constexpr uint32_t offset_c = 0x168;
+static constexpr uint32_t offset_cp = 0x350;
+static constexpr uint32_t offset_d = 0x1b4;
+
+static constexpr std::array<uint32_t, 4> block_offsets { { offset_a, offset_b, offset_c, offset_d } };
+
+static int block_index(const uint32_t syndrome) {
+	switch(syndrome) {
+	case offset_a:	return 0;
+	case offset_b:	return 1;
+	case offset_c:
+	case offset_cp:	return 2;
+	case offset_d:	return 3;
+	default:		return -1;
+	}
+}
+
+/* Correctable bursts of up to 5 bits, as (syndrome << 16) | (shift << 8) | burst,
+ * sorted by syndrome. 367 of them, generated at compile time so they cost
+ * 1.5KB of image instead of a 4KB syndrome-indexed table in RAM.
+ */
+static constexpr size_t max_burst_length = 5;
+
+static constexpr size_t burst_count() {
+	size_t count = 0;
+	for(size_t length=1; length<=max_burst_length; length++) {
+		const size_t inner_count = (length > 2) ? (1UL << (length - 2)) : 1;
+		count += inner_count * (BlockSync::block_bits - length + 1);
+	}
+	return count;
+}
+
+static constexpr std::array<uint32_t, burst_count()> make_burst_list() {
+	std::array<uint32_t, burst_count()> list { };
+	size_t n = 0;
+
+	/* Bursts start and end with a 1 bit, so a burst of length n is
+	 * 1 x..x 1 with (n - 2) free bits in between.
+	 */
+	for(size_t length=1; length<=max_burst_length; length++) {
+		const uint32_t ends = (length == 1) ? 1 : ((1UL << (length - 1)) | 1);
+		const uint32_t inner_count = (length > 2) ? (1UL << (length - 2)) : 1;
+		for(uint32_t inner=0; inner<inner_count; inner++) {
+			const uint32_t burst = ends | (inner << 1);
+			for(size_t shift=0; shift<=(BlockSync::block_bits - length); shift++) {
+				list[n++] = (BlockSync::syndrome(burst << shift) << 16) | (shift << 8) | burst;
+			}
+		}
+	}
+
+	for(size_t i=1; i<list.size(); i++) {
+		const auto entry = list[i];
+		size_t j = i;
+		for(; (j > 0) && (list[j - 1] > entry); j--) {
+			list[j] = list[j - 1];
+		}
+		list[j] = entry;
+	}
+
+	return list;
+}
+
+static constexpr auto burst_list = make_burst_list();
+
+static constexpr bool syndromes_unique() {
+	for(size_t i=1; i<burst_list.size(); i++) {
+		if( (burst_list[i] >> 16) == (burst_list[i - 1] >> 16) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static_assert(syndromes_unique(), "RDS code must tell bursts of up to 5 bits apart");
+
+// Burst error pattern for a syndrome, 0 if not a correctable burst.
+static uint32_t burst_error(const uint32_t syndrome) {
+	const auto it = std::lower_bound(burst_list.begin(), burst_list.end(), syndrome << 16);
+	if( (it == burst_list.end()) || ((*it >> 16) != syndrome) ) {
+		return 0;
+	}
+	return (*it & 0xff) << ((*it >> 8) & 0xff);
+}
+
+void BlockSync::reset() {
+	reg = 0;
+	bit_counter = 0;
+	synchronized_ = false;
+	block_bit_count = 0;
+	expected_block = 0;
+	error_history = 0;
+	candidate_valid = false;
+	group_.clear();
+}
+
+bool BlockSync::execute(const uint_fast8_t bit) {
+	reg = ((reg << 1) | (bit & 1)) & block_mask;
+	bit_counter++;
+
+	if( !synchronized_ ) {
+		acquire();
+		return false;
+	}
+
+	block_bit_count++;
+	if( block_bit_count < block_bits ) {
+		return false;
+	}
+	block_bit_count = 0;
+
+	return process_block();
+}
+
+void BlockSync::acquire() {
+	const auto index = block_index(syndrome(reg));
+	if( index < 0 ) {
+		return;
+	}
+
+	/* Two offset words at a spacing consistent with their block positions
+	 * establish sync. Repeated identical offsets are one group apart.
+	 */
+	if( candidate_valid ) {
+		const size_t block_distance = ((index - static_cast<int>(candidate_block) + 3) & 3) + 1;
+		if( (bit_counter - candidate_bit) == (block_distance * block_bits) ) {
+			synchronized_ = true;
+			block_bit_count = 0;
+			expected_block = (index + 1) % 4;
+			error_history = 0;
+			group_.clear();
+			candidate_valid = false;
+			return;
+		}
+	}
+
+	candidate_valid = true;
+	candidate_block = index;
+	candidate_bit = bit_counter;
+}
+
+BlockStatus BlockSync::check_block(uint32_t& word, const uint32_t offset) const {
+	const auto s = syndrome(word);
+	if( s == offset ) {
+		return BlockStatus::Valid;
+	}
+
+	const auto error = burst_error(s ^ offset);
+	if( error ) {
+		word ^= error;
+		return BlockStatus::Corrected;
+	}
+
+	return BlockStatus::Invalid;
+}
+
+bool BlockSync::process_block() {
+	const auto index = expected_block;
+	expected_block = (expected_block + 1) % 4;
+
+	if( index == 0 ) {
+		group_.clear();
+	}
+
+	uint32_t word = reg;
+	auto status = check_block(word, block_offsets[index]);
+	if( (status != BlockStatus::Valid) && (index == 2) ) {
+		// Version B groups use C' in the third block.
+		uint32_t word_cp = reg;
+		const auto status_cp = check_block(word_cp, offset_cp);
+		if( (status_cp == BlockStatus::Valid) || (status == BlockStatus::Invalid) ) {
+			word = word_cp;
+			status = status_cp;
+		}
+	}
+
+	blocks_received_++;
+	if( status == BlockStatus::Corrected ) {
+		blocks_corrected_++;
+	}
+	if( status == BlockStatus::Invalid ) {
+		blocks_invalid_++;
+	}
+
+	group_.block[index] = word >> check_bits;
+	group_.status[index] = status;
+
+	error_history = (error_history << 1) | ((status == BlockStatus::Invalid) ? 1 : 0);
+	const size_t errors = __builtin_popcountll(error_history & ((1ULL << error_window) - 1));
+	if( errors >= error_threshold ) {
+		synchronized_ = false;
+		candidate_valid = false;
+		group_.clear();
+		return false;
+	}
+
+	return (index == 3);
+}
+
+} /* namespace rds */
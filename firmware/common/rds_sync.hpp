@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RDS_SYNC_H__
+#define __RDS_SYNC_H__
+
+#include "rds_packet.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace rds {
+
+/* Block synchronizer and (26,16) shortened cyclic code checker.
+ * Takes differentially-decoded bits, finds block boundaries from offset word
+ * syndromes, corrects bursts of up to 5 bits and assembles groups.
+ *
+ * Has no OS or hardware dependencies so it can be built and exercised on a
+ * host against recorded bit streams.
+ */
+class BlockSync {
+public:
+	/* Returns true when a group has been completed, retrieve it with group()
+	 * before the next call.
+	 */
+	bool execute(const uint_fast8_t bit);
+
+	const ReceivedGroup& group() const {
+		return group_;
+	}
+
+	bool synchronized() const {
+		return synchronized_;
+	}
+
+	void reset();
+
+	uint32_t blocks_received() const { return blocks_received_; }
+	uint32_t blocks_corrected() const { return blocks_corrected_; }
+	uint32_t blocks_invalid() const { return blocks_invalid_; }
+
+	static constexpr size_t block_bits = 26;
+	static constexpr size_t check_bits = 10;
+
+	// g(x) = x^10 + x^8 + x^7 + x^5 + x^4 + x^3 + 1
+	static constexpr uint32_t generator = 0x5b9;
+
+	static constexpr uint32_t syndrome(uint32_t word) {
+		for(size_t i=block_bits - 1; i>=check_bits; i--) {
+			if( word & (1UL << i) ) {
+				word ^= generator << (i - check_bits);
+			}
+		}
+		return word;
+	}
+
+private:
+	static constexpr uint32_t block_mask = (1UL << block_bits) - 1;
+
+	// EN 50067 Annex C: drop sync when 45 of the last 50 blocks are bad.
+	static constexpr size_t error_window = 50;
+	static constexpr size_t error_threshold = 45;
+
+	uint32_t reg { 0 };
+	uint32_t bit_counter { 0 };
+
+	bool synchronized_ { false };
+	size_t block_bit_count { 0 };
+	size_t expected_block { 0 };
+	uint64_t error_history { 0 };
+
+	bool candidate_valid { false };
+	size_t candidate_block { 0 };
+	uint32_t candidate_bit { 0 };
+
+	ReceivedGroup group_ { };
+
+	uint32_t blocks_received_ { 0 };
+	uint32_t blocks_corrected_ { 0 };
+	uint32_t blocks_invalid_ { 0 };
+
+	void acquire();
+	bool process_block();
+	BlockStatus check_block(uint32_t& word, const uint32_t offset) const;
+};
+
+} /* namespace rds */
+
+#endif/*__RDS_SYNC_H__*/
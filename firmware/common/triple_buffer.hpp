@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2014 Jared Boone, ShareBrained Technology, Inc.
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __TRIPLE_BUFFER_H__
+#define __TRIPLE_BUFFER_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+/* Latest-wins exchange between one writer and one reader on different
+ * cores, without copying: the writer fills a slot in place and publishes
+ * it, the reader uses the published slot in place until it asks for the
+ * next one.
+ *
+ * The M0 has no exclusive load/store, so instead of swapping indices the
+ * reader claims the published slot and then checks it is still published.
+ * The writer never picks the published or the claimed slot to fill, and the
+ * barriers on both sides ensure that if the reader's check passed, the
+ * writer saw the claim before choosing its next slot.
+ *
+ * Every publish is numbered, so the reader knows how many it skipped.
+ */
+template<typename T>
+class TripleBuffer {
+public:
+	static constexpr size_t slot_count = 3;
+
+	/* Writer side */
+
+	/* Withdraws the published slot, e.g. after retuning. Safe while the
+	 * reader holds a slot, it keeps it until it reads again.
+	 */
+	void reset() {
+		published = none;
+		__sync_synchronize();
+		write_index = (claimed == 0) ? 1 : 0;
+	}
+
+	T& slot() {
+		return slots[write_index];
+	}
+
+	void publish() {
+		sequence[write_index] = ++sequence_;
+		// The slot and its sequence must land before the reader can see them published.
+		__sync_synchronize();
+		published = write_index;
+		__sync_synchronize();
+
+		const size_t claimed_now = claimed;
+		for(size_t i=0; i<slot_count; i++) {
+			if( (i != published) && (i != claimed_now) ) {
+				write_index = i;
+				break;
+			}
+		}
+	}
+
+	// Publishes per second the reader can use, 0 for as many as possible.
+	uint32_t requested_rate() const {
+		return requested_rate_;
+	}
+
+	/* Reader side */
+
+	/* Returns the newest published slot if it hasn't been returned yet,
+	 * otherwise nullptr. The slot stays valid until the next call.
+	 */
+	const T* read() {
+		size_t index;
+		do {
+			index = published;
+			if( index >= slot_count ) {
+				return nullptr;
+			}
+			claimed = index;
+			__sync_synchronize();
+		} while( published != index );
+
+		const auto sequence_now = sequence[index];
+		if( sequence_now == last_read ) {
+			return nullptr;
+		}
+
+		if( last_read != 0 ) {
+			skipped_ += sequence_now - last_read - 1;
+		}
+		last_read = sequence_now;
+
+		return &slots[index];
+	}
+
+	// Published slots the reader never saw.
+	uint32_t skipped() const {
+		return skipped_;
+	}
+
+	void set_requested_rate(const uint32_t rate) {
+		requested_rate_ = rate;
+	}
+
+private:
+	static constexpr size_t none = slot_count;
+
+	std::array<T, slot_count> slots { };
+	std::array<uint32_t, slot_count> sequence { };
+
+	// Written by the writer only.
+	volatile size_t published { none };
+	size_t write_index { 0 };
+	uint32_t sequence_ { 0 };
+
+	// Written by the reader only.
+	volatile size_t claimed { none };
+	uint32_t last_read { 0 };
+	uint32_t skipped_ { 0 };
+	volatile uint32_t requested_rate_ { 0 };
+};
+
+#endif/*__TRIPLE_BUFFER_H__*/
@@ -35,6 +35,10 @@ Glyph Font::glyph(const char c) const {
 	}
 }
 
+Dim Font::char_width() const {
+	return w;
+}
+
 Dim Font::line_height() const {
 	return h;
 }
@@ -87,6 +87,7 @@ public:
 
 	Glyph glyph(const char c) const;
 
+	Dim char_width() const;
 	Dim line_height() const;
 	Size size_of(const std::string s) const;
 
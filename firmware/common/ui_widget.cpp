@@ -1685,12 +1685,19 @@ Waveform::Waveform(
 	color_ { color }
 {
 	//set_focusable(false);
-	//previous_data.resize(length_, 0);
+	invalidate_columns();
+}
+
+void Waveform::invalidate_columns() {
+	columns_drawn.fill(column_invalid);
 }
 
 void Waveform::set_cursor(const uint32_t i, const int16_t position) {
 	if (i < 2) {
 		if (position != cursors[i]) {
+			// Redraw the columns the cursor leaves and lands on
+			if ((size_t)cursors[i] < max_columns)
+				columns_drawn[cursors[i]] = column_invalid;
 			cursors[i] = position;
 			set_dirty();
 		}
@@ -1712,63 +1719,102 @@ void Waveform::set_length(const uint32_t new_length) {
 	}
 }
 
-void Waveform::paint(Painter& painter) {
-	size_t n;
-	Coord y, y_offset = screen_rect().location().y();
-	Coord prev_x = screen_rect().location().x(), prev_y;
-	float x, x_inc;
-	Dim h = screen_rect().size().height();
-	const float y_scale = (float)(h - 1) / 65536.0;
-	int16_t * data_start = data_ + offset_;
+void Waveform::on_show() {
+	invalidate_columns();
+}
+
+/* The trace is reduced to one vertical span per column (min/max of the samples
+ * falling on it, plus the first sample of the next column so it stays
+ * connected), and only columns whose span changed since the last paint are
+ * sent, each as a 1 pixel wide box covering the old and new spans. Scrolling
+ * or streaming data only costs the columns that actually move, and nothing
+ * is cleared first so there's no flicker.
+ */
+void Waveform::paint(Painter&) {
+	static std::array<Color, 254> column;
+	
+	const auto r = screen_rect();
+	const Dim w = std::min<Dim>(r.width(), max_columns);
+	const Dim h = std::min<Dim>(r.height(), column.size());
+	const int16_t * const data_start = data_ + offset_;
 	
 	if (!length_) return;
 	
-	x_inc = (float)screen_rect().size().width() / length_;
+	// Parent just repainted over us
+	if (parent() && parent()->dirty())
+		invalidate_columns();
+	
+	const auto y_of = [this, h](const int32_t v) {
+		int32_t y;
+		if (digital_)
+			y = v ? h - 1 : 0;
+		else
+			y = (h / 2) - ((v * (h - 1)) >> 16);
+		return std::max<int32_t>(0, std::min<int32_t>(h - 1, y));
+	};
 	
-	// Clear
-	painter.fill_rectangle_unrolled8(screen_rect(), Color::black());
+	// Value at sample position i + f / w
+	const auto value_at = [this, data_start, w](const uint32_t i, const uint32_t f) {
+		if (i + 1 >= length_)
+			return (int32_t)data_start[length_ - 1];
+		const int32_t v0 = data_start[i];
+		if (digital_ || !f)
+			return v0;
+		return v0 + (((int32_t)data_start[i + 1] - v0) * (int32_t)f) / w;
+	};
 	
-	if (digital_) {
-		// Digital waveform: each value is an horizontal line
-		x = 0;
-		h--;
-		for (n = 0; n < length_; n++) {
-			y = *(data_start++) ? h : 0;
+	for (Dim x = 0; x < w; x++) {
+		uint16_t code;
+		Color cursor_color;
+		
+		if (show_cursors && (cursors[1] == x)) {
+			code = column_cursor | 1;
+			cursor_color = cursor_colors[1];
+		} else if (show_cursors && (cursors[0] == x)) {
+			code = column_cursor | 0;
+			cursor_color = cursor_colors[0];
+		} else {
+			// Column covers sample positions p0 to p1, in units of 1/w sample
+			const uint64_t p0 = (uint64_t)x * length_;
+			const uint64_t p1 = p0 + length_;
+			const uint32_t i0 = p0 / w;
+			const uint32_t i1 = p1 / w;
 			
-			if (n) {
-				if (y != prev_y)
-					painter.draw_vline( {(Coord)x, y_offset}, h, color_);
-			}
+			int32_t y_min = y_of(value_at(i0, p0 % w));
+			int32_t y_max = y_min;
+			const auto extend = [&y_min, &y_max](const int32_t y) {
+				y_min = std::min(y_min, y);
+				y_max = std::max(y_max, y);
+			};
 			
-			painter.draw_hline( {(Coord)x, y_offset + y}, ceil(x_inc), color_);
+			extend(y_of(value_at(i1, p1 % w)));
+			for (uint32_t i = i0 + 1; (i <= i1) && (i < length_); i++)
+				extend(y_of(data_start[i]));
 			
-			prev_y = y;
-			x += x_inc;
+			code = (y_min << 8) | y_max;
 		}
-	} else {
-		// Analog waveform: each value is a point's Y coordinate
-		x = prev_x + x_inc;
-		h /= 2;
-		prev_y = y_offset + h - (*(data_start++) * y_scale);
-		for (n = 1; n < length_; n++) {
-			y = y_offset + h - (*(data_start++) * y_scale);
-			display.draw_line( {prev_x, prev_y}, {(Coord)x, y}, color_);
-			
-			prev_x = x;
-			prev_y = y;
-			x += x_inc;
+		
+		const auto drawn = columns_drawn[x];
+		if (code == drawn)
+			continue;
+		
+		// Rows to send: union of what's there now and the new span
+		Dim top = 0;
+		Dim bottom = h - 1;
+		if (((code & column_cursor) != column_cursor) && ((drawn & column_cursor) != column_cursor)) {
+			top = std::min(code >> 8, drawn >> 8);
+			bottom = std::max(code & 0xff, drawn & 0xff);
 		}
-	}
-	
-	// Cursors
-	if (show_cursors) {
-		for (n = 0; n < 2; n++) {
-			painter.draw_vline(
-				Point(std::min(screen_rect().size().width(), (int)cursors[n]), y_offset),
-				screen_rect().size().height(),
-				cursor_colors[n]
-				);
+		
+		for (Dim y = top; y <= bottom; y++) {
+			if ((code & column_cursor) == column_cursor)
+				column[y - top] = cursor_color;
+			else
+				column[y - top] = ((y >= (code >> 8)) && (y <= (code & 0xff))) ? color_ : Color::black();
 		}
+		
+		display.render_box({ r.left() + x, r.top() + top }, { 1, bottom - top + 1 }, column.data());
+		columns_drawn[x] = code;
 	}
 }
 
@@ -34,6 +34,7 @@
 #include "portapack.hpp"
 #include "utility.hpp"
 
+#include <array>
 #include <memory>
 #include <vector>
 #include <string>
@@ -666,11 +667,22 @@ public:
 	void set_length(const uint32_t new_length);
 	void set_cursor(const uint32_t i, const int16_t position);
 
+	void on_show() override;
 	void paint(Painter& painter) override;
 
 private:
 	const Color cursor_colors[2] = { Color::cyan(), Color::magenta() };
 	
+	/* What each column currently shows on screen: trace span as top << 8 | bottom
+	 * (so heights up to 254 pixels), a cursor, or unknown.
+	 */
+	static constexpr size_t max_columns = 240;
+	static constexpr uint16_t column_cursor = 0xfe00;
+	static constexpr uint16_t column_invalid = 0xffff;
+	std::array<uint16_t, max_columns> columns_drawn { };
+	
+	void invalidate_columns();
+	
 	int16_t * data_;
 	uint32_t length_;
 	uint32_t offset_;